@@ -2,6 +2,8 @@
 
 // HardwareSerialを使用してDebugLoggerのインスタンスを作成
 // ArduinoIDEの場合、<>内を書かないとエラーが発生する
+// <>内の2番目にログレベルを指定すると、それより低いレベルのログはコンパイルされない
+// 例: DebugLogger<HardwareSerial, DebugLoggerLevel::WARN> logger(Serial);
 DebugLogger<HardwareSerial> logger(Serial);
 
 void setup() {
@@ -16,8 +18,9 @@ void loop() {
   // コンポーネント: "Main"
   // 関数: "loop"
   // メッセージ: "Hello, world!"
-  logger.println(DebugLoggerLevel::INFO, DebugLoggerMode::NO_WAIT, "Main",
-                 "loop", "Hello, world!");
+  // F()で囲んだ文字列はフラッシュメモリに配置され、SRAMを消費しない
+  logger.println(DebugLoggerLevel::INFO, DebugLoggerMode::NO_WAIT, F("Main"),
+                 F("loop"), F("Hello, world!"));
   // 1秒間の遅延
   delay(1000);
 }
\ No newline at end of file
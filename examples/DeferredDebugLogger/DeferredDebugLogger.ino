@@ -0,0 +1,31 @@
+#include <liboshima.h> // 必要なライブラリをインクルード
+
+// HardwareSerialを使用してDeferredDebugLoggerのインスタンスを作成
+// ログはバイナリ形式でバッファに記録され、drain()を呼び出した時に出力される
+// 出力されたバイナリは、PC上で次のように文字列に戻す
+//   python3 scripts/decode_log.py messages.txt log.bin
+// messages.txtには、メッセージ番号とフォーマット文字列を記述する
+//   1 count=%u
+//   2 elapsed=%lu
+DeferredDebugLogger<HardwareSerial> logger(Serial);
+
+unsigned int count = 0;
+
+void setup() {
+  // ロガーの初期化
+  logger.begin();
+}
+
+void loop() {
+  unsigned long start = micros();
+
+  // 時間に厳しい処理の中でも、ログの記録はすぐに終わる
+  // メッセージ番号1: "count=%u"
+  logger.log(DebugLoggerLevel::INFO, 1, count++);
+  // メッセージ番号2: "elapsed=%lu"
+  logger.log(DebugLoggerLevel::INFO, 2, micros() - start);
+
+  // 空き時間にログを出力
+  logger.drain();
+  delay(100);
+}
@@ -0,0 +1,38 @@
+#include <SoftwareSerial.h> // 必要なライブラリをインクルード
+#include <liboshima.h>      // 必要なライブラリをインクルード
+
+// IM920SLを接続するピンの定義
+#define RX_PIN 2
+#define TX_PIN 3
+
+// IM920SLと通信するSoftwareSerialのインスタンスを作成
+SoftwareSerial imSerial(RX_PIN, TX_PIN);
+
+// HardwareSerialにログを出力するDebugLoggerのインスタンスを作成
+// ログレベルを指定しない場合は、INFO以上のすべてのログがコンパイルされる
+// （ログの文字列はF()でフラッシュメモリに配置されるため、SRAMを消費しない）
+DebugLogger<HardwareSerial> logger(Serial);
+
+// ロガーを指定してIM920SLのインスタンスを作成
+// ArduinoIDEの場合、<>内を書かないとエラーが発生する
+IM920SL<SoftwareSerial, DebugLogger<HardwareSerial>> im(imSerial, &logger);
+
+// フラッシュメモリとSRAMの使用量は、ビルド時に表示される
+// ログを取り除いた場合の使用量は、IM920SL_logger_releaseと比べる
+
+void setup() {
+  // ロガーとシリアル通信の開始
+  logger.begin();
+  im.beginSerial();
+}
+
+void loop() {
+  // 受信するデータを格納する変数
+  int data;
+
+  // データを受信する（受信の経過がログに出力される）
+  im.receive(&data, ImReceiveMode::WAIT_FOR_SERIAL_DATA);
+
+  // 受信したデータをそのまま送り返す
+  im.send(data, ImSendMode::USE_CARRIER_SENSE);
+}
@@ -0,0 +1,29 @@
+#include <liboshima.h> // 必要なライブラリをインクルード
+
+// HardwareSerialを使用してIM920SLのインスタンスを作成
+// ArduinoIDEの場合、<>内を書かないとエラーが発生する
+IM920SL<HardwareSerial> im(Serial);
+
+// 受信状態を表示するLED
+Led led(13);
+
+void setup() {
+  // シリアル通信の開始
+  im.beginSerial();
+}
+
+void loop() {
+  // 受信するデータを格納する変数（フレームの途中の状態を保持するためstatic）
+  static int data;
+
+  // バッファにあるデータだけを読み込み、すぐに戻る
+  ImPollResult result = im.poll(&data);
+  if (result == ImPollResult::FRAME_READY) {
+    // フレームの受信が完了した場合、dataを使用する
+    if (data == 0x1234) {
+      led.toggle();
+    }
+  }
+
+  // 受信を待たずに、モーターの制御などの処理を続けることができる
+}
@@ -0,0 +1,32 @@
+#include <liboshima.h> // LED制御ライブラリをインクルード
+
+// 複数のLEDの点滅パターンをまとめて管理する
+LedPatterns leds;
+
+// 各LEDの番号
+uint8_t statusLed;
+uint8_t errorLed;
+
+// ボタンのピン番号を2に設定
+Button button(2);
+
+void setup() {
+  // ピン13のLEDは約1秒ごとに短く2回点灯
+  statusLed = leds.add(13, LedPatterns::HEARTBEAT);
+  // ピン12のLEDは最初は消灯
+  errorLed = leds.add(12, LedPatterns::OFF);
+}
+
+void loop() {
+  // ボタンが押されている間は、ピン12のLEDを速く点滅させる
+  // 1ステップは2の5乗 = 32ミリ秒
+  if (button.isPressed()) {
+    leds.setPattern(errorLed, LedPatterns::FAST_BLINK, 5);
+  } else {
+    leds.setPattern(errorLed, LedPatterns::OFF);
+  }
+
+  // 全てのLEDを現在の時刻のパターンで出力する
+  // delay()を使用しないため、すぐに戻る
+  leds.tick(millis());
+}
@@ -3,13 +3,15 @@
 #define NUM_LEDS 30 // LEDの数を定義
 #define DATA_PIN 6 // データピンを定義
 
-// LedTapeクラスのインスタンスを作成
-// NUM_LEDS: LEDの数
+// StaticLedTapeクラスのインスタンスを作成
 // DATA_PIN: データピン
-LedTape ledTape(NUM_LEDS, DATA_PIN);
+// NUM_LEDS: LEDの数
+// データピンをコンパイル時に指定するため、LedTapeクラスよりもフラッシュメモリを節約できる
+// データピンを実行時に決める場合は、LedTape ledTape(NUM_LEDS, DATA_PIN); とする
+StaticLedTape<DATA_PIN, NUM_LEDS> ledTape;
 
 void setup() {
-  // 初期化処理はLedTapeクラスのコンストラクタで行われるため、
+  // 初期化処理はStaticLedTapeクラスのコンストラクタで行われるため、
   // setup関数内では特に何もしない
 }
 
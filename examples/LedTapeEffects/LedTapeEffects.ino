@@ -0,0 +1,42 @@
+#include <liboshima.h> // LEDテープ制御ライブラリをインクルード
+
+#define NUM_LEDS 30 // LEDの数を定義
+#define DATA_PIN 6 // データピンを定義
+
+// LedTapeクラスのインスタンスを作成
+LedTape ledTape(NUM_LEDS, DATA_PIN);
+
+// エフェクトのインスタンスを作成
+// パターンの更新間隔は20ミリ秒
+RainbowEffect rainbow(20);
+// 赤色のチェイスパターン、更新間隔は100ミリ秒
+ChaseEffect chase(LedTape::Red, 100);
+
+// エフェクトを切り替えた時刻
+unsigned long switchedAt = 0;
+// 現在のエフェクトがレインボーかどうか
+bool isRainbow = true;
+
+void setup() {
+  // レインボーパターンを開始
+  ledTape.play(rainbow);
+}
+
+void loop() {
+  // 5秒ごとにエフェクトを切り替える
+  if (millis() - switchedAt >= 5000) {
+    switchedAt = millis();
+    isRainbow = !isRainbow;
+    if (isRainbow) {
+      ledTape.play(rainbow);
+    } else {
+      ledTape.play(chase);
+    }
+  }
+
+  // 次のフレームの時刻になっていれば1フレームだけ描画する
+  // delay()を使用しないため、すぐに戻る
+  ledTape.update();
+
+  // ここでモーターの制御や無線通信などを行うことができる
+}
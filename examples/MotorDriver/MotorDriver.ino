@@ -13,7 +13,7 @@
 // BD62193: モーター1用のドライバ
 // TB67H450: モーター2用のドライバ
 // NonSpeedAdjustable: モーター3用のドライバ（速度調整不可）
-BD62193 motor1(MOTOR1_PWM, MOTOR1_INA, MOTOR1_INB);
+BD62193 motor1(MOTOR1_INA, MOTOR1_INB, MOTOR1_PWM);
 TB67H450 motor2(MOTOR2_IN1, MOTOR2_IN2);
 NonSpeedAdjustable motor3(MOTOR3_IN1, MOTOR3_IN2);
 
@@ -38,6 +38,10 @@ void loop() {
   motor1.setSpeed(-1.0);
   delay(1000); // 1秒間待機
 
+  // モーター1をPWM値で指定した速度で逆転（浮動小数点数の計算を行わない）
+  motor1.setPwm(-128);
+  delay(1000); // 1秒間待機
+
   // モーター2を最大速度で正転
   motor2.setSpeed(1.0);
   delay(1000); // 1秒間待機
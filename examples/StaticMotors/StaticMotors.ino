@@ -0,0 +1,27 @@
+#include <liboshima.h> // モータードライバ制御ライブラリをインクルード
+
+// ピン番号をテンプレート引数で指定したモータードライバ
+// ピン番号が定数になるため、方向の出力は1命令のポート操作になり、
+// 仮想関数を持たないためメソッドの呼び出しもインライン展開される
+// （同じモーターを仮想関数で制御する例は VirtualMotors）
+StaticBD62193<2, 4, 3> frontLeft;    // 入力A、入力B、PWM
+StaticBD62193<7, 8, 5> frontRight;   // 入力A、入力B、PWM
+StaticBD62193<12, 13, 6> rearLeft;   // 入力A、入力B、PWM
+StaticBD62193<14, 15, 9> rearRight;  // 入力A、入力B、PWM
+
+// スティックが2本のコントローラーデータ
+// （スティックは中央の128で初期化されるため、受信するまでモーターは停止している）
+ControllerData<0, 0, 2> controllerData;
+
+void setup() {
+  // 初期化処理はコンストラクタで行われるため、setup関数内では何もしない
+}
+
+void loop() {
+  // 左のスティックで左側のモーター、右のスティックで右側のモーターを制御
+  // （実際にはIM920SLなどで受信したデータを使用する）
+  driveByStick(frontLeft, controllerData.sticks[0].y);
+  driveByStick(rearLeft, controllerData.sticks[0].y);
+  driveByStick(frontRight, controllerData.sticks[1].y);
+  driveByStick(rearRight, controllerData.sticks[1].y);
+}
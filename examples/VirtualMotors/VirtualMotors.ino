@@ -0,0 +1,32 @@
+#include <liboshima.h> // モータードライバ制御ライブラリをインクルード
+
+// StaticMotors と同じ4つのモーターを、ピン番号を実行時に保持する
+// モータードライバで制御する（StaticMotors とメモリの使用量を比べるための例）
+// ピン番号をメンバ変数に持ち、メソッドは仮想関数として呼び出される
+BD62193 frontLeft(2, 4, 3);    // 入力A、入力B、PWM
+BD62193 frontRight(7, 8, 5);   // 入力A、入力B、PWM
+BD62193 rearLeft(12, 13, 6);   // 入力A、入力B、PWM
+BD62193 rearRight(14, 15, 9);  // 入力A、入力B、PWM
+
+// ISpeedAdjustable の配列にまとめると、種類の異なるモーターも同じように扱える
+ISpeedAdjustable *leftMotors[] = {&frontLeft, &rearLeft};
+ISpeedAdjustable *rightMotors[] = {&frontRight, &rearRight};
+
+// スティックが2本のコントローラーデータ
+// （スティックは中央の128で初期化されるため、受信するまでモーターは停止している）
+ControllerData<0, 0, 2> controllerData;
+
+void setup() {
+  // 初期化処理はコンストラクタで行われるため、setup関数内では何もしない
+}
+
+void loop() {
+  // 左のスティックで左側のモーター、右のスティックで右側のモーターを制御
+  // （実際にはIM920SLなどで受信したデータを使用する）
+  for (ISpeedAdjustable *motor : leftMotors) {
+    driveByStick(*motor, controllerData.sticks[0].y);
+  }
+  for (ISpeedAdjustable *motor : rightMotors) {
+    driveByStick(*motor, controllerData.sticks[1].y);
+  }
+}
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""DeferredDebugLoggerが出力したバイナリログを文字列に戻すツール
+
+使い方:
+    python3 scripts/decode_log.py messages.txt log.bin
+    cat /dev/ttyUSB0 | python3 scripts/decode_log.py messages.txt
+
+メッセージ定義ファイルには、1行に1つずつ「メッセージ番号 フォーマット文字列」を記述する。
+'#' で始まる行と空行は無視する。
+
+    # messages.txt
+    1 speed=%d
+    2 target=%lu, mode=%c
+
+引数のバイト数は変換指定子から決める（AVRのintは2バイト）。
+    %hhd %hhu %hhx %c : 1バイト
+    %d %i %u %x %X    : 2バイト（--int-size で変更可能）
+    %hd %hu %hx       : 2バイト
+    %ld %lu %lx       : 4バイト
+    %lld %llu %llx    : 8バイト
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER_SIZE = 5
+LEVELS = ["INFO", "WARN", "ERROR", "?"]
+
+# printf形式の変換指定子
+CONVERSION = re.compile(r"%([-+ 0#]*\d*(?:\.\d+)?)(hh|h|ll|l)?([diuxXc%])")
+
+
+def load_messages(path):
+    """メッセージ定義ファイルを読み込む"""
+    messages = {}
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.rstrip("\r\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            number, _, fmt = line.strip().partition(" ")
+            messages[int(number, 0)] = fmt
+    return messages
+
+
+def decode_args(fmt, data, int_size):
+    """フォーマット文字列に従って引数のバイト列を値に変換し、文字列を整形する"""
+    pieces = []
+    position = 0
+    offset = 0
+    for match in CONVERSION.finditer(fmt):
+        flags, length, conversion = match.groups()
+        pieces.append(fmt[position:match.start()])
+        position = match.end()
+        if conversion == "%":
+            pieces.append("%")
+            continue
+
+        if conversion == "c" or length == "hh":
+            size = 1
+        elif length == "h":
+            size = 2
+        elif length == "l":
+            size = 4
+        elif length == "ll":
+            size = 8
+        else:
+            size = int_size
+        signed = conversion in "di"
+        raw = data[offset:offset + size]
+        offset += size
+        if len(raw) < size:
+            pieces.append("<missing>")
+            continue
+
+        value = int.from_bytes(raw, "little", signed=signed)
+        if conversion == "c":
+            pieces.append(chr(value))
+        else:
+            pieces.append(("%" + flags + conversion) % value)
+    pieces.append(fmt[position:])
+    return "".join(pieces)
+
+
+def decode(stream, messages, int_size):
+    """バイナリログを1件ずつ文字列に変換する"""
+    buffer = bytearray()
+    last_timestamp = None
+    elapsed = 0
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            break
+        buffer += chunk
+
+        # 同期バイトまで読み捨てる
+        while buffer and buffer[0] != SYNC:
+            del buffer[0]
+        if len(buffer) < HEADER_SIZE:
+            continue
+
+        message_id = buffer[1]
+        level = buffer[2] >> 6
+        arg_bytes = buffer[2] & 0x3F
+        if len(buffer) < HEADER_SIZE + arg_bytes:
+            continue
+        (timestamp,) = struct.unpack_from("<H", buffer, 3)
+        args = bytes(buffer[HEADER_SIZE:HEADER_SIZE + arg_bytes])
+        del buffer[:HEADER_SIZE + arg_bytes]
+
+        # 16ビットのタイムスタンプの桁あふれを補正する
+        if last_timestamp is not None:
+            elapsed += (timestamp - last_timestamp) & 0xFFFF
+        else:
+            elapsed = timestamp
+        last_timestamp = timestamp
+
+        fmt = messages.get(message_id)
+        if fmt is None:
+            text = "<unknown message %d> %s" % (message_id, args.hex())
+        else:
+            text = decode_args(fmt, args, int_size)
+        yield "[%10.3f] %-5s %s" % (elapsed / 1000.0, LEVELS[level], text)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="DeferredDebugLoggerのバイナリログを文字列に戻す")
+    parser.add_argument("messages", help="メッセージ定義ファイル")
+    parser.add_argument("log", nargs="?", help="バイナリログ（省略時は標準入力）")
+    parser.add_argument("--int-size", type=int, default=2,
+                        help="intのバイト数（AVRは2、ARMやESP32は4）")
+    args = parser.parse_args()
+
+    messages = load_messages(args.messages)
+    if args.log:
+        stream = open(args.log, "rb")
+    else:
+        stream = sys.stdin.buffer
+    try:
+        for line in decode(stream, messages, args.int_size):
+            print(line, flush=True)
+    finally:
+        if args.log:
+            stream.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""LEDテープの光り方をLedTapePlayer用のデータに変換するツール
+
+使い方:
+    python3 scripts/encode_led_rle.py show.json -o show.h --name show
+
+入力はJSONファイルで、LEDの数と、フレームの並びを記述する。
+各フレームには表示時間（ミリ秒）と、全てのLEDの色（"RRGGBB" 又は [R, G, B]）を記述する。
+
+    {
+      "leds": 3,
+      "frames": [
+        {"duration": 500, "pixels": ["FF0000", "FF0000", "000000"]},
+        {"duration": 500, "pixels": ["000000", "FF0000", "FF0000"]}
+      ]
+    }
+
+出力は `const uint8_t 名前[] PROGMEM = {...};` を含むヘッダーファイル。
+データの形式は src/parts/ledtapes/LedTapePlayer.h を参照。
+"""
+
+import argparse
+import json
+import sys
+
+MAX_COUNT = 128
+
+
+def parse_color(value):
+    """"RRGGBB" 又は [R, G, B] を (R, G, B) に変換する"""
+    if isinstance(value, str):
+        value = value.lstrip("#")
+        return (int(value[0:2], 16), int(value[2:4], 16), int(value[4:6], 16))
+    return tuple(int(c) for c in value)
+
+
+def encode_frame(pixels, previous):
+    """1フレームを命令の並びに変換する（previousがNoneの場合は全て塗る）"""
+    out = bytearray()
+    position = 0
+    while position < len(pixels):
+        if previous is not None and pixels[position] == previous[position]:
+            # 前のフレームと同じLEDが続く数
+            count = 1
+            while (position + count < len(pixels) and count < MAX_COUNT
+                   and pixels[position + count] == previous[position + count]):
+                count += 1
+            out.append(count - 1)
+        else:
+            # 同じ色が続く数
+            color = pixels[position]
+            count = 1
+            while (position + count < len(pixels) and count < MAX_COUNT
+                   and pixels[position + count] == color):
+                count += 1
+            out.append(0x80 | (count - 1))
+            out.extend(color)
+        position += count
+    return out
+
+
+def encode(leds, frames):
+    """フレームの並びをLedTapePlayer用のデータに変換する"""
+    out = bytearray()
+    out += leds.to_bytes(2, "little")
+    out += len(frames).to_bytes(2, "little")
+    previous = None
+    for duration, pixels in frames:
+        if len(pixels) != leds:
+            raise ValueError("フレームのLEDの数が %d ではありません" % leds)
+        out += duration.to_bytes(2, "little")
+        out += encode_frame(pixels, previous)
+        previous = pixels
+    return bytes(out)
+
+
+def decode(data):
+    """LedTapePlayer用のデータをフレームの並びに戻す（確認用）"""
+    leds = int.from_bytes(data[0:2], "little")
+    count = int.from_bytes(data[2:4], "little")
+    offset = 4
+    pixels = [(0, 0, 0)] * leds
+    frames = []
+    for _ in range(count):
+        duration = int.from_bytes(data[offset:offset + 2], "little")
+        offset += 2
+        pixels = list(pixels)
+        position = 0
+        while position < leds:
+            command = data[offset]
+            offset += 1
+            run = (command & 0x7F) + 1
+            if command & 0x80:
+                color = tuple(data[offset:offset + 3])
+                offset += 3
+                pixels[position:position + run] = [color] * run
+            position += run
+        frames.append((duration, pixels))
+    return leds, frames
+
+
+def to_header(name, data):
+    """データをC++のヘッダーファイルの文字列に変換する"""
+    lines = ["#pragma once", "", "#include <Arduino.h>", "",
+             "// scripts/encode_led_rle.py で作成したデータ（%d バイト）" % len(data),
+             "const uint8_t %s[] PROGMEM = {" % name]
+    for i in range(0, len(data), 12):
+        chunk = ", ".join("0x%02X" % b for b in data[i:i + 12])
+        lines.append("    %s," % chunk)
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="LEDテープの光り方をLedTapePlayer用のデータに変換する")
+    parser.add_argument("input", help="入力するJSONファイル")
+    parser.add_argument("-o", "--output", help="出力するヘッダーファイル（省略時は標準出力）")
+    parser.add_argument("--name", default="show", help="配列の名前（デフォルトは show）")
+    args = parser.parse_args()
+
+    with open(args.input, encoding="utf-8") as f:
+        show = json.load(f)
+    leds = show["leds"]
+    frames = [(frame["duration"], [parse_color(p) for p in frame["pixels"]])
+              for frame in show["frames"]]
+
+    data = encode(leds, frames)
+    # 変換したデータを元に戻せることを確認する
+    if decode(data) != (leds, frames):
+        sys.exit("変換に失敗しました")
+
+    header = to_header(args.name, data)
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(header)
+    else:
+        sys.stdout.write(header)
+    raw = leds * 3 * len(frames)
+    print("%d フレーム: %d バイト（圧縮前 %d バイト）" % (len(frames), len(data), raw),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
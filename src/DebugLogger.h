@@ -1,9 +1,12 @@
 #pragma once
 
+#include <fasts/Formatter.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
+
+// Arduinoのフラッシュメモリ上の文字列（F()マクロ）を表す型
+class __FlashStringHelper;
 
 /// ログレベルを定義する列挙型
 /**
@@ -41,11 +44,37 @@ enum class DebugLoggerMode : uint8_t {
  * `Serial`）を使用して、
  * クラス名、メソッド名、およびメッセージをシリアルポートに送信します。
  *
+ * 出力する最小のログレベルはテンプレート引数でも指定できます。
+ * 指定したレベルより低いレベルのログは、コンパイル時に取り除かれるため、
+ * 処理時間もメモリも消費しません。
+ *
+ * 使用例:
+ * @code
+ * // WARN以上のログだけを出力する（INFOのログはコンパイルされない）
+ * DebugLogger<HardwareSerial, DebugLoggerLevel::WARN> logger(Serial);
+ * @endcode
+ *
  * @tparam SerialType
  * シリアルポートクラスの型を指定します。例：`HardwareSerial`（Arduinoの場合）
+ * @tparam minLevel
+ * コンパイル時に指定する最小のログレベル（デフォルトはINFO）
  */
-template <typename SerialType> class DebugLogger {
+template <typename SerialType,
+          DebugLoggerLevel minLevel = DebugLoggerLevel::INFO>
+class DebugLogger {
 public:
+  /**
+   * @brief 指定したレベルのログがコンパイル時に取り除かれるかどうか
+   *
+   * `if constexpr` と組み合わせることで、ログの呼び出し自体を取り除くことができます。
+   *
+   * @param level ログレベル
+   * @return `minLevel` より低いレベルの場合は true
+   */
+  static constexpr bool isCompiledOut(DebugLoggerLevel level) {
+    return level < minLevel;
+  }
+
   /**
    * @brief コンストラクタ
    *
@@ -83,26 +112,55 @@ public:
   void println(DebugLoggerLevel level, DebugLoggerMode wait,
                const char *className, const char *methodName,
                const char *message) {
-    // 現在のログレベルが指定されたレベルよりも高い場合、メッセージを出力しない
-    if (logLevel > level) {
+    if (!prepare(level, wait)) {
       return;
     }
 
-    // データが利用可能になるまで待機するか、即座に終了するかを決定
-    if (wait == DebugLoggerMode::WAIT) {
-      while (!serial.availableForWrite())
-        ; // データが利用可能になるまで待機
-    } else if (wait == DebugLoggerMode::NO_WAIT &&
-               !serial.availableForWrite()) {
-      return; // データが利用できない場合は即座に終了
+    // メッセージをシリアルポートに出力
+    serial.write('<');
+    serial.print(className);
+    serial.write(':');
+    serial.write(':');
+    serial.print(methodName);
+    serial.write('>');
+    serial.write(' ');
+    serial.println(message); // メッセージを出力
+  }
+
+  /**
+   * @brief フラッシュメモリ上の文字列を出力するメソッド
+   *
+   * `F()` マクロで指定した文字列を出力します。
+   * 文字列がSRAMに配置されないため、メモリを節約できます。
+   *
+   * 使用例:
+   * @code
+   * logger.println(DebugLoggerLevel::INFO, DebugLoggerMode::WAIT, F("Main"),
+   *                F("loop"), F("Hello, world!"));
+   * @endcode
+   *
+   * @param level ログレベル
+   * @param wait データが利用可能になるまで待機するかどうか
+   * @param className クラス名を示す文字列（フラッシュメモリ上）
+   * @param methodName メソッド名を示す文字列（フラッシュメモリ上）
+   * @param message デバッグメッセージを示す文字列（フラッシュメモリ上）
+   */
+  void println(DebugLoggerLevel level, DebugLoggerMode wait,
+               const __FlashStringHelper *className,
+               const __FlashStringHelper *methodName,
+               const __FlashStringHelper *message) {
+    if (!prepare(level, wait)) {
+      return;
     }
 
     // メッセージをシリアルポートに出力
-    serial.print("<");
+    serial.write('<');
     serial.print(className);
-    serial.print("::");
+    serial.write(':');
+    serial.write(':');
     serial.print(methodName);
-    serial.print("> ");
+    serial.write('>');
+    serial.write(' ');
     serial.println(message); // メッセージを出力
   }
 
@@ -110,6 +168,7 @@ public:
    * @brief フォーマットされた文字列を出力するメソッド
    *
    * printf形式でメッセージをフォーマットし、クラス名、メソッド名と共にシリアルポートに出力します。
+   * 整形には `Formatter` を使用するため、整数と文字列だけに対応しています（浮動小数点数は不可）。
    *
    * @param className クラス名を示す文字列
    * @param methodName メソッド名を示す文字列
@@ -121,19 +180,178 @@ public:
   void printlnf(DebugLoggerLevel level, DebugLoggerMode wait,
                 const char *className, const char *methodName,
                 const char *format, ...) {
-    char buffer[100]; // 出力メッセージを格納するバッファサイズ
     va_list args;
     va_start(args, format); // 可変引数の初期化
-    // フォーマットされた文字列を作成
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    vprintlnf(level, wait, className, methodName, format, args);
     va_end(args); // 可変引数の解放
+  }
+
+  /**
+   * @brief フォーマットされた文字列を出力するメソッド（va_list版）
+   *
+   * 可変引数を受け取る関数から、引数をそのまま転送する場合に使用します。
+   * 出力されないレベルのログは、文字列を整形する前に破棄します。
+   *
+   * @param level ログレベル
+   * @param wait データが利用可能になるまで待機するかどうか
+   * @param className クラス名を示す文字列
+   * @param methodName メソッド名を示す文字列
+   * @param format 出力するメッセージのフォーマット文字列（printf形式）
+   * @param args フォーマットする可変引数
+   */
+  void vprintlnf(DebugLoggerLevel level, DebugLoggerMode wait,
+                 const char *className, const char *methodName,
+                 const char *format, va_list args) {
+    // 出力しないログのために文字列を整形しない
+    if (!isEnabled(level)) {
+      return;
+    }
+
+    char buffer[100]; // 出力メッセージを格納するバッファサイズ
+    // フォーマットされた文字列を作成
+    Formatter::vformat(buffer, sizeof(buffer), format, args);
     // フォーマットされたメッセージを出力
     println(level, wait, className, methodName, buffer);
   }
 
+  /**
+   * @brief フラッシュメモリ上のフォーマット文字列で出力するメソッド
+   *
+   * クラス名、メソッド名、フォーマット文字列を `F()` マクロで指定するため、
+   * これらの文字列はSRAMに配置されません。整形したメッセージだけがスタック上の
+   * バッファに格納されます。
+   *
+   * 使用例:
+   * @code
+   * logger.printlnf(DebugLoggerLevel::INFO, DebugLoggerMode::WAIT, F("Main"),
+   *                 F("loop"), F("count: %d"), count);
+   * @endcode
+   *
+   * @param level ログレベル
+   * @param wait データが利用可能になるまで待機するかどうか
+   * @param className クラス名を示す文字列（フラッシュメモリ上）
+   * @param methodName メソッド名を示す文字列（フラッシュメモリ上）
+   * @param format フォーマット文字列（フラッシュメモリ上）
+   * @param ... フォーマットする可変引数
+   */
+  void printlnf(DebugLoggerLevel level, DebugLoggerMode wait,
+                const __FlashStringHelper *className,
+                const __FlashStringHelper *methodName,
+                const __FlashStringHelper *format, ...) {
+    va_list args;
+    va_start(args, format); // 可変引数の初期化
+    vprintlnf(level, wait, className, methodName, format, args);
+    va_end(args); // 可変引数の解放
+  }
+
+  /**
+   * @brief フラッシュメモリ上のフォーマット文字列で出力するメソッド（va_list版）
+   *
+   * @param level ログレベル
+   * @param wait データが利用可能になるまで待機するかどうか
+   * @param className クラス名を示す文字列（フラッシュメモリ上）
+   * @param methodName メソッド名を示す文字列（フラッシュメモリ上）
+   * @param format フォーマット文字列（フラッシュメモリ上）
+   * @param args フォーマットする可変引数
+   */
+  void vprintlnf(DebugLoggerLevel level, DebugLoggerMode wait,
+                 const __FlashStringHelper *className,
+                 const __FlashStringHelper *methodName,
+                 const __FlashStringHelper *format, va_list args) {
+    // 出力しないログのために文字列を整形しない
+    if (!isEnabled(level)) {
+      return;
+    }
+
+    char buffer[100]; // 出力メッセージを格納するバッファサイズ
+    // フォーマットされた文字列を作成
+    Formatter::vformat(buffer, sizeof(buffer), format, args);
+    if (!prepare(level, wait)) {
+      return;
+    }
+
+    // メッセージをシリアルポートに出力
+    serial.write('<');
+    serial.print(className);
+    serial.write(':');
+    serial.write(':');
+    serial.print(methodName);
+    serial.write('>');
+    serial.write(' ');
+    serial.println(buffer); // フォーマットされたメッセージを出力
+  }
+
 private:
   /// デバッグメッセージを出力するシリアルポートへの参照
   SerialType &serial;
   /// 現在のログレベル
   DebugLoggerLevel logLevel;
+
+  /**
+   * @brief 指定したレベルのログを出力するかどうかを判定するメソッド
+   *
+   * @param level ログレベル
+   * @return ログを出力する場合は true
+   */
+  bool isEnabled(DebugLoggerLevel level) const {
+    // コンパイル時に指定されたレベルより低い場合、メッセージを出力しない
+    // （呼び出し元でlevelが定数の場合、この判定は最適化で取り除かれる）
+    if (isCompiledOut(level)) {
+      return false;
+    }
+
+    // 現在のログレベルが指定されたレベルよりも高い場合、メッセージを出力しない
+    return logLevel <= level;
+  }
+
+  /**
+   * @brief ログを出力できるかどうかを判定し、出力の準備をするメソッド
+   *
+   * ログレベルを確認し、指定された待機モードに従ってシリアルポートが書き込み可能になるまで待機します。
+   *
+   * @param level ログレベル
+   * @param wait データが利用可能になるまで待機するかどうか
+   * @return ログを出力する場合は true
+   */
+  bool prepare(DebugLoggerLevel level, DebugLoggerMode wait) {
+    if (!isEnabled(level)) {
+      return false;
+    }
+
+    // データが利用可能になるまで待機するか、即座に終了するかを決定
+    if (wait == DebugLoggerMode::WAIT) {
+      while (!serial.availableForWrite())
+        ; // データが利用可能になるまで待機
+    } else if (wait == DebugLoggerMode::NO_WAIT &&
+               !serial.availableForWrite()) {
+      return false; // データが利用できない場合は即座に終了
+    }
+    return true;
+  }
+};
+
+/**
+ * @brief ロガーが指定したシリアルポートの型に出力するかどうかをチェックするクラス
+ *
+ * `LoggerType` が `SerialType` に出力する `DebugLogger` の場合に `value` が
+ * `true` になります。最小のログレベルに関係なく判定します。
+ *
+ * @tparam LoggerType チェック対象のロガーの型
+ * @tparam SerialType シリアルポートクラスの型
+ */
+template <typename LoggerType, typename SerialType> struct IsDebugLoggerOf {
+  /// `LoggerType` が `SerialType` に出力する `DebugLogger` でないため `false`。
+  static const bool value = false;
+};
+
+/**
+ * @brief ロガーが指定したシリアルポートの型に出力する場合の部分特殊化
+ *
+ * @tparam SerialType シリアルポートクラスの型
+ * @tparam minLevel ロガーの最小のログレベル
+ */
+template <typename SerialType, DebugLoggerLevel minLevel>
+struct IsDebugLoggerOf<DebugLogger<SerialType, minLevel>, SerialType> {
+  /// `SerialType` に出力する `DebugLogger` であるため `true`。
+  static const bool value = true;
 };
\ No newline at end of file
@@ -0,0 +1,219 @@
+/**
+ * @file DeferredDebugLogger.h
+ * @brief ログをバイナリ形式でバッファに記録し、後でまとめて出力するクラス
+ *
+ * `DebugLogger` はログを呼び出した時点で文字列を整形して出力するため、
+ * シリアルポートが書き込み可能になるまで呼び出し元が待たされます。
+ * このファイルで定義する `DeferredDebugLogger` は、メッセージ番号と引数の
+ * 生のバイト列だけをリングバッファに記録し（O(1)）、シリアルポートへの出力は
+ * `drain()` を呼び出した時に行います。そのため、制御ループなどの処理時間が
+ * 重要な部分でもログを記録できます。
+ *
+ * 出力されたバイナリは、PC上で `scripts/decode_log.py`
+ * を使用して文字列に戻します。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <DebugLogger.h>
+#include <fasts/RingBuffer.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief ログの引数の合計バイト数を計算するクラス
+ *
+ * @tparam Args 引数の型
+ */
+template <typename... Args> struct DeferredLogArgSize;
+
+/**
+ * @brief 引数がない場合の特殊化
+ */
+template <> struct DeferredLogArgSize<> {
+  /// 引数がないため、`value` は0。
+  static const uint8_t value = 0;
+};
+
+/**
+ * @brief 引数がある場合の部分特殊化
+ *
+ * @tparam First 最初の引数の型
+ * @tparam Rest 残りの引数の型
+ */
+template <typename First, typename... Rest>
+struct DeferredLogArgSize<First, Rest...> {
+  /// 最初の引数のサイズと残りの引数のサイズの合計。
+  static const uint8_t value =
+      sizeof(First) + DeferredLogArgSize<Rest...>::value;
+};
+
+/**
+ * @class DeferredDebugLogger
+ * @brief ログをバイナリ形式で記録し、アイドル時に出力するテンプレートクラス
+ *
+ * 1件のログは次の形式（リトルエンディアン）でリングバッファに記録されます。
+ *
+ * | バイト | 内容                                              |
+ * | ------ | ------------------------------------------------- |
+ * | 0      | 同期バイト（0xA5）                                |
+ * | 1      | メッセージ番号                                    |
+ * | 2      | 上位2ビット: ログレベル、下位6ビット: 引数のバイト数 |
+ * | 3～4   | タイムスタンプ（millis()の下位16ビット）          |
+ * | 5～    | 引数の生のバイト列                                |
+ *
+ * メッセージ番号とフォーマット文字列の対応は、PC側のメッセージ定義ファイルに記述します。
+ * ログの記録はメインループからのみ行ってください（割り込みからは記録できません）。
+ *
+ * 使用例:
+ * @code
+ * DeferredDebugLogger<HardwareSerial> logger(Serial);
+ *
+ * void loop() {
+ *   int speed = 100;
+ *   // メッセージ番号1: "speed=%d"
+ *   logger.log(DebugLoggerLevel::INFO, 1, speed);
+ *   // 空き時間に出力する
+ *   logger.drain();
+ * }
+ * @endcode
+ *
+ * @tparam SerialType シリアルポートクラスの型。例：`HardwareSerial`
+ * @tparam bufferSize リングバッファのサイズ（2～128の2のべき乗、デフォルトは64）
+ * @tparam maxArgBytes 1件のログに記録できる引数の最大バイト数（デフォルトは8）
+ * @tparam minLevel コンパイル時に指定する最小のログレベル（デフォルトはINFO）
+ */
+template <typename SerialType, uint8_t bufferSize = 64, uint8_t maxArgBytes = 8,
+          DebugLoggerLevel minLevel = DebugLoggerLevel::INFO>
+class DeferredDebugLogger {
+  // 引数のバイト数は6ビットで記録する
+  static_assert(maxArgBytes <= 63,
+                "引数の最大バイト数は63以下でなければなりません");
+  // 最大サイズのログが1件も入らないバッファは使用できない
+  static_assert(5 + maxArgBytes < bufferSize,
+                "バッファのサイズが小さすぎます");
+
+public:
+  /// ログの先頭を示す同期バイト
+  static const uint8_t SYNC = 0xA5;
+
+  /**
+   * @brief コンストラクタ
+   *
+   * @param serial ログを出力するシリアルポートへの参照
+   */
+  DeferredDebugLogger(SerialType &serial) : serial(serial) {}
+
+  /**
+   * @brief シリアルポートを初期化するメソッド
+   *
+   * @param baudrate シリアル通信のボーレート（デフォルトは19200）
+   */
+  void begin(unsigned long baudrate = 19200) { serial.begin(baudrate); }
+
+  /**
+   * @brief 指定したレベルのログがコンパイル時に取り除かれるかどうか
+   *
+   * @param level ログレベル
+   * @return `minLevel` より低いレベルの場合は true
+   */
+  static constexpr bool isCompiledOut(DebugLoggerLevel level) {
+    return level < minLevel;
+  }
+
+  /**
+   * @brief ログをバッファに記録するメソッド
+   *
+   * メッセージ番号と引数の生のバイト列をバッファに記録します。
+   * 文字列の整形やシリアルポートへの出力は行わないため、処理時間は一定です。
+   * バッファに空きがない場合は記録せず、破棄したログの数を数えます。
+   *
+   * @tparam Args 引数の型（合計 `maxArgBytes` バイト以下）
+   * @param level ログレベル
+   * @param messageId メッセージ番号
+   * @param args フォーマット文字列に埋め込む引数
+   * @return 記録できた場合は true
+   */
+  template <typename... Args>
+  bool log(DebugLoggerLevel level, uint8_t messageId, const Args &...args) {
+    // コンパイル時に指定されたレベルより低い場合、記録しない
+    if (isCompiledOut(level)) {
+      return false;
+    }
+
+    // 引数の合計バイト数（コンパイル時に決まる）
+    static const uint8_t argBytes = DeferredLogArgSize<Args...>::value;
+    static_assert(argBytes <= maxArgBytes, "引数のサイズが大きすぎます");
+
+    // ログを組み立てる
+    uint8_t record[5 + argBytes];
+    uint16_t timestamp = static_cast<uint16_t>(millis());
+    record[0] = SYNC;
+    record[1] = messageId;
+    record[2] = (static_cast<uint8_t>(level) << 6) | argBytes;
+    record[3] = timestamp & 0xFF;
+    record[4] = timestamp >> 8;
+    copyArgs(record + 5, args...);
+
+    // 途中までしか書き込めない場合は、ログ全体を破棄する
+    if (buffer.space() < sizeof(record)) {
+      if (droppedCount < 255) {
+        droppedCount++;
+      }
+      return false;
+    }
+    buffer.push(record, sizeof(record));
+    return true;
+  }
+
+  /**
+   * @brief バッファに記録されたログをシリアルポートに出力するメソッド
+   *
+   * シリアルポートに待機せずに書き込める分だけ出力し、すぐに戻ります。
+   * `loop()` の空き時間などに繰り返し呼び出してください。
+   *
+   * @return 出力したバイト数
+   */
+  uint8_t drain() {
+    uint8_t count = 0;
+    uint8_t data;
+    while (serial.availableForWrite() > 0 && buffer.pop(data)) {
+      serial.write(data);
+      count++;
+    }
+    return count;
+  }
+
+  /**
+   * @brief バッファに空きがなく破棄したログの数を取得するメソッド
+   *
+   * @return 破棄したログの数（255で止まる）
+   */
+  uint8_t dropped() const { return droppedCount; }
+
+private:
+  /// ログを出力するシリアルポートへの参照
+  SerialType &serial;
+  /// 出力待ちのログを格納するリングバッファ
+  RingBuffer<uint8_t, bufferSize> buffer;
+  /// バッファに空きがなく破棄したログの数
+  uint8_t droppedCount = 0;
+
+  /// 引数がなくなった時に再帰を終了する
+  static void copyArgs(uint8_t *) {}
+
+  /**
+   * @brief 引数の生のバイト列を順番にコピーする
+   *
+   * @param dest コピー先
+   * @param first 最初の引数
+   * @param rest 残りの引数
+   */
+  template <typename First, typename... Rest>
+  static void copyArgs(uint8_t *dest, const First &first,
+                       const Rest &...rest) {
+    memcpy(dest, &first, sizeof(First));
+    copyArgs(dest + sizeof(First), rest...);
+  }
+};
@@ -43,4 +43,19 @@ void Converter::fromHex(const char *hexString, size_t length, uint8_t *output) {
     // 上位4ビットと下位4ビットを結合して1バイトの値にする
     output[i] = (upperValue << 4) | lowerValue;
   }
+}
+
+// 16進数文字1文字を数値に変換する関数
+// hexChar: 入力16進数文字
+// 戻り値: 変換された値（0～15）。16進数文字でない場合は0xFF
+uint8_t Converter::fromHexDigit(char hexChar) {
+  // '0'より小さい文字は負の値になり、uint8_tでは大きな値になる
+  uint8_t index = static_cast<uint8_t>(hexChar - '0');
+  // 'F'より大きい文字は16進数ではない
+  if (index >= sizeof(valueLookup)) {
+    return 0xFF;
+  }
+  uint8_t value = valueLookup[index];
+  // パディング（':'～'@'）は16進数ではない
+  return value < 16 ? value : 0xFF;
 }
\ No newline at end of file
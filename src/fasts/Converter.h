@@ -48,6 +48,17 @@ public:
    */
   static void fromHex(const char *hexString, size_t length, uint8_t *output);
 
+  /**
+   * @brief 16進数文字1文字を数値に変換します。
+   *
+   * '0'-'9' 及び 'A'-'F' を 0～15 の値に変換します。
+   * 1文字ずつ届くデータを逐次変換する場合に使用します。
+   *
+   * @param hexChar 変換する16進数文字
+   * @return 変換後の値（0～15）。16進数文字でない場合は 0xFF
+   */
+  static uint8_t fromHexDigit(char hexChar);
+
 private:
   /**
    * @brief 16進数文字に対応する数値を取得するためのルックアップテーブル
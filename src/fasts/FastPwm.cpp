@@ -0,0 +1,72 @@
+#include "FastPwm.h"
+#include <Arduino.h>
+
+// タイマーのPWMの周波数を設定する
+// クロック選択ビット（CSn2:0）の値は、分周比 1, 8, 64, 256, 1024 の順
+bool FastPwm::setFrequency(uint8_t timer, PwmFrequency frequency) {
+  uint8_t index = static_cast<uint8_t>(frequency);
+  (void)index; // タイマーのないマイコンでは未使用
+
+  switch (timer) {
+#if defined(TCCR1B)
+  case TIMER1A:
+  case TIMER1B: {
+    static const uint8_t select[] = {1, 2, 3, 4, 5};
+    TCCR1B = (TCCR1B & ~0x07) | select[index];
+    return true;
+  }
+#endif
+#if defined(TCCR2B)
+  case TIMER2A:
+  case TIMER2B: {
+#if defined(TIMSK2)
+    // Timer2の割り込みを使用している場合（MsTimer2やtone()）は変更しない
+    if (TIMSK2 & (_BV(TOIE2) | _BV(OCIE2A) | _BV(OCIE2B))) {
+      return false;
+    }
+#endif
+    static const uint8_t select[] = {1, 2, 4, 6, 7};
+    TCCR2B = (TCCR2B & ~0x07) | select[index];
+    return true;
+  }
+#endif
+  default:
+    // Timer0は millis() に使用されているため変更しない
+    return false;
+  }
+}
+
+// コンストラクタ: ピンに対応するレジスタを調べる
+FastPwm::FastPwm(uint8_t pin) {
+  pinMode(pin, OUTPUT);
+  timer = digitalPinToTimer(pin);
+  compare = channel(timer);
+  uint8_t pinPort = digitalPinToPort(pin);
+  if (pinPort != NOT_A_PIN) {
+    port = portOutputRegister(pinPort);
+    bit = digitalPinToBitMask(pin);
+  }
+}
+
+// PWM値を出力する
+void FastPwm::write(uint8_t value) {
+  if (value != 0 && value != 255 && compare.isValid()) {
+    compare.attach(value);
+    return;
+  }
+
+  // analogWrite() と同様に、0と255やタイマーのないピンはデジタル出力にする
+  if (compare.isValid()) {
+    compare.detach();
+  }
+  if (port != nullptr) {
+    uint8_t oldSREG = SREG;
+    cli();
+    if (value >= 128) {
+      *port |= bit;
+    } else {
+      *port &= ~bit;
+    }
+    SREG = oldSREG;
+  }
+}
@@ -0,0 +1,287 @@
+/**
+ * @file FastPwm.h
+ * @brief コンペアレジスタに直接書き込むPWM出力のクラス定義
+ *
+ * `analogWrite()` は呼び出すたびにピンからタイマーを調べるため時間がかかり、
+ * PWMの周波数も約490Hz（ピン5、6は約980Hz）に固定されています。
+ * このファイルで定義する `FastPwm` クラスは、ピンに対応するレジスタを
+ * コンストラクタで調べておき、出力時はコンペアレジスタに直接書き込みます。
+ * また、Timer1とTimer2のPWMの周波数を変更できます。
+ * ピン番号が定数の場合は、レジスタをコンパイル時に決める `StaticPwm` クラスを使用できます。
+ *
+ * @note ATmega328PのTimer0〜Timer2のピン（3、5、6、9、10、11）に対応しています。
+ * @note Timer2（ピン3、11）は `MsTimer2`（`IM920SL::onDataNotReceived()` が使用）と
+ *       共有できません。MsTimer2を使用する場合は、Timer1のピン（9、10）を使用してください。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <digitalWriteFast.h>
+#include <stdint.h>
+
+/**
+ * @brief PWMの周波数（ATmega328P、16MHz、位相基準PWMの場合）
+ *
+ * Timer0は `millis()` に使用されているため変更できません。
+ */
+enum class PwmFrequency : uint8_t {
+  HZ_31372, ///< 約31kHz（分周なし）。モーターの音が聞こえなくなる
+  HZ_3922,  ///< 約3.9kHz（8分周）
+  HZ_490,   ///< 約490Hz（64分周）。Arduinoの初期設定
+  HZ_123,   ///< 約123Hz（256分周）
+  HZ_31     ///< 約31Hz（1024分周）
+};
+
+/**
+ * @class FastPwm
+ * @brief コンペアレジスタに直接書き込むPWM出力のクラス
+ *
+ * `write()` は `analogWrite()` と同じ出力を行います（0と255はデジタル出力になり、
+ * タイマーのないピンは128以上でHIGHになります）。
+ *
+ * Timer2は `MsTimer2` も使用します。MsTimer2はTimer2をPWMではないモードに設定し、
+ * 分周比も変更するため、MsTimer2の開始後はピン3、11のPWM出力が正しく動作しません。
+ * `IM920SL::onDataNotReceived()` などでMsTimer2を使用する場合は、モーターのPWMピンに
+ * Timer1のピン（9、10）を使用してください。
+ *
+ * 使用例:
+ * @code
+ * FastPwm pwm(9);
+ * pwm.setFrequency(PwmFrequency::HZ_31372); // Timer1（ピン9、10）を約31kHzにする
+ * pwm.write(128);
+ * @endcode
+ */
+class FastPwm {
+public:
+  /**
+   * @struct CompareChannel
+   * @brief タイマーの1つの出力（コンペアレジスタ）を操作するための情報
+   */
+  struct CompareChannel {
+    volatile uint8_t *control; ///< ピンの接続を切り替えるレジスタ（TCCRnA）
+    uint8_t connectBit;        ///< ピンをタイマーに接続するビット（COMnx1）
+    volatile uint8_t *compare; ///< コンペアレジスタ（OCRnx）
+    bool wide;                 ///< コンペアレジスタが16ビットかどうか
+
+    /**
+     * @brief 対応するコンペアレジスタがあるかどうか
+     *
+     * @return コンペアレジスタがある場合は true
+     */
+    bool isValid() const { return compare != nullptr; }
+
+    /**
+     * @brief コンペアレジスタにPWM値を書き込み、ピンをタイマーに接続する
+     *
+     * @param value PWM値
+     */
+    void attach(uint8_t value) const {
+      if (wide) {
+        *reinterpret_cast<volatile uint16_t *>(compare) = value;
+      } else {
+        *compare = value;
+      }
+      *control |= connectBit;
+    }
+
+    /**
+     * @brief ピンをタイマーから切り離す
+     *
+     * 切り離したピンは、ポートの出力レジスタの値を出力します。
+     */
+    void detach() const { *control &= ~connectBit; }
+  };
+
+  /// タイマーの出力の最大数（ATmega328PはTimer0〜Timer2のA、B）
+  static const uint8_t MAX_CHANNELS = 6;
+
+  /**
+   * @brief タイマーの出力に対応するレジスタを取得する
+   *
+   * `timer` が定数の場合は、コンパイル時にレジスタが決まるようにヘッダーで定義しています。
+   *
+   * @param timer タイマーの出力（`digitalPinToTimer()` の値）
+   * @return レジスタの情報（対応していない場合は `isValid()` が false）
+   */
+  static CompareChannel channel(uint8_t timer) {
+    CompareChannel result = {nullptr, 0, nullptr, false};
+    switch (timer) {
+#if defined(TCCR0A) && defined(COM0A1)
+    case TIMER0A:
+      result = {&TCCR0A, _BV(COM0A1), &OCR0A, false};
+      break;
+#endif
+#if defined(TCCR0A) && defined(COM0B1)
+    case TIMER0B:
+      result = {&TCCR0A, _BV(COM0B1), &OCR0B, false};
+      break;
+#endif
+#if defined(TCCR1A) && defined(COM1A1)
+    case TIMER1A:
+      result = {&TCCR1A, _BV(COM1A1),
+                reinterpret_cast<volatile uint8_t *>(&OCR1A), true};
+      break;
+#endif
+#if defined(TCCR1A) && defined(COM1B1)
+    case TIMER1B:
+      result = {&TCCR1A, _BV(COM1B1),
+                reinterpret_cast<volatile uint8_t *>(&OCR1B), true};
+      break;
+#endif
+#if defined(TCCR2A) && defined(COM2A1)
+    case TIMER2A:
+      result = {&TCCR2A, _BV(COM2A1), &OCR2A, false};
+      break;
+#endif
+#if defined(TCCR2A) && defined(COM2B1)
+    case TIMER2B:
+      result = {&TCCR2A, _BV(COM2B1), &OCR2B, false};
+      break;
+#endif
+    default:
+      break;
+    }
+    return result;
+  }
+
+#if defined(__AVR_ATmega328P__)
+  /**
+   * @brief ピンのタイマーの出力をコンパイル時に求める（ATmega328Pのみ）
+   *
+   * `digitalPinToTimer()` はフラッシュメモリの表を読むため、定数になりません。
+   *
+   * @param pin ピンの番号
+   * @return タイマーの出力（`digitalPinToTimer()` と同じ値）
+   */
+  static constexpr uint8_t pinTimer(uint8_t pin) {
+    return pin == 3    ? TIMER2B
+           : pin == 5  ? TIMER0B
+           : pin == 6  ? TIMER0A
+           : pin == 9  ? TIMER1A
+           : pin == 10 ? TIMER1B
+           : pin == 11 ? TIMER2A
+                       : NOT_ON_TIMER;
+  }
+#endif
+
+  /**
+   * @brief タイマーのPWMの周波数を設定する
+   *
+   * 同じタイマーを使用する2つのピンの周波数が変わります。
+   * Timer2の割り込みが有効な場合（`MsTimer2` や `tone()` が使用している場合）は、
+   * Timer2を変更せずに false を返します。その場合はTimer1のピン（9、10）を使用してください。
+   *
+   * @param timer タイマーの出力（`digitalPinToTimer()` の値）
+   * @param frequency PWMの周波数
+   * @return 設定できた場合は true（Timer0、タイマーのないピン、
+   * 他のライブラリが使用しているTimer2は false）
+   */
+  static bool setFrequency(uint8_t timer, PwmFrequency frequency);
+
+  /**
+   * @brief コンストラクタ (ピンを使用しない場合)
+   *
+   * `write()` は何もしません。
+   */
+  FastPwm() = default;
+
+  /**
+   * @brief コンストラクタ
+   *
+   * ピンを出力モードに設定し、ピンに対応するレジスタを調べます。
+   *
+   * @param pin PWM信号を出力するピンの番号
+   */
+  explicit FastPwm(uint8_t pin);
+
+  /**
+   * @brief PWM値を出力する
+   *
+   * @param value PWM値（0〜255）
+   */
+  void write(uint8_t value);
+
+  /**
+   * @brief このピンのタイマーのPWMの周波数を設定する
+   *
+   * Timer2のピン（3、11）は、MsTimer2が使用している場合は設定できません。
+   *
+   * @param frequency PWMの周波数
+   * @return 設定できた場合は true（Timer0、タイマーのないピン、
+   * 他のライブラリが使用しているTimer2は false）
+   */
+  bool setFrequency(PwmFrequency frequency) const {
+    return setFrequency(timer, frequency);
+  }
+
+private:
+  CompareChannel compare = {nullptr, 0, nullptr, false}; /**< コンペアレジスタ */
+  volatile uint8_t *port = nullptr; /**< ポートの出力レジスタ */
+  uint8_t bit = 0;                  /**< ポートのビット */
+  uint8_t timer = 0;                /**< タイマーの出力 */
+};
+
+/**
+ * @class StaticPwm
+ * @brief ピン番号をコンパイル時に指定する `FastPwm`
+ *
+ * ATmega328Pでは、ピンに対応するレジスタがコンパイル時に決まるため、`write()` は
+ * コンペアレジスタへの書き込みとピンの接続（またはポートの1ビットの書き換え）だけになります。
+ * メンバ変数を持たないため、RAMを使用しません。
+ * 他のマイコンでは `analogWrite()` を使用します。
+ *
+ * 使用例:
+ * @code
+ * StaticPwm<9>::setFrequency(PwmFrequency::HZ_31372);
+ * StaticPwm<9>::write(128);
+ * @endcode
+ *
+ * @tparam Pin PWM信号を出力するピンの番号
+ */
+template <uint8_t Pin> class StaticPwm {
+public:
+  /**
+   * @brief PWM値を出力する
+   *
+   * `FastPwm::write()` と同じ出力を行います。ピンは出力モードに設定しておいてください。
+   *
+   * @param value PWM値（0〜255）
+   */
+  static void write(uint8_t value) {
+#if defined(__AVR_ATmega328P__)
+    FastPwm::CompareChannel compare = FastPwm::channel(timer());
+    if (value != 0 && value != 255 && compare.isValid()) {
+      compare.attach(value);
+      return;
+    }
+    // analogWrite() と同様に、0と255やタイマーのないピンはデジタル出力にする
+    if (compare.isValid()) {
+      compare.detach();
+    }
+    digitalWriteFast(Pin, value >= 128);
+#else
+    analogWrite(Pin, value);
+#endif
+  }
+
+  /**
+   * @brief このピンのタイマーのPWMの周波数を設定する
+   *
+   * @param frequency PWMの周波数
+   * @return 設定できた場合は true（`FastPwm::setFrequency()` と同じ）
+   */
+  static bool setFrequency(PwmFrequency frequency) {
+    return FastPwm::setFrequency(timer(), frequency);
+  }
+
+private:
+  /// ピンのタイマーの出力
+  static uint8_t timer() {
+#if defined(__AVR_ATmega328P__)
+    return FastPwm::pinTimer(Pin);
+#else
+    return digitalPinToTimer(Pin);
+#endif
+  }
+};
@@ -1,5 +1,6 @@
 #include "FastwareSerial.h"
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <fasts/Converter.h>
 
 // グローバルインスタンスの定義
@@ -10,31 +11,51 @@ void FastwareSerial::begin(unsigned long baudrate) {
 #if defined(__AVR_ATmega328P__)
   // ボーレートの設定
   UBRR0 = (F_CPU / 16 / baudrate - 1);
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
   // 受信、送信、受信割り込みの有効化
   UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+#else
+  // 受信、送信の有効化（割り込みハンドラが無いため、割り込みは使用しない）
+  UCSR0B = _BV(RXEN0) | _BV(TXEN0);
+#endif
   // フレームフォーマットの設定: 8データビット、1ストップビット
   UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
   // グローバル割り込みの有効化
   sei();
+#else
+  (void)baudrate;
 #endif
 }
 
 // 受信バッファにデータがあるか確認する関数
 uint8_t FastwareSerial::available() {
-#if defined(__AVR_ATmega328P__)
-  // 受信完了フラグをチェック
-  return UCSR0A & _BV(RXC0);
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  // 受信バッファに格納されているバイト数
+  return rxBuffer.size();
+#elif defined(__AVR_ATmega328P__)
+  // 受信完了フラグをチェック（受信データレジスタの1バイトのみ）
+  return (UCSR0A & _BV(RXC0)) ? 1 : 0;
+#else
+  return 0;
 #endif
 }
 
 // 1バイトのデータを読み取る関数
 char FastwareSerial::read() {
-#if defined(__AVR_ATmega328P__)
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  // データが受信されるまで待機
+  uint8_t data;
+  while (!rxBuffer.pop(data))
+    ;
+  return data;
+#elif defined(__AVR_ATmega328P__)
   // データが受信されるまで待機
   while (!available())
     ;
   // 受信データを返す
   return UDR0;
+#else
+  return 0;
 #endif
 }
 
@@ -56,13 +77,74 @@ uint8_t FastwareSerial::readBytesUntil(char terminator, char *buffer, uint8_t le
 
 // 1バイトのデータを書き込む関数
 uint8_t FastwareSerial::write(uint8_t data) {
-#if defined(__AVR_ATmega328P__)
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  // 送信バッファと送信データレジスタが空の場合は、割り込みを待たずに直接送信
+  if (txBuffer.empty() && (UCSR0A & _BV(UDRE0))) {
+    UDR0 = data;
+    return 1;
+  }
+  // 送信バッファに空きができるまで待機
+  while (!txBuffer.push(data)) {
+    // 割り込みが禁止されている場合は、割り込みの代わりに送信を進める
+    if (!(SREG & _BV(SREG_I)) && (UCSR0A & _BV(UDRE0))) {
+      handleUdreInterrupt();
+    }
+  }
+  // 送信データレジスタ空き割り込みを有効にして、送信を開始
+  UCSR0B |= _BV(UDRIE0);
+  return 1;
+#elif defined(__AVR_ATmega328P__)
   // 送信バッファが空になるまで待機
   while (!(UCSR0A & _BV(UDRE0)))
     ;
   // データを送信
   UDR0 = data;
   return 1;
+#else
+  (void)data;
+  return 0;
+#endif
+}
+
+// 複数バイトのデータをまとめて書き込む関数
+size_t FastwareSerial::write(const uint8_t *buffer, size_t size) {
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  size_t count = 0;
+  while (count < size) {
+    // 送信バッファに入る分をまとめて格納
+    size_t remaining = size - count;
+    uint8_t pushed =
+        txBuffer.push(buffer + count, remaining > 255 ? 255 : remaining);
+    count += pushed;
+    if (pushed) {
+      // 送信データレジスタ空き割り込みを有効にして、送信を開始
+      UCSR0B |= _BV(UDRIE0);
+    } else if (!(SREG & _BV(SREG_I)) && (UCSR0A & _BV(UDRE0))) {
+      // 割り込みが禁止されている場合は、割り込みの代わりに送信を進める
+      handleUdreInterrupt();
+    }
+  }
+  return count;
+#else
+  // 1バイトずつ送信
+  size_t count = 0;
+  while (count < size && write(buffer[count])) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+// 待機せずに書き込めるバイト数を取得する関数
+uint8_t FastwareSerial::availableForWrite() {
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  // 送信バッファの空き容量
+  return txBuffer.space();
+#elif defined(__AVR_ATmega328P__)
+  // 送信データレジスタが空いているかどうか
+  return (UCSR0A & _BV(UDRE0)) ? 1 : 0;
+#else
+  return 0;
 #endif
 }
 
@@ -76,6 +158,18 @@ uint8_t FastwareSerial::print(const char *str) {
   return count;
 }
 
+// フラッシュメモリ上の文字列を送信する関数
+uint8_t FastwareSerial::print(const __FlashStringHelper *str) {
+  const char *p = reinterpret_cast<const char *>(str);
+  uint8_t count = 0;
+  char c;
+  while ((c = pgm_read_byte(p++))) {
+    write(c);
+    count++;
+  }
+  return count;
+}
+
 // 文字列を送信し、改行を追加する関数
 uint8_t FastwareSerial::println(const char *str) {
   uint8_t count = print(str);
@@ -83,6 +177,13 @@ uint8_t FastwareSerial::println(const char *str) {
   return count;
 }
 
+// フラッシュメモリ上の文字列を送信し、改行を追加する関数
+uint8_t FastwareSerial::println(const __FlashStringHelper *str) {
+  uint8_t count = print(str);
+  count += println();
+  return count;
+}
+
 // 改行を送信する関数
 uint8_t FastwareSerial::println() { return print("\r\n"); }
 
@@ -100,11 +201,36 @@ void FastwareSerial::onReceive(void (*function)(void)) {
   user_onReceive = function;
 }
 
-// 受信割り込みハンドラ
-#if defined(__AVR_ATmega328P__) && defined(USE_FASTWARE_SERIAL)
-ISR(USART_RX_vect) {
-  if (FastSerial.user_onReceive) {
-    FastSerial.user_onReceive();
+// 受信割り込み時の処理を行う関数
+void FastwareSerial::handleRxInterrupt() {
+#if defined(__AVR_ATmega328P__)
+  // 受信データを読み出す（バッファが満杯の場合は破棄される）
+  uint8_t data = UDR0;
+  rxBuffer.push(data);
+#endif
+  if (user_onReceive) {
+    user_onReceive();
   }
 }
+
+// 送信データレジスタ空き割り込み時の処理を行う関数
+void FastwareSerial::handleUdreInterrupt() {
+#if defined(__AVR_ATmega328P__)
+  uint8_t data;
+  if (txBuffer.pop(data)) {
+    UDR0 = data;
+  }
+  // 送信バッファが空になった場合は、割り込みを無効にする
+  if (txBuffer.empty()) {
+    UCSR0B &= ~_BV(UDRIE0);
+  }
+#endif
+}
+
+// 受信割り込みハンドラ
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+ISR(USART_RX_vect) { FastSerial.handleRxInterrupt(); }
+
+// 送信データレジスタ空き割り込みハンドラ
+ISR(USART_UDRE_vect) { FastSerial.handleUdreInterrupt(); }
 #endif
\ No newline at end of file
@@ -9,18 +9,64 @@
 
 #pragma once
 
+#include "RingBuffer.h"
 #include <stddef.h>
 #include <stdint.h>
 
+// Arduinoのフラッシュメモリ上の文字列（F()マクロ）を表す型
+class __FlashStringHelper;
+
+/**
+ * @brief 受信バッファのサイズ（2～128の2のべき乗）
+ *
+ * ビルドフラグ（例: `-DFASTWARE_SERIAL_RX_BUFFER_SIZE=128`）で変更できます。
+ */
+#ifndef FASTWARE_SERIAL_RX_BUFFER_SIZE
+#define FASTWARE_SERIAL_RX_BUFFER_SIZE 64
+#endif
+
+/**
+ * @brief 送信バッファのサイズ（2～128の2のべき乗）
+ *
+ * ビルドフラグ（例: `-DFASTWARE_SERIAL_TX_BUFFER_SIZE=128`）で変更できます。
+ */
+#ifndef FASTWARE_SERIAL_TX_BUFFER_SIZE
+#define FASTWARE_SERIAL_TX_BUFFER_SIZE 64
+#endif
+
+// 割り込み駆動で送受信するかどうか（USART_RX_vect等を他のライブラリと共有できないため）
+#if defined(__AVR_ATmega328P__) && defined(USE_FASTWARE_SERIAL)
+#define FASTWARE_SERIAL_USE_INTERRUPT
+#endif
+
 /**
  * @class FastwareSerial
  * @brief 高速シリアル通信を提供するクラス
  *
  * FastwareSerial クラスは、標準的なシリアル通信機能を提供し、データの送受信、バッファの確認、
  * およびユーザー定義の受信イベントハンドラをサポートします。
+ *
+ * `USE_FASTWARE_SERIAL` が定義されている場合、送受信は割り込み駆動になります。
+ * 受信データは受信割り込み（USART_RX_vect）で受信バッファに格納され、
+ * 送信データは送信バッファに格納した後、送信データレジスタ空き割り込み
+ * （USART_UDRE_vect）で送信されます。そのため、`write` は待機せずに戻り、
+ * `available` は受信バッファに格納されているバイト数を返します。
  */
 class FastwareSerial {
 public:
+  /**
+   * @brief `availableForWrite` が返すことのできる最大値
+   *
+   * 割り込み駆動の場合、送信バッファは満杯と空を区別するため、サイズより1バイト
+   * 少なく格納できます。そうでない場合は送信データレジスタの1バイトです。
+   * `IM920SL::send` などは、この値より大きい空き容量を待ちません。
+   */
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  static const uint8_t TX_BUFFER_CAPACITY = FASTWARE_SERIAL_TX_BUFFER_SIZE - 1;
+#else
+  static const uint8_t TX_BUFFER_CAPACITY = 1;
+#endif
+
   /**
    * @brief シリアル通信の初期化を行います。
    * @param baudrate シリアル通信のボーレート（通信速度）
@@ -53,11 +99,39 @@ public:
 
   /**
    * @brief 1バイトのデータを送信します。
+   *
+   * 送信バッファに空きがある場合は、バッファに格納してすぐに戻ります。
+   * 送信バッファが満杯の場合は、空きができるまで待機します。
+   *
    * @param data 送信するデータ（1バイト）
    * @return 送信に成功した場合は 1、失敗した場合は 0
    */
   uint8_t write(uint8_t data);
 
+  /**
+   * @brief 複数バイトのデータをまとめて送信します。
+   *
+   * 送信バッファに空きがある分をまとめて格納し、送信を開始します。
+   * 1バイトずつ `write` を呼び出すよりも、割り込みの有効化などの処理が少なくなります。
+   * 送信バッファに入りきらない場合は、空きができるまで待機します。
+   *
+   * @param buffer 送信するデータ
+   * @param size 送信するデータのバイト数
+   * @return 送信に成功したバイト数
+   */
+  size_t write(const uint8_t *buffer, size_t size);
+
+  /**
+   * @brief 待機せずに書き込めるバイト数を取得します。
+   *
+   * 割り込み駆動の場合は送信バッファの空き容量を返します。
+   * そうでない場合は、送信データレジスタが空いていれば 1 を返します
+   * （`write` は送信データレジスタの空きを待って書き込みます）。
+   *
+   * @return 待機せずに書き込めるバイト数
+   */
+  uint8_t availableForWrite();
+
   /**
    * @brief 文字列を送信します。
    * @param str 送信する文字列
@@ -65,6 +139,13 @@ public:
    */
   uint8_t print(const char *str);
 
+  /**
+   * @brief フラッシュメモリ上の文字列を送信します。
+   * @param str 送信する文字列（`F()` マクロで指定したもの）
+   * @return 送信に成功したバイト数
+   */
+  uint8_t print(const __FlashStringHelper *str);
+
   /**
    * @brief 数値データを文字列として送信します。
    * @param value 送信する数値
@@ -79,6 +160,13 @@ public:
    */
   uint8_t println(const char *str);
 
+  /**
+   * @brief フラッシュメモリ上の文字列を送信し、改行を付加します。
+   * @param str 送信する文字列（`F()` マクロで指定したもの）
+   * @return 送信に成功したバイト数
+   */
+  uint8_t println(const __FlashStringHelper *str);
+
   /**
    * @brief 改行のみを送信します。
    * @return 送信に成功したバイト数
@@ -97,6 +185,28 @@ public:
    * `onReceive` メソッドで設定された、データ受信時に呼び出されるコールバック関数です。
    */
   void (*user_onReceive)(void);
+
+  /**
+   * @brief 受信割り込み時の処理を行います。
+   *
+   * 受信したデータを受信バッファに格納し、受信イベントハンドラを呼び出します。
+   * 受信割り込みハンドラ（USART_RX_vect）から呼び出されます。
+   */
+  void handleRxInterrupt();
+
+  /**
+   * @brief 送信データレジスタ空き割り込み時の処理を行います。
+   *
+   * 送信バッファからデータを1バイト取り出して送信します。送信バッファが空になった場合は、
+   * 割り込みを無効にします。割り込みハンドラ（USART_UDRE_vect）から呼び出されます。
+   */
+  void handleUdreInterrupt();
+
+private:
+  /// 受信割り込みで格納され、`read` で読み出される受信バッファ
+  RingBuffer<uint8_t, FASTWARE_SERIAL_RX_BUFFER_SIZE> rxBuffer;
+  /// `write` で格納され、割り込みで送信される送信バッファ
+  RingBuffer<uint8_t, FASTWARE_SERIAL_TX_BUFFER_SIZE> txBuffer;
 };
 
 /**
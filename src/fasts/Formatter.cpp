@@ -0,0 +1,238 @@
+#include "Formatter.h"
+#include <avr/pgmspace.h>
+
+namespace {
+
+// 整形した文字列をバッファに書き込むためのクラス
+// バッファの終端を超える文字は捨てる
+class Writer {
+public:
+  Writer(char *buffer, size_t size)
+      : position(buffer), last(buffer + size - 1) {}
+
+  // 1文字書き込む
+  void put(char c) {
+    if (position < last) {
+      *position++ = c;
+    }
+  }
+
+  // 同じ文字を指定した数だけ書き込む
+  void fill(char c, uint8_t count) {
+    while (count-- > 0) {
+      put(c);
+    }
+  }
+
+  // null終端文字を書き込み、書き込んだ文字数を返す
+  size_t finish(char *buffer) {
+    *position = '\0';
+    return position - buffer;
+  }
+
+private:
+  char *position;
+  char *last;
+};
+
+// 符号なし整数を文字列に変換する関数
+// 桁を下位から順にバッファの末尾に向かって書き込み、先頭の位置を返す
+// AVRでは32ビットの除算が遅いため、int型の値はint型のまま変換する
+template <typename T>
+char *toDigits(char *end, T value, uint8_t base, bool upper) {
+  const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  do {
+    *--end = digits[value % base];
+    value /= base;
+  } while (value != 0);
+  return end;
+}
+
+// SRAM上のフォーマット文字列を1文字ずつ読むためのクラス
+class RamSource {
+public:
+  explicit RamSource(const char *position) : position(position) {}
+
+  // 現在の文字を返す
+  char peek() const { return *position; }
+
+  // 現在の文字を返し、次の文字に進む
+  char next() { return *position++; }
+
+private:
+  const char *position;
+};
+
+// フラッシュメモリ上のフォーマット文字列を1文字ずつ読むためのクラス
+class FlashSource {
+public:
+  explicit FlashSource(const char *position) : position(position) {}
+
+  // 現在の文字を返す
+  char peek() const { return pgm_read_byte(position); }
+
+  // 現在の文字を返し、次の文字に進む
+  char next() { return pgm_read_byte(position++); }
+
+private:
+  const char *position;
+};
+
+// フォーマット文字列に従って文字列を整形する関数
+// フォーマット文字列の読み方（SRAMまたはフラッシュメモリ）を型で切り替える
+template <typename Source>
+size_t formatFrom(char *buffer, size_t size, Source format, va_list args) {
+  if (size == 0) {
+    return 0;
+  }
+
+  Writer writer(buffer, size);
+  while (format.peek() != '\0') {
+    char c = format.next();
+    if (c != '%') {
+      writer.put(c);
+      continue;
+    }
+
+    // フラグと幅を読み取る
+    char pad = ' ';
+    if (format.peek() == '0') {
+      pad = '0';
+      format.next();
+    }
+    uint8_t width = 0;
+    while (format.peek() >= '0' && format.peek() <= '9') {
+      width = width * 10 + (format.next() - '0');
+    }
+
+    // 長さ修飾子を読み取る
+    bool isLong = false;
+    if (format.peek() == 'l') {
+      isLong = true;
+      format.next();
+    } else {
+      // h, hhは可変引数でintに昇格されるため無視する
+      while (format.peek() == 'h') {
+        format.next();
+      }
+    }
+
+    char conversion = format.next();
+    if (conversion == '\0') {
+      break;
+    }
+
+    switch (conversion) {
+    case 'c':
+      writer.put(static_cast<char>(va_arg(args, int)));
+      break;
+    case 's': {
+      const char *str = va_arg(args, const char *);
+      if (str == nullptr) {
+        str = "(null)";
+      }
+      while (*str != '\0') {
+        writer.put(*str++);
+      }
+      break;
+    }
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X': {
+      // 10進数の桁数は1バイトあたり3桁未満なので、unsigned long の最大値も収まる
+      // （AVRでは10桁、64ビットのlongを持つPCでは20桁。符号はここに書き込まない）
+      char digits[sizeof(unsigned long) * 3 + 1];
+      char *end = digits + sizeof(digits);
+      char *start;
+      bool negative = false;
+      uint8_t base = (conversion == 'x' || conversion == 'X') ? 16 : 10;
+      bool upper = conversion == 'X';
+
+      if (conversion == 'd' || conversion == 'i') {
+        if (isLong) {
+          long value = va_arg(args, long);
+          negative = value < 0;
+          // 最小値でも正しく変換できるように、符号なしの型で反転する
+          unsigned long magnitude = negative
+                                        ? 0UL - static_cast<unsigned long>(value)
+                                        : static_cast<unsigned long>(value);
+          start = toDigits(end, magnitude, base, upper);
+        } else {
+          int value = va_arg(args, int);
+          negative = value < 0;
+          unsigned int magnitude = negative
+                                       ? 0U - static_cast<unsigned int>(value)
+                                       : static_cast<unsigned int>(value);
+          start = toDigits(end, magnitude, base, upper);
+        }
+      } else if (isLong) {
+        start = toDigits(end, va_arg(args, unsigned long), base, upper);
+      } else {
+        start = toDigits(end, va_arg(args, unsigned int), base, upper);
+      }
+
+      uint8_t length = (end - start) + (negative ? 1 : 0);
+      uint8_t padding = width > length ? width - length : 0;
+      // ゼロ埋めの場合は符号の後に、空白埋めの場合は符号の前に埋める
+      if (pad == ' ') {
+        writer.fill(' ', padding);
+      }
+      if (negative) {
+        writer.put('-');
+      }
+      if (pad == '0') {
+        writer.fill('0', padding);
+      }
+      while (start < end) {
+        writer.put(*start++);
+      }
+      break;
+    }
+    case '%':
+      writer.put('%');
+      break;
+    default:
+      // 対応していない指定子はそのまま出力する
+      writer.put('%');
+      writer.put(conversion);
+      break;
+    }
+  }
+  return writer.finish(buffer);
+}
+
+} // namespace
+
+// フォーマット文字列に従って文字列を整形する関数
+size_t Formatter::format(char *buffer, size_t size, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t length = vformat(buffer, size, format, args);
+  va_end(args);
+  return length;
+}
+
+// フォーマット文字列に従って文字列を整形する関数（va_list版）
+size_t Formatter::vformat(char *buffer, size_t size, const char *format,
+                          va_list args) {
+  return formatFrom(buffer, size, RamSource(format), args);
+}
+
+// フラッシュメモリ上のフォーマット文字列に従って文字列を整形する関数
+size_t Formatter::format(char *buffer, size_t size,
+                         const __FlashStringHelper *format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t length = vformat(buffer, size, format, args);
+  va_end(args);
+  return length;
+}
+
+// フラッシュメモリ上のフォーマット文字列に従って文字列を整形する関数（va_list版）
+size_t Formatter::vformat(char *buffer, size_t size,
+                          const __FlashStringHelper *format, va_list args) {
+  return formatFrom(buffer, size,
+                    FlashSource(reinterpret_cast<const char *>(format)), args);
+}
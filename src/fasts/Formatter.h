@@ -0,0 +1,91 @@
+/**
+ * @file Formatter.h
+ * @brief printf形式の文字列を軽量に整形するクラス
+ *
+ * `Formatter` クラスは、整数と文字列だけに対応したprintf形式の整形機能を提供します。
+ * 浮動小数点数に対応しない代わりに、`vsnprintf` よりもフラッシュメモリの使用量が少なく、
+ * 処理も高速です。
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Arduinoのフラッシュメモリ上の文字列（F()マクロ）を表す型
+class __FlashStringHelper;
+
+/**
+ * @class Formatter
+ * @brief 整数と文字列だけに対応したprintf形式の整形を行うユーティリティクラス
+ *
+ * 対応している変換指定子は次の通りです。
+ *
+ * | 指定子         | 内容                                  |
+ * | -------------- | ------------------------------------- |
+ * | `%d` `%i`      | 符号付き10進数                        |
+ * | `%u`           | 符号なし10進数                        |
+ * | `%x` `%X`      | 16進数（小文字・大文字）              |
+ * | `%c`           | 1文字                                 |
+ * | `%s`           | 文字列（幅の指定は無視されます）      |
+ * | `%%`           | `%` そのもの                          |
+ *
+ * 整数には `l`（long）修飾子と、`0` フラグ及び幅（例：`%02X`）を指定できます。
+ * `h` `hh` 修飾子は読み飛ばします（可変引数ではintに昇格されるため）。
+ * 対応していない指定子はそのまま出力します。
+ */
+class Formatter {
+public:
+  /**
+   * @brief フォーマット文字列に従って文字列を整形します。
+   *
+   * @param buffer 整形した文字列を格納するバッファ
+   * @param size バッファのサイズ（null終端文字を含む）
+   * @param format フォーマット文字列
+   * @param ... フォーマットする可変引数
+   * @return バッファに書き込んだ文字数（null終端文字を含まない）
+   *
+   * @note 整形した文字列がバッファに収まらない場合は、途中で切り詰めます。
+   */
+  static size_t format(char *buffer, size_t size, const char *format, ...);
+
+  /**
+   * @brief フォーマット文字列に従って文字列を整形します（va_list版）。
+   *
+   * @param buffer 整形した文字列を格納するバッファ
+   * @param size バッファのサイズ（null終端文字を含む）
+   * @param format フォーマット文字列
+   * @param args フォーマットする可変引数
+   * @return バッファに書き込んだ文字数（null終端文字を含まない）
+   */
+  static size_t vformat(char *buffer, size_t size, const char *format,
+                        va_list args);
+
+  /**
+   * @brief フラッシュメモリ上のフォーマット文字列に従って文字列を整形します。
+   *
+   * フォーマット文字列を `F()` マクロで指定するため、SRAMを消費しません。
+   * `%s` で渡す文字列はSRAM上のものに限ります。
+   *
+   * @param buffer 整形した文字列を格納するバッファ
+   * @param size バッファのサイズ（null終端文字を含む）
+   * @param format フォーマット文字列（フラッシュメモリ上）
+   * @param ... フォーマットする可変引数
+   * @return バッファに書き込んだ文字数（null終端文字を含まない）
+   */
+  static size_t format(char *buffer, size_t size,
+                       const __FlashStringHelper *format, ...);
+
+  /**
+   * @brief フラッシュメモリ上のフォーマット文字列に従って文字列を整形します（va_list版）。
+   *
+   * @param buffer 整形した文字列を格納するバッファ
+   * @param size バッファのサイズ（null終端文字を含む）
+   * @param format フォーマット文字列（フラッシュメモリ上）
+   * @param args フォーマットする可変引数
+   * @return バッファに書き込んだ文字数（null終端文字を含まない）
+   */
+  static size_t vformat(char *buffer, size_t size,
+                        const __FlashStringHelper *format, va_list args);
+};
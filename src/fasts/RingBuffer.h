@@ -0,0 +1,167 @@
+/**
+ * @file RingBuffer.h
+ * @brief 割り込みとメインループの間でデータを受け渡すためのリングバッファ
+ *
+ * `RingBuffer` クラスは、書き込み側（例: 受信割り込み）と読み出し側
+ * （例: メインループ）がそれぞれ1つずつの場合に、割り込み禁止を使わずに
+ * データを受け渡すための固定サイズのリングバッファです。
+ * Arduinoに依存しないため、PC上でもテストできます。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// AVR以外（PC上のテストなど）では、書き込み側と読み出し側が別のスレッドや
+// 別のコアで動くことがあるため、位置の読み書きに std::atomic を使用する
+#if !defined(__AVR__) && defined(__has_include)
+#if __has_include(<atomic>)
+#include <atomic>
+#define RING_BUFFER_USE_ATOMIC
+#endif
+#endif
+
+/**
+ * @class RingBuffer
+ * @brief 書き込み側と読み出し側が1つずつのロックフリーなリングバッファ
+ *
+ * 書き込み位置（head）は書き込み側だけが、読み出し位置（tail）は読み出し側だけが
+ * 更新します。AVRでは1バイトの読み書きは不可分で、シングルコアのため
+ * volatile の読み書きの順序がそのまま他方から見える順序になります。そのため、
+ * 割り込みを禁止せずに安全にデータを受け渡すことができます。
+ * AVR以外では、位置を std::atomic の acquire/release で読み書きし、
+ * 要素を書き込んでから位置を進める順序を、他のスレッドにも保証します。
+ * 満杯と空を区別するため、格納できる要素数は `capacity - 1` です。
+ *
+ * 使用例:
+ * @code
+ * RingBuffer<uint8_t, 64> buffer;
+ * buffer.push(0x12); // 割り込み側
+ * uint8_t data;
+ * if (buffer.pop(data)) { // メインループ側
+ *   // dataを使用する
+ * }
+ * @endcode
+ *
+ * @tparam T 格納する要素の型
+ * @tparam capacity バッファのサイズ（2～128の2のべき乗でなければならない）
+ */
+template <typename T, uint8_t capacity> class RingBuffer {
+  // インデックスの計算をビットマスクで行うため、2のべき乗に制限する
+  static_assert(capacity >= 2 && capacity <= 128 &&
+                    (capacity & (capacity - 1)) == 0,
+                "リングバッファのサイズは2～128の2のべき乗でなければなりません");
+
+public:
+  /**
+   * @brief 要素を1つ書き込みます（書き込み側から呼び出す）
+   *
+   * @param value 書き込む要素
+   * @return 書き込めた場合は true、バッファが満杯の場合は false
+   */
+  bool push(const T &value) {
+    uint8_t current = load(head);
+    uint8_t next = (current + 1) & mask;
+    if (next == load(tail)) {
+      return false; // バッファが満杯
+    }
+    buffer[current] = value;
+    // 要素を書き込んでから書き込み位置を進める（読み出し側に公開する）
+    store(head, next);
+    return true;
+  }
+
+  /**
+   * @brief 複数の要素をまとめて書き込みます（書き込み側から呼び出す）
+   *
+   * 空きがある分だけ要素を書き込み、最後に一度だけ書き込み位置を進めます。
+   * そのため、読み出し側からは書き込んだ要素がまとめて見えるようになります。
+   *
+   * @param values 書き込む要素の配列
+   * @param count 書き込む要素の数
+   * @return 実際に書き込めた要素の数
+   */
+  uint8_t push(const T *values, uint8_t count) {
+    uint8_t current = load(head);
+    uint8_t free = (load(tail) - current - 1) & mask;
+    if (count > free) {
+      count = free;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      buffer[current] = values[i];
+      current = (current + 1) & mask;
+    }
+    // すべての要素を書き込んでから書き込み位置を進める
+    store(head, current);
+    return count;
+  }
+
+  /**
+   * @brief 要素を1つ読み出します（読み出し側から呼び出す）
+   *
+   * @param value 読み出した要素を格納する変数
+   * @return 読み出せた場合は true、バッファが空の場合は false
+   */
+  bool pop(T &value) {
+    uint8_t current = load(tail);
+    if (current == load(head)) {
+      return false; // バッファが空
+    }
+    value = buffer[current];
+    // 要素を読み出してから読み出し位置を進める（書き込み側に公開する）
+    store(tail, (current + 1) & mask);
+    return true;
+  }
+
+  /**
+   * @brief 格納されている要素の数を取得します
+   * @return 格納されている要素の数
+   */
+  uint8_t size() const { return (load(head) - load(tail)) & mask; }
+
+  /**
+   * @brief 書き込める要素の数を取得します
+   * @return 書き込める要素の数
+   */
+  uint8_t space() const { return mask - size(); }
+
+  /**
+   * @brief バッファが空かどうかを判定します
+   * @return 空の場合は true
+   */
+  bool empty() const { return load(head) == load(tail); }
+
+private:
+#if defined(RING_BUFFER_USE_ATOMIC)
+  /// 読み書きの位置の型
+  typedef std::atomic<uint8_t> Index;
+
+  /// 位置を読み出す（相手が公開した要素の読み書きより後に順序付ける）
+  static uint8_t load(const Index &index) {
+    return index.load(std::memory_order_acquire);
+  }
+
+  /// 位置を書き込む（それまでの要素の読み書きを相手に公開する）
+  static void store(Index &index, uint8_t value) {
+    index.store(value, std::memory_order_release);
+  }
+#else
+  /// 読み書きの位置の型（AVRでは1バイトの読み書きは不可分）
+  typedef volatile uint8_t Index;
+
+  /// 位置を読み出す
+  static uint8_t load(const Index &index) { return index; }
+
+  /// 位置を書き込む
+  static void store(Index &index, uint8_t value) { index = value; }
+#endif
+
+  /// インデックスを折り返すためのビットマスク
+  static const uint8_t mask = capacity - 1;
+  /// 要素を格納する配列（割り込みをまたいで読み書きされるためvolatile）
+  volatile T buffer[capacity];
+  /// 次に書き込む位置（書き込み側だけが更新する）
+  Index head{0};
+  /// 次に読み出す位置（読み出し側だけが更新する）
+  Index tail{0};
+};
@@ -15,21 +15,51 @@
 // デバッグメッセージをシリアルポートに出力するためのクラス
 #include "DebugLogger.h"
 
+// ログをバイナリ形式で記録し、後でまとめて出力するためのクラス
+#include "DeferredDebugLogger.h"
+
 // さまざまなデータ型の変換を行うためのユーティリティクラス
 #include "fasts/Converter.h"
 
+// コンペアレジスタに直接書き込むPWM出力のクラス（周波数の変更に対応）
+#include "fasts/FastPwm.h"
+
 // ボタンの状態を管理するためのクラス
 #include "parts/Button.h"
 
+// 複数のボタンのチャタリングをまとめて取り除くためのクラス
+#include "parts/ButtonGroup.h"
+
+// ボタンの長押しやダブルクリックを検出するためのクラス
+#include "parts/ButtonGestures.h"
+
 // IM920SLモジュールを制御するためのクラス
 #include "parts/IM920SL.h"
 
 // 単一のLEDを制御するためのクラス
 #include "parts/Led.h"
 
+// 複数のLEDを点滅パターンで光らせるためのクラス
+#include "parts/LedPatterns.h"
+
+// ロータリーエンコーダーの回転を数えるためのクラス
+#include "parts/QuadratureEncoder.h"
+
 // 複数のLEDをテープ状に制御するためのクラス
 #include "parts/LedTape.h"
 
+// LEDテープの光り方を1フレームずつ描画するためのクラス
+#include "parts/ledtapes/LedTapeEffects.h"
+
+// FastLEDを使用せずにWS2812Bへ出力するためのクラス（ガンマ補正に対応）
+#include "parts/ledtapes/Ws2812Output.h"
+
+// LEDの色をパレットの番号で保持し、SRAMを節約するためのクラス
+#include "parts/ledtapes/PaletteFrameBuffer.h"
+
+// フラッシュメモリに格納した光り方を再生するためのクラス
+#include "parts/ledtapes/LedTapePlayer.h"
+
 // コントローラーデータを管理するためのクラス
 #include "parts/controllers/ControllerData.h"
 
@@ -42,5 +72,17 @@
 // 速度調整が可能なモーターを制御するためのクラス（TB67H450ドライバ使用）
 #include "parts/motors/speed/TB67H450.h"
 
+// 複数のモーターの出力をまとめて書き込むためのクラス
+#include "parts/motors/speed/MotorGroup.h"
+
+// モーターの速度を少しずつ変化させるためのクラス
+#include "parts/motors/speed/SpeedRamp.h"
+
+// エンコーダーの値を使用してモーターの回転速度を一定に保つためのクラス
+#include "parts/motors/speed/SpeedPid.h"
+
+// コントローラーの入力でモーターを制御するための関数
+#include "parts/motors/speed/ControllerDrive.h"
+
 // Null型を定義するヘッダーファイル
 #include "types/NullType.h"
\ No newline at end of file
@@ -10,6 +10,8 @@
  *
  * このクラスは、指定されたピンに接続されたボタンの状態を管理します。
  * ボタンが押されたかどうかを判定するためのメソッドを提供します。
+ * チャタリングを取り除いたり、押された瞬間を検出したりする場合は
+ * `ButtonGroup` を使用してください。
  */
 class Button {
 public:
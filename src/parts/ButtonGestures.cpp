@@ -0,0 +1,112 @@
+#include "ButtonGestures.h"
+
+// 判定に使用する時間を設定するメソッド
+void ButtonGestures::setTimings(uint16_t longPressMs, uint16_t repeatMs,
+                                uint16_t doubleClickMs) {
+  this->longPressMs = longPressMs > 0 ? longPressMs : 1;
+  this->repeatMs = repeatMs > 0 ? repeatMs : 1;
+  this->doubleClickMs = doubleClickMs;
+}
+
+// ButtonGroup の状態から操作を検出するメソッド
+void ButtonGestures::update(const ButtonGroup &buttons, uint16_t now) {
+  uint8_t pressed = buttons.pressedBits();
+  uint8_t released = buttons.releasedBits();
+  for (uint8_t i = 0; i < buttons.size(); i++) {
+    uint8_t bit = 1 << i;
+    if (pressed & bit) {
+      handleEdge(i, true, now);
+    } else if (released & bit) {
+      handleEdge(i, false, now);
+    }
+  }
+  tick(now);
+}
+
+// ボタンが押された、または離されたことを通知するメソッド
+void ButtonGestures::handleEdge(uint8_t button, bool pressed, uint16_t now) {
+  if (button >= MAX_BUTTONS) {
+    return;
+  }
+  uint8_t &flag = flags[button];
+
+  if (pressed) {
+    if ((flag & HELD) != 0) {
+      return;
+    }
+    push(button, ButtonEventType::PRESS);
+    if ((flag & CLICKED) != 0 &&
+        static_cast<uint16_t>(now - marks[button]) <= doubleClickMs) {
+      push(button, ButtonEventType::DOUBLE_CLICK);
+      flag = HELD | DOUBLED;
+    } else {
+      flag = HELD;
+    }
+    marks[button] = now;
+    return;
+  }
+
+  if ((flag & HELD) == 0) {
+    return;
+  }
+  push(button, ButtonEventType::RELEASE);
+  // 短く押して離した場合だけ、ダブルクリックの1回目として記録する
+  flag = (flag & (LONG_SENT | DOUBLED)) == 0 ? CLICKED : 0;
+  marks[button] = now;
+}
+
+// 押し続けているボタンの長押しと連続入力を検出するメソッド
+void ButtonGestures::tick(uint16_t now) {
+  for (uint8_t i = 0; i < MAX_BUTTONS; i++) {
+    uint8_t &flag = flags[i];
+    if (flag == 0) {
+      continue;
+    }
+    uint16_t elapsed = now - marks[i];
+
+    if ((flag & HELD) == 0) {
+      // ダブルクリックの待ち時間を過ぎたら、1回目の記録を消す
+      // （時刻が一周した後に誤って判定しないようにする）
+      if (elapsed > doubleClickMs) {
+        flag = 0;
+      }
+    } else if ((flag & LONG_SENT) == 0) {
+      if (elapsed >= longPressMs) {
+        push(i, ButtonEventType::LONG_PRESS);
+        flag |= LONG_SENT;
+        // 連続入力の基準は、tick() の呼び出しの遅れを含めない
+        marks[i] += longPressMs;
+      }
+    } else if (elapsed >= repeatMs) {
+      push(i, ButtonEventType::REPEAT);
+      if (elapsed - repeatMs >= repeatMs) {
+        // 1周期以上遅れた場合は、遅れた分をまとめて送らずに基準を合わせ直す
+        marks[i] = now;
+      } else {
+        marks[i] += repeatMs;
+      }
+    }
+  }
+}
+
+// キューから操作を1つ取り出すメソッド
+bool ButtonGestures::poll(ButtonEvent &event) {
+  if (count == 0) {
+    return false;
+  }
+  event = queue[head];
+  head = (head + 1) % QUEUE_SIZE;
+  count--;
+  return true;
+}
+
+// キューに操作を追加する
+void ButtonGestures::push(uint8_t button, ButtonEventType type) {
+  if (count >= QUEUE_SIZE) {
+    return;
+  }
+  ButtonEvent &event = queue[(head + count) % QUEUE_SIZE];
+  event.button = button;
+  event.type = type;
+  count++;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file ButtonGestures.h
+ * @brief ボタンの長押し・ダブルクリック・連続入力を検出するクラス定義
+ *
+ * このファイルには、ボタンが押された瞬間と離された瞬間から、長押しや
+ * ダブルクリックなどの操作を検出する `ButtonGestures` クラスが定義されています。
+ * `delay()` で待たずに、呼び出し元が渡した時刻だけで判定します。
+ */
+
+#pragma once
+
+#include "ButtonGroup.h"
+#include <stdint.h>
+
+/**
+ * @brief ボタンの操作の種類
+ */
+enum class ButtonEventType : uint8_t {
+  PRESS,        ///< 押された
+  RELEASE,      ///< 離された
+  LONG_PRESS,   ///< 長押しされた（押している間に1回）
+  DOUBLE_CLICK, ///< ダブルクリックされた（2回目に押されたとき）
+  REPEAT        ///< 長押しの後、押し続けている間に一定の間隔で発生する
+};
+
+/**
+ * @brief ボタンの操作
+ */
+struct ButtonEvent {
+  uint8_t button;       ///< ボタンの番号
+  ButtonEventType type; ///< 操作の種類
+};
+
+/**
+ * @class ButtonGestures
+ * @brief ボタンの操作を検出し、固定長のキューに入れるクラス
+ *
+ * `update()` に `ButtonGroup` と現在の時刻（ミリ秒）を渡すと、検出した操作を
+ * キューに追加します。`poll()` でキューから1つずつ取り出します。
+ * 動的なメモリ確保は行いません。キューが一杯のときに検出した操作は捨てられます。
+ *
+ * 時刻は16ビットで扱うため、各操作の時間は65秒未満である必要があります。
+ *
+ * 使用例:
+ * @code
+ * ButtonGroup buttons;
+ * ButtonGestures gestures;
+ *
+ * void loop() {
+ *   static unsigned long last = 0;
+ *   if (millis() - last >= 5) {
+ *     last += 5;
+ *     buttons.update();
+ *     gestures.update(buttons, millis());
+ *   }
+ *   ButtonEvent event;
+ *   while (gestures.poll(event)) {
+ *     if (event.type == ButtonEventType::LONG_PRESS) {
+ *       // 長押しされたボタン: event.button
+ *     }
+ *   }
+ * }
+ * @endcode
+ */
+class ButtonGestures {
+public:
+  /// 操作を検出できるボタンの最大数
+  static const uint8_t MAX_BUTTONS = ButtonGroup::MAX_BUTTONS;
+
+  /// キューに入れられる操作の最大数
+  static const uint8_t QUEUE_SIZE = 8;
+
+  /**
+   * @brief 判定に使用する時間を設定するメソッド
+   *
+   * `longPressMs` と `repeatMs` は、0を指定すると1として扱います
+   * （0では `tick()` のたびに連続入力を送ってしまうため）。
+   *
+   * @param longPressMs 長押しと判定するまでの時間（ミリ秒、デフォルトは800）
+   * @param repeatMs 連続入力の間隔（ミリ秒、デフォルトは200）
+   * @param doubleClickMs ダブルクリックと判定する、離してから次に押すまでの時間
+   *                      （ミリ秒、デフォルトは300）
+   */
+  void setTimings(uint16_t longPressMs, uint16_t repeatMs,
+                  uint16_t doubleClickMs);
+
+  /**
+   * @brief `ButtonGroup` の状態から操作を検出するメソッド
+   *
+   * `ButtonGroup::update()` を呼び出すたびに呼び出します。
+   *
+   * @param buttons ボタンの状態
+   * @param now 現在の時刻（ミリ秒、`millis()` の値など）
+   */
+  void update(const ButtonGroup &buttons, uint16_t now);
+
+  /**
+   * @brief ボタンが押された、または離されたことを通知するメソッド
+   *
+   * `ButtonGroup` を使用しない場合に、`tick()` と組み合わせて使用します。
+   *
+   * @param button ボタンの番号
+   * @param pressed 押された場合は true、離された場合は false
+   * @param now 現在の時刻（ミリ秒）
+   */
+  void handleEdge(uint8_t button, bool pressed, uint16_t now);
+
+  /**
+   * @brief 押し続けているボタンの長押しと連続入力を検出するメソッド
+   *
+   * 連続入力は、呼び出しの間隔に関わらず、長押しの判定から `repeatMs` ごとの時刻を
+   * 基準に送ります（呼び出しの遅れが積み重なりません）。
+   *
+   * @param now 現在の時刻（ミリ秒）
+   */
+  void tick(uint16_t now);
+
+  /**
+   * @brief キューから操作を1つ取り出すメソッド
+   *
+   * @param event 取り出した操作を格納する変数
+   * @return 取り出せた場合は true（キューが空の場合は false）
+   */
+  bool poll(ButtonEvent &event);
+
+  /**
+   * @brief キューに入っている操作の数を取得するメソッド
+   *
+   * @return 操作の数
+   */
+  uint8_t available() const { return count; }
+
+private:
+  /// ボタンごとの状態を表すビット
+  enum : uint8_t {
+    HELD = 0x01,      ///< 押されている
+    LONG_SENT = 0x02, ///< 長押しを通知した
+    CLICKED = 0x04,   ///< 短く押して離した（ダブルクリックの1回目）
+    DOUBLED = 0x08    ///< ダブルクリックを通知した（続けて押しても数えない）
+  };
+
+  uint16_t longPressMs = 800;       /**< 長押しと判定するまでの時間 */
+  uint16_t repeatMs = 200;          /**< 連続入力の間隔 */
+  uint16_t doubleClickMs = 300;     /**< ダブルクリックと判定する時間 */
+  uint16_t marks[MAX_BUTTONS] = {}; /**< 判定の基準となる時刻 */
+  uint8_t flags[MAX_BUTTONS] = {};  /**< ボタンごとの状態 */
+  ButtonEvent queue[QUEUE_SIZE];    /**< 操作のキュー */
+  uint8_t head = 0;                 /**< 次に取り出す位置 */
+  uint8_t count = 0;                /**< キューに入っている操作の数 */
+
+  /**
+   * @brief キューに操作を追加する
+   *
+   * @param button ボタンの番号
+   * @param type 操作の種類
+   */
+  void push(uint8_t button, ButtonEventType type);
+};
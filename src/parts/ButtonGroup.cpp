@@ -0,0 +1,60 @@
+#include "ButtonGroup.h"
+
+volatile uint8_t ButtonGroup::noInput = 0xFF;
+
+// ボタンを追加するメソッド
+uint8_t ButtonGroup::add(uint8_t pin) {
+  uint8_t pinPort = digitalPinToPort(pin);
+  if (numButtons >= MAX_BUTTONS || pinPort == NOT_A_PIN ||
+      (numButtons > 0 && pinPort != port)) {
+    return INVALID_INDEX;
+  }
+  if (numButtons == 0) {
+    port = pinPort;
+    inputRegister = portInputRegister(port);
+  }
+
+  pinMode(pin, INPUT_PULLUP);
+
+  uint8_t index = numButtons;
+  masks[index] = digitalPinToBitMask(pin);
+  pinMask |= masks[index];
+  numButtons++;
+  return index;
+}
+
+// ポートの状態から、全てのボタンの状態を更新するメソッド
+// 確定した状態と異なるビットだけカウンタを 3 -> 2 -> 1 -> 0 -> 3 と進め、
+// 3に戻ったとき（4回続けて異なったとき）に状態を反転させる
+void ButtonGroup::update(uint8_t portState) {
+  uint8_t sample = ~portState & pinMask; // 押されている（LOW）ビットを1にする
+  uint8_t differ = state ^ sample;
+  count0 = ~(count0 & differ);
+  count1 = count0 ^ (count1 & differ);
+  changed = differ & count0 & count1;
+  state ^= changed;
+}
+
+// 押されているボタンをビットで取得するメソッド
+uint8_t ButtonGroup::stateBits() const { return toIndexBits(state); }
+
+// 前回の update() で押されたボタンをビットで取得するメソッド
+uint8_t ButtonGroup::pressedBits() const {
+  return toIndexBits(changed & state);
+}
+
+// 前回の update() で離されたボタンをビットで取得するメソッド
+uint8_t ButtonGroup::releasedBits() const {
+  return toIndexBits(changed & ~state);
+}
+
+// ポートのビットを、ボタンの番号のビットに並べ替える
+uint8_t ButtonGroup::toIndexBits(uint8_t bits) const {
+  uint8_t result = 0;
+  for (uint8_t i = 0; i < numButtons; i++) {
+    if (bits & masks[i]) {
+      result |= 1 << i;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file ButtonGroup.h
+ * @brief 同じポートに接続した複数のボタンのチャタリングを取り除くクラス定義
+ *
+ * このファイルには、ボタンの状態からチャタリング（接点の跳ね返り）を取り除き、
+ * 押された瞬間と離された瞬間を検出する `ButtonGroup` クラスが定義されています。
+ * `Button::isPressed()` はピンの状態をそのまま返すため、押した瞬間に
+ * 何度も押されたように見えることがあります。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @class ButtonGroup
+ * @brief 同じポートに接続した最大8個のボタンのチャタリングをまとめて取り除くクラス
+ *
+ * `update()` を一定の周期（5ms程度）で呼び出します。1回の呼び出しでポートを
+ * 1回だけ読み込み、8個のボタンを8ビットの縦方向カウンタ（各ボタンの2ビットの
+ * カウンタを2つのバイトのビットに分けて持つ方式）でまとめて処理します。
+ * 同じ状態が `STABLE_SAMPLES` 回続いたときに状態を確定するため、
+ * ボタンの数によらず処理時間は一定です。
+ *
+ * ボタンはピンとGNDの間に接続し、押されているとLOWになるものとします。
+ *
+ * 使用例:
+ * @code
+ * ButtonGroup buttons;
+ * uint8_t start, stop;
+ *
+ * void setup() {
+ *   start = buttons.add(8); // ポートB
+ *   stop = buttons.add(9);  // ポートB
+ * }
+ *
+ * void loop() {
+ *   static unsigned long last = 0;
+ *   if (millis() - last >= 5) {
+ *     last += 5;
+ *     buttons.update();
+ *     if (buttons.wasPressed(start)) {
+ *       // 押された瞬間に1回だけ実行される
+ *     }
+ *   }
+ * }
+ * @endcode
+ */
+class ButtonGroup {
+public:
+  /// 1つのポートに接続できるボタンの最大数
+  static const uint8_t MAX_BUTTONS = 8;
+
+  /// 状態を確定するまでに同じ状態が続く必要がある `update()` の回数
+  static const uint8_t STABLE_SAMPLES = 4;
+
+  /// `add()` が失敗した場合の戻り値
+  static const uint8_t INVALID_INDEX = 0xFF;
+
+  /**
+   * @brief ボタンを追加するメソッド
+   *
+   * ピンを内部プルアップ抵抗付きの入力モードに設定します。
+   * 全てのボタンは同じポートに接続する必要があります。
+   *
+   * @param pin ボタンが接続されているピン番号
+   * @return ボタンの番号（追加できない場合は `INVALID_INDEX`）
+   */
+  uint8_t add(uint8_t pin);
+
+  /**
+   * @brief ポートを読み込み、全てのボタンの状態を更新するメソッド
+   */
+  void update() { update(*inputRegister); }
+
+  /**
+   * @brief ポートの状態から、全てのボタンの状態を更新するメソッド
+   *
+   * @param portState ポートの入力レジスタ（PINx）の値
+   */
+  void update(uint8_t portState);
+
+  /**
+   * @brief ボタンが押されているかどうかを取得するメソッド
+   *
+   * @param index ボタンの番号
+   * @return チャタリングを取り除いた状態で押されている場合は true
+   */
+  bool isPressed(uint8_t index) const { return hasBit(state, index); }
+
+  /**
+   * @brief 前回の `update()` でボタンが押されたかどうかを取得するメソッド
+   *
+   * @param index ボタンの番号
+   * @return 押された瞬間の場合は true
+   */
+  bool wasPressed(uint8_t index) const {
+    return hasBit(changed & state, index);
+  }
+
+  /**
+   * @brief 前回の `update()` でボタンが離されたかどうかを取得するメソッド
+   *
+   * @param index ボタンの番号
+   * @return 離された瞬間の場合は true
+   */
+  bool wasReleased(uint8_t index) const {
+    return hasBit(changed & ~state, index);
+  }
+
+  /**
+   * @brief 押されているボタンをビットで取得するメソッド
+   *
+   * @return ボタンの番号のビットが1のとき押されている
+   */
+  uint8_t stateBits() const;
+
+  /**
+   * @brief 前回の `update()` で押されたボタンをビットで取得するメソッド
+   *
+   * @return ボタンの番号のビットが1のとき押された
+   */
+  uint8_t pressedBits() const;
+
+  /**
+   * @brief 前回の `update()` で離されたボタンをビットで取得するメソッド
+   *
+   * @return ボタンの番号のビットが1のとき離された
+   */
+  uint8_t releasedBits() const;
+
+  /**
+   * @brief 追加したボタンの数を取得するメソッド
+   *
+   * @return ボタンの数
+   */
+  uint8_t size() const { return numButtons; }
+
+private:
+  /// ピンの状態を読み込まない場合の入力レジスタ
+  static volatile uint8_t noInput;
+
+  volatile uint8_t *inputRegister = &noInput; /**< ポートの入力レジスタ */
+  uint8_t port = NOT_A_PIN;                   /**< ポートの番号 */
+  uint8_t pinMask = 0;                        /**< ボタンのピンのビット */
+  uint8_t numButtons = 0;                     /**< ボタンの数 */
+  uint8_t masks[MAX_BUTTONS] = {};            /**< 各ボタンのピンのビット */
+  uint8_t state = 0;     /**< 確定した状態（ポートのビット、1が押されている） */
+  uint8_t changed = 0;   /**< 前回の `update()` で状態が変わったビット */
+  uint8_t count0 = 0xFF; /**< 縦方向カウンタの0ビット目 */
+  uint8_t count1 = 0xFF; /**< 縦方向カウンタの1ビット目 */
+
+  /**
+   * @brief ポートのビットのうち、ボタンのピンのビットが1かどうかを調べる
+   *
+   * @param bits ポートのビット
+   * @param index ボタンの番号
+   * @return ボタンのピンのビットが1の場合は true
+   */
+  bool hasBit(uint8_t bits, uint8_t index) const {
+    return index < MAX_BUTTONS && (bits & masks[index]) != 0;
+  }
+
+  /**
+   * @brief ポートのビットを、ボタンの番号のビットに並べ替える
+   *
+   * @param bits ポートのビット
+   * @return ボタンの番号のビット
+   */
+  uint8_t toIndexBits(uint8_t bits) const;
+};
@@ -15,7 +15,9 @@
 #include <DebugLogger.h>
 #include <MsTimer2.h>
 #include <fasts/Converter.h>
+#include <types/HasBulkWrite.h>
 #include <types/IsSame.h>
+#include <types/TxBufferCapacity.h>
 
 // 送信モードを定義する列挙型
 /**
@@ -44,6 +46,20 @@ enum class ImReceiveMode : uint8_t {
   NO_WAIT_FOR_SERIAL_DATA, ///< バッファが空の場合は即座に終了
 };
 
+// 逐次受信の結果を定義する列挙型
+/**
+ * @enum ImPollResult
+ * @brief `IM920SL::poll` の戻り値を示す列挙型
+ *
+ * 受信バッファにあるデータを読み込んだ結果、フレームの受信が完了したかどうかを示します。
+ * フレームが未完成の場合は、次回の呼び出しで続きから読み込みます。
+ */
+enum class ImPollResult : uint8_t {
+  NEED_MORE,   ///< フレームが未完成（次回の呼び出しで続きを読み込む）
+  FRAME_READY, ///< フレームの受信が完了し、データが格納された
+  ERROR        ///< 不正なフレームを受信した（16進数以外の文字、長さの不一致）
+};
+
 /**
  * @brief IM920SLクラス
  *
@@ -68,7 +84,7 @@ public:
   IM920SL(SerialType &serial, LoggerType *logger = nullptr)
       : serial(serial), logger(logger) {
     // シリアル通信とロガーの型が同じでないことを確認するためのチェック
-    static_assert(!IsSame<DebugLogger<SerialType>, LoggerType>::value,
+    static_assert(!IsDebugLoggerOf<LoggerType, SerialType>::value,
                   "シリアル通信とロガーが競合しています");
   }
 
@@ -88,6 +104,9 @@ public:
    * 指定した時間（間隔）の間にデータが受信されなかった場合に呼び出される
    * コールバック関数を登録します。
    *
+   * @note MsTimer2（Timer2）を使用するため、ピン3、11のPWM出力（`analogWrite()` や
+   *       `FastPwm`）は使用できなくなります。モーターのPWMにはピン9、10などを使用してください。
+   *
    * @param callback コールバック関数のポインタ
    * @param interval
    * データ受信が確認されなかった場合にタイマーが発火する間隔（ミリ秒単位、デフォルトは1000ms）
@@ -127,19 +146,23 @@ public:
                   "送信するデータのサイズは1～32バイトでなければなりません");
 
     // ログに送信開始のメッセージを出力
-    printLog(DebugLoggerLevel::INFO, "send", "Sending data");
+    printLog<DebugLoggerLevel::INFO>(F("send"), F("Sending data"));
 
-    // 送信データのサイズを計算（シリアル通信の仕様に基づく）
-    constexpr uint8_t size = 5 + (sizeof(T) * 2);
+    // 送信データのサイズを計算（"TXDA " + 16進数文字 + 改行）
+    constexpr uint8_t size = 5 + (sizeof(T) * 2) + 2;
+    // 送信バッファより大きいフレームは、バッファが空になれば送信を始める
+    // （入りきらない分は write() がバッファの空きを待って書き込む）
+    constexpr uint8_t capacity = TxBufferCapacity<SerialType>::value;
+    constexpr uint8_t required = size < capacity ? size : capacity;
 
     // 指定された送信モードに従い、バッファやキャリアセンスの状態を確認
     if (waitmode == ImSendMode::EXIT_WHEN_BUFFER_FULL) {
       // バッファが空になるまで待機しない
-      if (static_cast<uint8_t>(serial.availableForWrite()) < size)
+      if (static_cast<uint8_t>(serial.availableForWrite()) < required)
         return;
     } else if (waitmode == ImSendMode::WAIT_FOR_BUFFER_AVAILABLE) {
       // バッファが空になるまで待機
-      while (static_cast<uint8_t>(serial.availableForWrite()) < size)
+      while (static_cast<uint8_t>(serial.availableForWrite()) < required)
         ;
     } else if (waitmode == ImSendMode::USE_CARRIER_SENSE) {
       // キャリアセンスを考慮して送信
@@ -147,14 +170,10 @@ public:
     }
 
     // データを送信
-    serial.print("TXDA ");
-    char hex[sizeof(T) * 2 + 1];
-    Converter::toHex(reinterpret_cast<const uint8_t *>(&data), sizeof(T), hex);
-    hex[sizeof(T) * 2] = '\0';
-    serial.println(hex);
+    writeFrame<sizeof(T)>(reinterpret_cast<const uint8_t *>(&data));
 
     // ログに送信完了のメッセージを出力
-    printLog(DebugLoggerLevel::INFO, "send", "Data sent");
+    printLog<DebugLoggerLevel::INFO>(F("send"), F("Data sent"));
   }
 
   /**
@@ -173,101 +192,267 @@ public:
                   "受信するデータのサイズは1～32バイトでなければなりません");
 
     // ログに受信開始のメッセージを出力
-    printLog(DebugLoggerLevel::INFO, "receive", "Receiving data");
+    printLog<DebugLoggerLevel::INFO>(F("receive"), F("Receiving data"));
+
+    // 受信したデータを書き込むバッファ（nullptrの場合は読み捨てる）
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(data);
+
+    // poll()で途中まで受信したフレームは破棄し、コロンから探し直す
+    parseState = ParseState::SEEK_COLON;
 
     // コロン（:）以前のデータを読み捨てる処理
-    printLog(DebugLoggerLevel::INFO, "receive", "Reading data before colon");
-    while (true) {
+    printLog<DebugLoggerLevel::INFO>(F("receive"),
+                                     F("Reading data before colon"));
+    while (parseState == ParseState::SEEK_COLON) {
       if (serial.available()) {
-        printLogf(DebugLoggerLevel::INFO, "receive", "Available data: %d",
-                  serial.available());
-        if (serial.read() == ':') {
-          printLog(DebugLoggerLevel::INFO, "receive", "Colon found");
-          break;
-        }
+        printLogf<DebugLoggerLevel::INFO>(F("receive"),
+                                          F("Available data: %d"),
+                                          serial.available());
+        parse(serial.read(), bytes, sizeof(T));
       } else {
         if (mode == ImReceiveMode::WAIT_FOR_SERIAL_DATA) {
-          printLog(DebugLoggerLevel::INFO, "receive",
-                   "Waiting for serial data");
+          printLog<DebugLoggerLevel::INFO>(F("receive"),
+                                           F("Waiting for serial data"));
           while (!serial.available())
             ;
         } else if (mode == ImReceiveMode::NO_WAIT_FOR_SERIAL_DATA) {
-          printLog(DebugLoggerLevel::ERROR, "receive", "No data available");
+          printLog<DebugLoggerLevel::ERROR>(F("receive"),
+                                            F("No data available"));
           return;
         }
       }
     }
+    printLog<DebugLoggerLevel::INFO>(F("receive"), F("Colon found"));
 
-    // コロンが受信されなかった時に呼び出される関数が登録されている場合、タイマーをリスタート
-    if (onColonNotReceived) {
-      MsTimer2::start();
-    }
-
-    // コロンが受信された時に呼び出される関数が登録されている場合、呼び出す
-    if (onColonReceived) {
-      onColonReceived();
-    }
-
-    // コロン以降のデータを読み込む
-    printLog(DebugLoggerLevel::INFO, "receive", "Reading data after colon");
-    static char afterColon[256]; // 大きいので念のためstatic
-    for (uint8_t index = 0; index < sizeof(afterColon); index++) {
-      printLog(DebugLoggerLevel::INFO, "receive", "Reading data");
+    // コロン以降のデータを読み込み、届いた順に16進数からdataへ直接変換する
+    printLog<DebugLoggerLevel::INFO>(F("receive"),
+                                     F("Reading data after colon"));
+    ImPollResult result;
+    do {
       while (!serial.available())
         ;
-      char c = serial.read();
-      if (c == '\r') {
-        printLog(DebugLoggerLevel::INFO, "receive", "Carriage return found");
-        while (!serial.available())
-          ;
-        serial.read();
-        afterColon[index] = '\0';
-        break;
-      }
-      afterColon[index] = c;
-    }
+      result = parse(serial.read(), bytes, sizeof(T));
+    } while (result == ImPollResult::NEED_MORE);
 
-    // dataがnullptrの場合は、受信データを読み捨てる
+    // 改行（\r）の後の\nを読み捨てる
+    printLog<DebugLoggerLevel::INFO>(F("receive"), F("Carriage return found"));
+    while (!serial.available())
+      ;
+    serial.read();
+
+    // dataがnullptrの場合は、受信データを読み捨てている
     if (!data) {
-      printLog(DebugLoggerLevel::WARN, "receive", "Data is null");
+      printLog<DebugLoggerLevel::WARN>(F("receive"), F("Data is null"));
       return;
     }
 
-    // 受信データの変換処理
-    printLog(DebugLoggerLevel::INFO, "receive", "Converting data");
-    char *pos = afterColon;
-    for (size_t i = 0; i < sizeof(T); i++) {
-      Converter::fromHex(pos, 2, reinterpret_cast<uint8_t *>(data) + i);
-      pos += 2;
-      if (*pos == ',') {
-        pos++;
-      }
+    // 受信データの長さや文字が不正な場合
+    if (result == ImPollResult::ERROR) {
+      printLog<DebugLoggerLevel::WARN>(F("receive"), F("Invalid frame"));
+      return;
     }
 
     // ログに受信完了のメッセージを出力
-    printLog(DebugLoggerLevel::INFO, "receive", "Data received");
+    printLog<DebugLoggerLevel::INFO>(F("receive"), F("Data received"));
+  }
+
+  /**
+   * @brief データを待機せずに受信するテンプレート関数
+   *
+   * シリアルバッファにあるデータだけを読み込み、すぐに戻ります。
+   * フレームの途中でバッファが空になった場合は、読み込んだ位置を保持し、
+   * 次回の呼び出しで続きから読み込みます。そのため、loop()
+   * から毎回呼び出しても処理が止まりません。
+   *
+   * 受信したデータは16進数文字が届くたびに `data` に書き込まれます。
+   * `ImPollResult::FRAME_READY` が返るまでは `data` の内容を使用しないでください。
+   *
+   * 使用例:
+   * @code
+   * int data;
+   * if (im.poll(&data) == ImPollResult::FRAME_READY) {
+   *   // dataを使用する
+   * }
+   * @endcode
+   *
+   * @tparam T 受信するデータの型
+   * @param data 受信したデータを格納する変数（nullptrの場合は読み捨てる）
+   * @return 受信の結果（ImPollResult）
+   */
+  template <typename T> ImPollResult poll(T *data) {
+    // 受信するデータのサイズが1バイト以上32バイト以下であることを確認
+    static_assert(sizeof(T) >= 1 && sizeof(T) <= 32,
+                  "受信するデータのサイズは1～32バイトでなければなりません");
+
+    // バッファにあるデータだけを読み込む
+    while (serial.available()) {
+      ImPollResult result =
+          parse(serial.read(), reinterpret_cast<uint8_t *>(data), sizeof(T));
+      if (result == ImPollResult::FRAME_READY) {
+        printLog<DebugLoggerLevel::INFO>(F("poll"), F("Data received"));
+        return result;
+      }
+      if (result == ImPollResult::ERROR) {
+        printLog<DebugLoggerLevel::ERROR>(F("poll"), F("Invalid frame"));
+        return result;
+      }
+    }
+    return ImPollResult::NEED_MORE;
   }
 
 private:
+  /**
+   * @brief 逐次受信の状態を示す列挙型
+   */
+  enum class ParseState : uint8_t {
+    SEEK_COLON,     ///< コロン（:）を探している
+    PAYLOAD,        ///< コロン以降のデータを読み込んでいる
+    INVALID_PAYLOAD ///< 不正なデータを受信したため、改行まで読み捨てている
+  };
+
   SerialType &serial;                     ///< シリアル通信オブジェクトの参照
   LoggerType *logger;                     ///< ロガーオブジェクトへのポインタ
   void (*onColonNotReceived)() = nullptr; ///< コロン未受信時のコールバック
   void (*onColonReceived)() = nullptr;    ///< コロン受信時のコールバック
+  ParseState parseState = ParseState::SEEK_COLON; ///< 逐次受信の状態
+  uint8_t parsedNibbles = 0; ///< コロン以降に受信した16進数文字の数
+
+  /**
+   * @brief 送信フレームをシリアルポートに書き込むヘルパー関数
+   *
+   * "TXDA " + 16進数文字 + 改行（\r\n）を、文字列の長さを調べずに書き込みます。
+   * `SerialType` が一括書き込み（`write(const uint8_t *, size_t)`）
+   * に対応している場合はフレーム全体を組み立てて1回で書き込み、
+   * 対応していない場合は1文字ずつ `write` で書き込みます。
+   * どちらを使用するかはコンパイル時に決定されます。
+   *
+   * @tparam size 送信するデータのサイズ（バイト数）
+   * @param bytes 送信するデータ
+   */
+  template <uint8_t size> void writeFrame(const uint8_t *bytes) {
+    if constexpr (HasBulkWrite<SerialType>::value) {
+      // フレーム全体を組み立てて一括で書き込む
+      uint8_t frame[5 + size * 2 + 2] = {'T', 'X', 'D', 'A', ' '};
+      Converter::toHex(bytes, size, reinterpret_cast<char *>(frame) + 5);
+      frame[sizeof(frame) - 2] = '\r';
+      frame[sizeof(frame) - 1] = '\n';
+      serial.write(frame, sizeof(frame));
+    } else {
+      // 1文字ずつ書き込む（バッファは1バイト分の16進数文字のみ）
+      serial.write('T');
+      serial.write('X');
+      serial.write('D');
+      serial.write('A');
+      serial.write(' ');
+      for (uint8_t i = 0; i < size; i++) {
+        char hex[2];
+        Converter::toHex(bytes + i, 1, hex);
+        serial.write(hex[0]);
+        serial.write(hex[1]);
+      }
+      serial.write('\r');
+      serial.write('\n');
+    }
+  }
+
+  /**
+   * @brief コロンを受信した時のコールバック処理を行うヘルパー関数
+   *
+   * データ未受信時のタイマーをリスタートし、データ受信時のコールバックを呼び出します。
+   */
+  void notifyColonReceived() {
+    // コロンが受信されなかった時に呼び出される関数が登録されている場合、タイマーをリスタート
+    if (onColonNotReceived) {
+      MsTimer2::start();
+    }
+
+    // コロンが受信された時に呼び出される関数が登録されている場合、呼び出す
+    if (onColonReceived) {
+      onColonReceived();
+    }
+  }
+
+  /**
+   * @brief 受信した1文字を処理するヘルパー関数
+   *
+   * 受信フレーム（例: `00,0001,DA:12,34\r\n`）を1文字ずつ解析します。
+   * コロン以前のデータは読み捨て、コロン以降の16進数文字は2文字で1バイトとして
+   * `data` に直接書き込みます。区切り文字（,）は読み飛ばします。
+   * 型ごとにコードが生成されないよう、データのサイズは引数で受け取ります。
+   *
+   * @param c 受信した文字
+   * @param data 受信したデータを格納するバッファ（nullptrの場合は読み捨てる）
+   * @param size 受信するデータのサイズ（バイト数）
+   * @return フレームの終端（\r）を受信した場合は FRAME_READY または
+   * ERROR、それ以外は NEED_MORE
+   */
+  ImPollResult parse(char c, uint8_t *data, uint8_t size) {
+    switch (parseState) {
+    case ParseState::SEEK_COLON:
+      // コロン（:）以前のデータ（ノード番号やRSSIなど）は読み捨てる
+      if (c == ':') {
+        notifyColonReceived();
+        parseState = ParseState::PAYLOAD;
+        parsedNibbles = 0;
+      }
+      return ImPollResult::NEED_MORE;
+
+    case ParseState::PAYLOAD: {
+      // 区切り文字は読み飛ばす
+      if (c == ',') {
+        return ImPollResult::NEED_MORE;
+      }
+      // 改行でフレームが終了する（\nは次のコロンを探す際に読み捨てられる）
+      if (c == '\r') {
+        parseState = ParseState::SEEK_COLON;
+        return parsedNibbles == size * 2 ? ImPollResult::FRAME_READY
+                                         : ImPollResult::ERROR;
+      }
+      uint8_t nibble = Converter::fromHexDigit(c);
+      if (nibble > 0x0F || parsedNibbles >= size * 2) {
+        // 16進数以外の文字、またはデータが長すぎる場合は改行まで読み捨てる
+        parseState = ParseState::INVALID_PAYLOAD;
+        return ImPollResult::NEED_MORE;
+      }
+      if (data) {
+        // 偶数番目の文字は上位4ビット、奇数番目の文字は下位4ビット
+        uint8_t &byte = data[parsedNibbles >> 1];
+        byte = (parsedNibbles & 1) ? (byte | nibble) : (nibble << 4);
+      }
+      parsedNibbles++;
+      return ImPollResult::NEED_MORE;
+    }
+
+    case ParseState::INVALID_PAYLOAD:
+      // 改行まで読み捨ててからエラーを返す
+      if (c == '\r') {
+        parseState = ParseState::SEEK_COLON;
+        return ImPollResult::ERROR;
+      }
+      return ImPollResult::NEED_MORE;
+    }
+    return ImPollResult::NEED_MORE;
+  }
 
   /**
    * @brief ログメッセージを出力するヘルパー関数
    *
    * ログレベル、メソッド名、メッセージを指定してログを出力します。ロガーが設定されていない場合は、ログは出力されません。
+   * ロガーの最小のログレベルより低いレベルのログは、コンパイル時に取り除かれます。
+   * 文字列は `F()` マクロでフラッシュメモリに配置し、SRAMを消費しないようにします。
    *
-   * @param level ログレベル（例：INFO, ERROR）
+   * @tparam level ログレベル（例：INFO, ERROR）
    * @param methodName メソッド名（ログの発生源となるメソッド）
    * @param message ログメッセージ
    */
-  inline void printLog(DebugLoggerLevel level, const char *methodName,
-                       const char *message) {
+  template <DebugLoggerLevel level>
+  inline void printLog(const __FlashStringHelper *methodName,
+                       const __FlashStringHelper *message) {
     if constexpr (!IsSame<LoggerType, void>::value) {
-      logger->println(level, DebugLoggerMode::WAIT, "IM920SL", methodName,
-                      message);
+      if constexpr (!LoggerType::isCompiledOut(level)) {
+        logger->println(level, DebugLoggerMode::WAIT, F("IM920SL"),
+                        methodName, message);
+      }
     }
   }
 
@@ -275,20 +460,25 @@ private:
    * @brief フォーマット付きのログを出力するヘルパー関数
    *
    * ログメッセージをフォーマット形式で出力します。可変引数を使用してフォーマット文字列に値を挿入します。
+   * ロガーの最小のログレベルより低いレベルのログは、コンパイル時に取り除かれます。
+   * `printLog` と同様に、文字列は `F()` マクロでフラッシュメモリに配置します。
    *
-   * @param level ログレベル
+   * @tparam level ログレベル
    * @param methodName メソッド名
    * @param format フォーマット文字列
    * @param ... 可変引数
    */
-  void printLogf(DebugLoggerLevel level, const char *methodName,
-                 const char *format, ...) {
+  template <DebugLoggerLevel level>
+  void printLogf(const __FlashStringHelper *methodName,
+                 const __FlashStringHelper *format, ...) {
     if constexpr (!IsSame<LoggerType, void>::value) {
-      va_list args;
-      va_start(args, format);
-      logger->printlnf(level, DebugLoggerMode::WAIT, "IM920SL", methodName,
-                       format, args);
-      va_end(args);
+      if constexpr (!LoggerType::isCompiledOut(level)) {
+        va_list args;
+        va_start(args, format);
+        logger->vprintlnf(level, DebugLoggerMode::WAIT, F("IM920SL"),
+                          methodName, format, args);
+        va_end(args);
+      }
     }
   }
 };
@@ -9,6 +9,7 @@
  *
  * このクラスは、指定されたピンに接続されたLEDを制御するための機能を提供します。
  * LEDのオン、オフ、トグル（状態の切り替え）を行うことができます。
+ * 一定のパターンで点滅させる場合は `LedPatterns` を使用してください。
  */
 class Led {
 public:
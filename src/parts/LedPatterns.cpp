@@ -0,0 +1,66 @@
+#include "LedPatterns.h"
+
+// LEDを登録するメソッド
+uint8_t LedPatterns::add(uint8_t pin, uint16_t pattern, uint8_t stepShift) {
+  uint8_t pinPort = digitalPinToPort(pin);
+  if (numLeds >= MAX_LEDS || pinPort == NOT_A_PIN) {
+    return INVALID_INDEX;
+  }
+
+  // 同じポートのLEDがあれば、そのポートにまとめる
+  volatile uint8_t *reg = portOutputRegister(pinPort);
+  uint8_t slot = 0;
+  while (slot < numPorts && ports[slot] != reg) {
+    slot++;
+  }
+  if (slot == numPorts) {
+    if (numPorts >= MAX_PORTS) {
+      return INVALID_INDEX;
+    }
+    ports[slot] = reg;
+    portMasks[slot] = 0;
+    numPorts++;
+  }
+
+  pinMode(pin, OUTPUT);
+
+  uint8_t index = numLeds;
+  leds[index].slot = slot;
+  leds[index].mask = digitalPinToBitMask(pin);
+  portMasks[slot] |= leds[index].mask;
+  numLeds++;
+  setPattern(index, pattern, stepShift);
+  return index;
+}
+
+// LEDの点滅パターンを設定するメソッド
+void LedPatterns::setPattern(uint8_t index, uint16_t pattern,
+                             uint8_t stepShift) {
+  if (index >= numLeds) {
+    return;
+  }
+  // 1周が16ビットの時刻の一周（65536ミリ秒）を超えないようにする
+  if (stepShift > MAX_STEP_SHIFT) {
+    stepShift = MAX_STEP_SHIFT;
+  }
+  leds[index].pattern = pattern;
+  leds[index].stepShift = stepShift;
+}
+
+// 全てのLEDを現在の時刻のステップで出力するメソッド
+void LedPatterns::tick(uint16_t now) {
+  uint8_t bits[MAX_PORTS] = {0, 0, 0};
+  for (uint8_t i = 0; i < numLeds; i++) {
+    const Entry &led = leds[i];
+    if (level(led.pattern, led.stepShift, now)) {
+      bits[led.slot] |= led.mask;
+    }
+  }
+
+  uint8_t oldSREG = SREG;
+  cli();
+  for (uint8_t i = 0; i < numPorts; i++) {
+    *ports[i] = (*ports[i] & ~portMasks[i]) | bits[i];
+  }
+  SREG = oldSREG;
+}
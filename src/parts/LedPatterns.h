@@ -0,0 +1,148 @@
+/**
+ * @file LedPatterns.h
+ * @brief 複数のLEDを点滅パターンで光らせるクラス定義
+ *
+ * このファイルには、複数のLEDをそれぞれのビットパターンで点滅させる
+ * `LedPatterns` クラスが定義されています。`delay()` や LEDごとの `millis()` の
+ * 判定を使わずに、`tick()` の1回の呼び出しで全てのLEDを更新します。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @class LedPatterns
+ * @brief 複数のLEDを16ビットの点滅パターンで光らせるクラス
+ *
+ * 各LEDは16ビットのパターンを上位ビットから順に1ステップずつ表示し、
+ * 16ステップで1周します（1が点灯、0が消灯）。1ステップの長さは
+ * 2のべき乗のミリ秒（`1 << stepShift` ミリ秒、`stepShift` は0〜12）で指定します。
+ * 時刻は16ビット（65536ミリ秒で一周）で扱うため、1周が65536ミリ秒に収まる
+ * 12（1ステップ4096ミリ秒、1周約65秒）が上限です。
+ * 表示するステップは `tick()` に渡した時刻から計算するため、LEDごとに
+ * タイマーを持たず、同じ長さのLEDは同じ位相で点滅します。
+ *
+ * `tick()` は、同じポートのLEDへの出力を1回のポートの書き込みにまとめます。
+ * AVRでのRAMは、LED1つあたり5バイト（`MAX_LEDS` 個分を確保するため40バイト）と、
+ * LEDの数によらない11バイト（ポートの出力レジスタのポインタ3つで6バイト、
+ * ポートごとのピンのビットで3バイト、LEDの数とポートの数で2バイト）の、
+ * 合計51バイトです。
+ *
+ * 使用例:
+ * @code
+ * LedPatterns leds;
+ * uint8_t status, error;
+ *
+ * void setup() {
+ *   status = leds.add(13, LedPatterns::HEARTBEAT);
+ *   error = leds.add(12, LedPatterns::OFF);
+ * }
+ *
+ * void loop() {
+ *   if (failed) {
+ *     leds.setPattern(error, LedPatterns::FAST_BLINK);
+ *   }
+ *   leds.tick(millis());
+ * }
+ * @endcode
+ */
+class LedPatterns {
+public:
+  /// 登録できるLEDの最大数
+  static const uint8_t MAX_LEDS = 8;
+
+  /// `add()` が失敗した場合の戻り値
+  static const uint8_t INVALID_INDEX = 0xFF;
+
+  /// 1ステップの長さのデフォルト（2の6乗 = 64ミリ秒、1周は約1秒）
+  static const uint8_t DEFAULT_STEP_SHIFT = 6;
+
+  /// 1ステップの長さの上限（2の12乗 = 4096ミリ秒、1周は16ビットの時刻の一周と同じ）
+  static const uint8_t MAX_STEP_SHIFT = 12;
+
+  /// 消灯
+  static const uint16_t OFF = 0x0000;
+  /// 点灯
+  static const uint16_t ON = 0xFFFF;
+  /// 半周期ごとに点灯・消灯
+  static const uint16_t BLINK = 0xFF00;
+  /// 1ステップごとに点灯・消灯
+  static const uint16_t FAST_BLINK = 0xAAAA;
+  /// 短く2回点灯
+  static const uint16_t HEARTBEAT = 0xA000;
+  /// 短く1回点灯
+  static const uint16_t FLASH = 0x8000;
+
+  /**
+   * @brief 時刻に対応するパターンのビットを取得するメソッド
+   *
+   * @param pattern 点滅パターン
+   * @param stepShift 1ステップの長さ（`1 << stepShift` ミリ秒、0〜12）
+   * @param now 現在の時刻（ミリ秒）
+   * @return 点灯する場合は true
+   */
+  static bool level(uint16_t pattern, uint8_t stepShift, uint16_t now) {
+    return (pattern >> (15 - ((now >> stepShift) & 15))) & 1;
+  }
+
+  /**
+   * @brief LEDを登録するメソッド
+   *
+   * ピンを出力モードに設定します。
+   *
+   * @param pin LEDが接続されているピン番号
+   * @param pattern 点滅パターン（デフォルトは消灯）
+   * @param stepShift 1ステップの長さ（`1 << stepShift` ミリ秒、0〜12。
+   * 12より大きい値は12になります）
+   * @return LEDの番号（登録できない場合は `INVALID_INDEX`）
+   */
+  uint8_t add(uint8_t pin, uint16_t pattern = OFF,
+              uint8_t stepShift = DEFAULT_STEP_SHIFT);
+
+  /**
+   * @brief LEDの点滅パターンを設定するメソッド
+   *
+   * 出力は次の `tick()` で行われます。
+   *
+   * @param index LEDの番号
+   * @param pattern 点滅パターン
+   * @param stepShift 1ステップの長さ（`1 << stepShift` ミリ秒、0〜12。
+   * 12より大きい値は12になります）
+   */
+  void setPattern(uint8_t index, uint16_t pattern,
+                  uint8_t stepShift = DEFAULT_STEP_SHIFT);
+
+  /**
+   * @brief 全てのLEDを現在の時刻のステップで出力するメソッド
+   *
+   * @param now 現在の時刻（ミリ秒、`millis()` の値など）
+   */
+  void tick(uint16_t now);
+
+  /**
+   * @brief 登録したLEDの数を取得するメソッド
+   *
+   * @return LEDの数
+   */
+  uint8_t size() const { return numLeds; }
+
+private:
+  /// 1つのLEDの設定
+  struct Entry {
+    uint16_t pattern;  ///< 点滅パターン
+    uint8_t stepShift; ///< 1ステップの長さ
+    uint8_t slot;      ///< ポートの番号（`ports` の添字）
+    uint8_t mask;      ///< ピンのビット
+  };
+
+  /// 出力するポートの最大数（ATmega328PのポートB、C、D）
+  static const uint8_t MAX_PORTS = 3;
+
+  Entry leds[MAX_LEDS];               /**< LEDの設定 */
+  uint8_t numLeds = 0;                /**< LEDの数 */
+  volatile uint8_t *ports[MAX_PORTS]; /**< ポートの出力レジスタ */
+  uint8_t portMasks[MAX_PORTS];       /**< ポートごとのLEDのピンのビット */
+  uint8_t numPorts = 0;               /**< ポートの数 */
+};
@@ -3,15 +3,15 @@
 // テンプレート引数は変数に対応していないため、マクロを使用してケースを追加
 #define ADD_LEDS_CASE(pin)                                                     \
   case pin:                                                                    \
-    FastLED.addLeds<WS2812B, pin>(leds, numLeds);                              \
+    output.setController(&FastLED.addLeds<WS2812B, pin>(leds, numLeds));       \
     break;
 
 // コンストラクタ：LEDの数とデータピンを指定し、LEDをセットアップ
 // numLeds: 使用するLEDの数
 // dataPin: データピンの番号
-LedTape::LedTape(uint8_t numLeds, const uint8_t dataPin) : numLeds(numLeds) {
-  // LED配列を動的に割り当て
-  leds = new CRGB[numLeds];
+LedTape::LedTape(uint16_t numLeds, const uint8_t dataPin)
+    : LedTapeBase(new CRGB[numLeds], numLeds) {
+  // LED配列はLedTapeBaseのコンストラクタで動的に割り当て済み
 
   // データピンに基づいてLEDを追加
   // メモリーがもったいないい（泣）
@@ -47,72 +47,110 @@ LedTape::~LedTape() {
 
 // 単色で全てのLEDを光らせる
 // color: 表示する色（32ビットのRGB値）
-void LedTape::solidColor(uint32_t color) {
+void LedTapeBase::solidColor(uint32_t color) {
   // 全てのLEDを指定された色で塗りつぶす
-  fill_solid(leds, numLeds, CRGB(color));
-  // LEDの状態を表示
-  FastLED.show();
+  frameBuffer.fill(CRGB(color));
+  // LEDの状態を表示（色が変わらない場合は出力しない）
+  frameBuffer.show(millis(), true);
 }
 
 // LEDを点滅させる
 // color: 点滅させる色（32ビットのRGB値）
 // delayTime: 点滅の間隔（ミリ秒）
-void LedTape::blinkColor(uint32_t color, unsigned long delayTime) {
-  solidColor(color);       // 全部同じ色で光らせる
-  delay(delayTime);        // 指定された時間だけ待機
-  solidColor(CRGB::Black); // 消す
-  delay(delayTime);        // 指定された時間だけ待機
+void LedTapeBase::blinkColor(uint32_t color, unsigned long delayTime) {
+  // 点灯と消灯の2フレームを表示
+  BlinkEffect effect(color, delayTime);
+  playFrames(effect, 2, delayTime);
 }
 
 // レインボーパターンで光らせる
 // delayTime: 各色の表示間隔（ミリ秒）
-void LedTape::rainbow(unsigned long delayTime) {
-  // 色相を変化させながらLEDを光らせる
-  for (uint8_t j = 0; j < 256; j++) {
-    for (uint8_t i = 0; i < numLeds; i++) {
-      // HSV色空間で色を変える
-      leds[i] = CHSV((i + j) % 256, 255, 255);
-    }
-    // LEDの状態を表示
-    FastLED.show();
-    // 指定された時間だけ待機
-    delay(delayTime);
-  }
+void LedTapeBase::rainbow(unsigned long delayTime) {
+  // 色相が1周する256フレームを表示
+  RainbowEffect effect(delayTime);
+  playFrames(effect, 256, delayTime);
 }
 
 // チェイスパターンで光らせる
 // color: チェイスさせる色（32ビットのRGB値）
 // delayTime: 各LEDの表示間隔（ミリ秒）
-void LedTape::chase(uint32_t color, unsigned long delayTime) {
+void LedTapeBase::chase(uint32_t color, unsigned long delayTime) {
   // LEDを1つずつ光らせる
-  for (uint8_t i = 0; i < numLeds; i++) {
-    leds[i] = color; // 1つずつ色を設定
-    // LEDの状態を表示
-    FastLED.show();
-    // 指定された時間だけ待機
-    delay(delayTime);
-    leds[i] = CRGB::Black; // 消す
+  ChaseEffect effect(color, delayTime);
+  playFrames(effect, numLeds, delayTime);
+  if (numLeds > 0) {
+    frameBuffer.set(numLeds - 1, CRGB::Black); // 最後のLEDを消す
   }
 }
 
 // 指定された色を基にしたグラデーションパターン
 // baseColor: グラデーションの基になる色（32ビットのRGB値）
 // delayTime: グラデーションの表示間隔（ミリ秒）
-void LedTape::gradient(uint32_t baseColor, unsigned long delayTime) {
-  // 指定された色をCRGBオブジェクトに変換
-  CRGB color = CRGB(baseColor);
-  uint8_t maxBrightness = 255; // 最大の明るさ
+void LedTapeBase::gradient(uint32_t baseColor, unsigned long delayTime) {
+  GradientEffect effect(baseColor);
+  playFrames(effect, 1, delayTime);
+}
+
+// エフェクトを開始する
+// effect: 開始するエフェクト
+void LedTapeBase::play(LedTapeEffect &effect) {
+  effect.reset();
+  this->effect = &effect;
+}
+
+// エフェクトを停止する
+void LedTapeBase::stop() { effect = nullptr; }
+
+// エフェクトを進め、描画した場合はLEDテープに出力する
+bool LedTapeBase::update() {
+  unsigned long now = millis();
+  if (effect != nullptr && effect->update(leds, numLeds, now)) {
+    frameBuffer.markDirty();
+    return frameBuffer.show(now);
+  }
+  // リフレッシュレートの上限で保留したフレームがあれば出力する
+  return frameBuffer.flush(now);
+}
 
-  // 色相を基に、グラデーションを生成
-  for (uint8_t i = 0; i < numLeds; i++) {
-    // グラデーションの割合を計算
-    float factor = (float)i / numLeds;
+// 全体の明るさを設定し、すぐに出力し直す
+// brightness: 明るさ（0～255）
+void LedTapeBase::setBrightness(uint8_t brightness) {
+  LedOutput *current = frameBuffer.getOutput();
+  if (current == nullptr) {
+    return;
+  }
+  current->setBrightness(brightness);
+  // LED配列は変わらないが、出力する値が変わるため出力し直す
+  frameBuffer.markDirty();
+  frameBuffer.flush(millis(), true);
+}
 
-    // ベースの色に基づいて、明るさを段階的に変化させる
-    leds[i] = color.fadeToBlackBy((1.0f - factor) * maxBrightness);
+// ガンマ補正を有効にするかどうかを設定し、すぐに出力し直す
+// enabled: 有効にする場合は true
+void LedTapeBase::setGammaCorrection(bool enabled) {
+  LedOutput *current = frameBuffer.getOutput();
+  if (current == nullptr) {
+    return;
   }
-  // LEDの状態を表示
-  FastLED.show();
-  // 指定された時間だけ待機
-  delay(delayTime);
-}
\ No newline at end of file
+  current->setGammaCorrection(enabled);
+  frameBuffer.markDirty();
+  frameBuffer.flush(millis(), true);
+}
+
+// エフェクトを指定したフレーム数だけ描画し、その都度待機する
+// effect: 描画するエフェクト
+// frames: 描画するフレーム数
+// delayTime: 各フレームを表示する時間（ミリ秒）
+void LedTapeBase::playFrames(LedTapeEffect &effect, uint16_t frames,
+                             unsigned long delayTime) {
+  for (uint16_t i = 0; i < frames; i++) {
+    // 時刻はフレームの間隔どおりに進んだものとして描画する
+    if (effect.update(leds, numLeds, i * delayTime)) {
+      frameBuffer.markDirty();
+    }
+    // LEDの状態を表示（待機する光り方では、リフレッシュレートの上限を無視する）
+    frameBuffer.show(millis(), true);
+    // 指定された時間だけ待機
+    delay(delayTime);
+  }
+}
@@ -2,43 +2,48 @@
  * @file LedTape.h
  * @brief LEDテープを制御するクラス定義
  *
- * このファイルには、LEDテープの制御を行う `LedTape` クラスが
- * 定義されています。このクラスは、LEDの数と信号ピンを指定して
- * LEDテープを制御する機能を提供します。
+ * このファイルには、LEDテープの制御を行う `LedTape` クラスと
+ * `StaticLedTape` クラスが定義されています。これらのクラスは、LEDの数と
+ * 信号ピンを指定してLEDテープを制御する機能を提供します。
  */
 
 #ifndef LED_TAPE_H
 #define LED_TAPE_H
 
 #include <FastLED.h>
+#include <parts/ledtapes/LedFrameBuffer.h>
+#include <parts/ledtapes/LedGamma.h>
+#include <parts/ledtapes/LedOutput.h>
+#include <parts/ledtapes/LedTapeEffects.h>
 
 /**
- * @class LedTape
- * @brief LEDテープを制御するクラス
+ * @class LedTapeBase
+ * @brief LEDテープの光り方を制御する基底クラス
+ *
+ * `LedTapeBase` クラスは、FastLEDライブラリを使用してLEDテープの
+ * 様々な光り方を制御します。複数の光り方パターン（単色、点滅、レインボーなど）
+ * を提供します。LED配列の確保とFastLEDへの登録は、派生クラスの
+ * `LedTape` と `StaticLedTape` が行います。
+ *
+ * `blinkColor()` や `rainbow()` などのメソッドは、光り方が終わるまで戻りません。
+ * 他の処理と同時に光らせたい場合は、`play()` でエフェクトを指定し、
+ * `loop()` の中で `update()` を繰り返し呼び出してください。
+ *
+ * 使用例:
+ * @code
+ * LedTape ledTape(30, 6);
+ * RainbowEffect rainbow(20);
  *
- * `LedTape` クラスは、FastLEDライブラリを使用してLEDテープの
- * 様々な光り方を制御します。LEDの数とデータピンを指定して、
- * 複数の光り方パターン（単色、点滅、レインボーなど）を提供します。
+ * void setup() { ledTape.play(rainbow); }
+ *
+ * void loop() {
+ *   ledTape.update(); // 20ミリ秒ごとに1フレームだけ描画してすぐに戻る
+ *   // モーターの制御など
+ * }
+ * @endcode
  */
-class LedTape {
+class LedTapeBase {
 public:
-  /**
-   * @brief コンストラクタ
-   *
-   * LEDの数とデータピンを指定して、LEDテープを初期化します。
-   *
-   * @param numLeds LEDの数
-   * @param dataPin LED信号用のピン番号
-   */
-  LedTape(uint8_t numLeds, uint8_t dataPin);
-
-  /**
-   * @brief デストラクタ
-   *
-   * LEDテープのメモリを解放します。
-   */
-  ~LedTape();
-
   /**
    * @brief 単色で光らせる
    *
@@ -87,6 +92,111 @@ public:
    */
   void gradient(uint32_t baseColor, unsigned long delayTime);
 
+  /**
+   * @brief エフェクトを開始する
+   *
+   * 指定したエフェクトを最初のフレームから開始します。
+   * 実際の描画は `update()` を呼び出した時に行われます。
+   *
+   * @param effect 開始するエフェクト（`update()` を呼び出す間は破棄しないこと）
+   */
+  void play(LedTapeEffect &effect);
+
+  /**
+   * @brief エフェクトを停止する
+   *
+   * LEDの状態はそのまま残ります。
+   */
+  void stop();
+
+  /**
+   * @brief エフェクトを進める
+   *
+   * `play()` で開始したエフェクトの次のフレームの時刻になっていれば、
+   * 1フレームだけ描画してLEDテープに出力します。待機はしません。
+   *
+   * @return LEDテープに出力した場合は true
+   */
+  bool update();
+
+  /**
+   * @brief リフレッシュレートの上限を設定する
+   *
+   * `update()` で描画したフレームは、上限を超えない間隔でLEDテープに出力されます。
+   * 出力の間は割り込みが禁止されるため、シリアル通信などへの影響を減らせます。
+   *
+   * @param framesPerSecond 1秒あたりの最大フレーム数（0の場合は上限なし）
+   */
+  void setMaxRefreshRate(uint8_t framesPerSecond) {
+    frameBuffer.setMaxRefreshRate(framesPerSecond);
+  }
+
+  /**
+   * @brief 全体の明るさを設定する
+   *
+   * 明るさは出力時に適用されるため、LED配列は書き換えません。
+   * 設定した明るさで、すぐにLEDテープに出力し直します。
+   *
+   * @param brightness 明るさ（0～255、デフォルトは255）
+   */
+  void setBrightness(uint8_t brightness);
+
+  /**
+   * @brief ガンマ補正を有効にするかどうかを設定する
+   *
+   * 標準の出力（FastLED）で色を補正するには、`setGammaBuffer()` で作業用のLED配列を
+   * 設定してください。設定していない場合は明るさだけを補正します。
+   * SRAMを増やさずに色を補正する場合は、`setOutput()` で `Ws2812Output` を
+   * 指定してください。
+   *
+   * @param enabled 有効にする場合は true（デフォルトは false）
+   */
+  void setGammaCorrection(bool enabled);
+
+  /**
+   * @brief 標準の出力（FastLED）がガンマ補正に使用する作業用のLED配列を設定する
+   *
+   * LED1つあたり3バイトのSRAMを使用するため、確保は呼び出し元が行います。
+   * LEDの数以上の大きさの配列を指定してください。
+   *
+   * @param buffer 作業用のLED配列（nullptr の場合は明るさだけを補正する）
+   * @param size 作業用のLED配列のLEDの数
+   */
+  void setGammaBuffer(CRGB *buffer, uint16_t size) {
+    output.setGammaBuffer(buffer, size);
+  }
+
+  /**
+   * @brief 出力先を変更する
+   *
+   * 明るさとガンマ補正の設定は、変更後の出力先のものが使用されます。
+   *
+   * @param output 出力先（`update()` を呼び出す間は破棄しないこと）
+   */
+  void setOutput(LedOutput &output) { frameBuffer.setOutput(&output); }
+
+  /**
+   * @brief LEDテープへの出力を要求されたフレームの数を取得する
+   *
+   * @return 出力を要求されたフレームの数
+   */
+  uint32_t requestedFrames() const { return frameBuffer.requestedFrames(); }
+
+  /**
+   * @brief 実際にLEDテープに出力したフレームの数を取得する
+   *
+   * LEDの色が変わらなかったフレームや、リフレッシュレートの上限で
+   * 省略したフレームは数えません。
+   *
+   * @return 出力したフレームの数
+   */
+  uint32_t pushedFrames() const { return frameBuffer.pushedFrames(); }
+
+  /**
+   * @brief フレームの数をリセットする
+   */
+  void resetFrameCounters() { frameBuffer.resetCounters(); }
+
   /**
    * @enum HTMLColorCode
    * @brief 代表的なHTMLカラーコード
@@ -255,13 +365,22 @@ public:
 
   } HTMLColorCode;
 
-private:
+protected:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param leds LED配列
+   * @param numLeds LEDの数
+   */
+  LedTapeBase(CRGB *leds, uint16_t numLeds)
+      : numLeds(numLeds), leds(leds), frameBuffer(leds, numLeds, &output) {}
+
   /**
    * @brief LEDの数
    *
    * この変数は、制御するLEDテープのLEDの総数を保持します。
    */
-  uint8_t numLeds; ///< LEDの数
+  uint16_t numLeds; ///< LEDの数
 
   /**
    * @brief LED配列
@@ -270,6 +389,94 @@ private:
    * LEDテープの各LEDの状態を保持するために使用されます。
    */
   CRGB *leds; ///< LED配列
+
+  /// FastLEDのコントローラーへの出力（派生クラスがコントローラーを設定する）
+  FastLedOutput output;
+
+  /// 変更があった時だけ出力するためのフレームバッファ
+  LedFrameBuffer frameBuffer;
+
+private:
+  /// `update()` で進めるエフェクト（停止中は nullptr）
+  LedTapeEffect *effect = nullptr;
+
+  /**
+   * @brief エフェクトを指定したフレーム数だけ描画し、その都度待機する
+   *
+   * 待機する光り方のメソッドで使用します。
+   *
+   * @param effect 描画するエフェクト
+   * @param frames 描画するフレーム数
+   * @param delayTime 各フレームを表示する時間（ミリ秒）
+   */
+  void playFrames(LedTapeEffect &effect, uint16_t frames,
+                  unsigned long delayTime);
+};
+
+/**
+ * @class LedTape
+ * @brief データピンを実行時に指定するLEDテープのクラス
+ *
+ * LEDの数とデータピンをコンストラクタで指定します。
+ * データピンが実行時に決まるため、1～19番の全てのピンに対応するFastLEDの
+ * コントローラーがプログラムに含まれ、フラッシュメモリを多く消費します。
+ * データピンがコンパイル時に決まる場合は `StaticLedTape` を使用してください。
+ */
+class LedTape : public LedTapeBase {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * LEDの数とデータピンを指定して、LEDテープを初期化します。
+   *
+   * @param numLeds LEDの数
+   * @param dataPin LED信号用のピン番号
+   */
+  LedTape(uint16_t numLeds, uint8_t dataPin);
+
+  /**
+   * @brief デストラクタ
+   *
+   * LEDテープのメモリを解放します。
+   */
+  ~LedTape();
+};
+
+/**
+ * @class StaticLedTape
+ * @brief データピンとLEDの数をコンパイル時に指定するLEDテープのクラス
+ *
+ * 指定したデータピンのFastLEDのコントローラーだけがプログラムに含まれるため、
+ * `LedTape` よりもフラッシュメモリの使用量が少なくなります。
+ * また、LED配列を動的に確保せず、静的な配列としてクラス内に持ちます。
+ *
+ * 使用例:
+ * @code
+ * StaticLedTape<6, 30> ledTape; // データピン6、LEDの数30
+ *
+ * void loop() { ledTape.solidColor(StaticLedTape<6, 30>::Red); }
+ * @endcode
+ *
+ * @tparam DataPin LED信号用のピン番号
+ * @tparam NumLeds LEDの数
+ */
+template <uint8_t DataPin, uint16_t NumLeds>
+class StaticLedTape : public LedTapeBase {
+  static_assert(NumLeds > 0, "LEDの数は1以上でなければなりません");
+
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * 指定したデータピンでLEDテープを初期化します。
+   */
+  StaticLedTape() : LedTapeBase(storage, NumLeds) {
+    output.setController(&FastLED.addLeds<WS2812B, DataPin>(storage, NumLeds));
+  }
+
+private:
+  /// LED配列の実体
+  CRGB storage[NumLeds];
 };
 
 #endif // LED_TAPE_H
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "QuadratureEncoder.h"
+#include <avr/interrupt.h>
+
+// A相・B相の前回の状態 (上位2ビット) と今回の状態 (下位2ビット) から数の増減を引く表
+// A相が先に変化する向き (00 -> 10 -> 11 -> 01 -> 00) を正とし、
+// 2つの相が同時に変化した場合 (読み飛ばし) は 0 とする
+static const int8_t TRANSITIONS[16] PROGMEM = {
+    0,  -1, 1, 0,  // 00 -> 00, 01, 10, 11
+    1,  0,  0, -1, // 01 -> 00, 01, 10, 11
+    -1, 0,  0, 1,  // 10 -> 00, 01, 10, 11
+    0,  1,  -1, 0  // 11 -> 00, 01, 10, 11
+};
+
+#if defined(QUADRATURE_ENCODER_USE_INTERRUPT)
+// ピン変化割り込みのグループ (PCINT0〜2) ごとのエンコーダー
+static QuadratureEncoder *interruptGroups[3] = {nullptr, nullptr, nullptr};
+#endif
+
+volatile uint8_t QuadratureEncoder::noInput = 0;
+
+// 前回と今回のA相・B相の状態から、数の増減を取得する
+int8_t QuadratureEncoder::decode(uint8_t previous, uint8_t current) {
+  return static_cast<int8_t>(
+      pgm_read_byte(&TRANSITIONS[(previous << 2) | current]));
+}
+
+// エンコーダーを追加するメソッド
+uint8_t QuadratureEncoder::add(uint8_t pinA, uint8_t pinB) {
+  uint8_t portA = digitalPinToPort(pinA);
+  if (numEncoders >= MAX_ENCODERS || portA == NOT_A_PIN ||
+      portA != digitalPinToPort(pinB) ||
+      (numEncoders > 0 && portA != port)) {
+    return INVALID_INDEX;
+  }
+  if (numEncoders == 0) {
+    port = portA;
+    firstPin = pinA;
+    inputRegister = portInputRegister(port);
+  }
+
+  pinMode(pinA, INPUT_PULLUP);
+  pinMode(pinB, INPUT_PULLUP);
+
+  uint8_t index = numEncoders;
+  maskA[index] = digitalPinToBitMask(pinA);
+  maskB[index] = digitalPinToBitMask(pinB);
+  pinMask |= maskA[index] | maskB[index];
+  counts[index] = 0;
+  numEncoders++;
+  return index;
+}
+
+// ピン変化割り込みを有効にするメソッド
+void QuadratureEncoder::begin() {
+  if (numEncoders == 0) {
+    return;
+  }
+  uint8_t oldSREG = SREG;
+  cli();
+  // 現在の状態を前回の状態として記録する
+  uint8_t portState = *inputRegister;
+  for (uint8_t i = 0; i < numEncoders; i++) {
+    previous[i] = ((portState & maskA[i]) ? 2 : 0) |
+                  ((portState & maskB[i]) ? 1 : 0);
+  }
+#if defined(PCICR)
+#if defined(__AVR_ATmega328P__)
+  // ATmega328Pでは、PCMSKnのビットはポートのビットと同じ位置にある
+  *digitalPinToPCMSK(firstPin) |= pinMask;
+#else
+  // 他のマイコンではビットの位置が異なる場合があるため、ピンごとに設定する
+  for (uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++) {
+    volatile uint8_t *pcmsk = digitalPinToPCMSK(pin);
+    if (pcmsk != nullptr && digitalPinToPort(pin) == port &&
+        (digitalPinToBitMask(pin) & pinMask)) {
+      *pcmsk |= _BV(digitalPinToPCMSKbit(pin));
+    }
+  }
+#endif
+  PCIFR = _BV(digitalPinToPCICRbit(firstPin)); // 保留中の割り込みを消す
+  PCICR |= _BV(digitalPinToPCICRbit(firstPin));
+#endif
+#if defined(QUADRATURE_ENCODER_USE_INTERRUPT)
+  interruptGroups[digitalPinToPCICRbit(firstPin)] = this;
+#endif
+  SREG = oldSREG;
+}
+
+// ポートの状態から、全てのエンコーダーの数を更新するメソッド
+void QuadratureEncoder::update(uint8_t portState) {
+  for (uint8_t i = 0; i < numEncoders; i++) {
+    uint8_t current = ((portState & maskA[i]) ? 2 : 0) |
+                      ((portState & maskB[i]) ? 1 : 0);
+    counts[i] += decode(previous[i], current);
+    previous[i] = current;
+  }
+}
+
+// エンコーダーの数を取得するメソッド
+int32_t QuadratureEncoder::read(uint8_t index) const {
+  if (index >= numEncoders) {
+    return 0;
+  }
+  uint8_t oldSREG = SREG;
+  cli();
+  int32_t count = counts[index];
+  SREG = oldSREG;
+  return count;
+}
+
+// 全てのエンコーダーの数を同じ時点で取得するメソッド
+void QuadratureEncoder::readAll(int32_t *counts) const {
+  uint8_t oldSREG = SREG;
+  cli();
+  for (uint8_t i = 0; i < numEncoders; i++) {
+    counts[i] = this->counts[i];
+  }
+  SREG = oldSREG;
+}
+
+// エンコーダーの数を設定するメソッド
+void QuadratureEncoder::write(uint8_t index, int32_t count) {
+  if (index >= numEncoders) {
+    return;
+  }
+  uint8_t oldSREG = SREG;
+  cli();
+  counts[index] = count;
+  SREG = oldSREG;
+}
+
+// ピン変化割り込みハンドラ
+#if defined(QUADRATURE_ENCODER_USE_INTERRUPT)
+ISR(PCINT0_vect) {
+  if (interruptGroups[0] != nullptr) {
+    interruptGroups[0]->handleInterrupt();
+  }
+}
+
+ISR(PCINT1_vect) {
+  if (interruptGroups[1] != nullptr) {
+    interruptGroups[1]->handleInterrupt();
+  }
+}
+
+ISR(PCINT2_vect) {
+  if (interruptGroups[2] != nullptr) {
+    interruptGroups[2]->handleInterrupt();
+  }
+}
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file QuadratureEncoder.h
+ * @brief ロータリーエンコーダー（A相・B相）の回転を数えるクラス定義
+ *
+ * このファイルには、ピン変化割り込みでロータリーエンコーダーの回転を数える
+ * `QuadratureEncoder` クラスが定義されています。同じポートに接続した
+ * 複数のエンコーダーを、1回のポートの読み込みでまとめて数えます。
+ *
+ * 割り込みハンドラは、ビルドフラグ `-DQUADRATURE_ENCODER_USE_INTERRUPT` を指定すると
+ * ライブラリが定義します。他のライブラリ（SoftwareSerialなど）とピン変化割り込みが
+ * 重なる場合は、フラグを指定せずにスケッチで定義してください。
+ *
+ * @code
+ * ISR(PCINT2_vect) { encoders.handleInterrupt(); } // ポートD（ピン0〜7）の場合
+ * @endcode
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @class QuadratureEncoder
+ * @brief 同じポートに接続したロータリーエンコーダーの回転を数えるクラス
+ *
+ * A相とB相の状態の変化を、16通りの変化から数の増減を引く表で数えます
+ * （1回転のパルス数の4倍の分解能になります）。2つの相が同時に変化した場合は
+ * 読み飛ばしたものとして数えません。
+ *
+ * 使用例:
+ * @code
+ * QuadratureEncoder encoders;
+ * uint8_t left, right;
+ *
+ * void setup() {
+ *   left = encoders.add(2, 3);  // ポートD
+ *   right = encoders.add(4, 5); // ポートD
+ *   encoders.begin();
+ * }
+ *
+ * void loop() {
+ *   int32_t counts[2];
+ *   encoders.readAll(counts); // 2つのエンコーダーを同じ時点で読む
+ * }
+ * @endcode
+ */
+class QuadratureEncoder {
+public:
+  /// 1つのポートに接続できるエンコーダーの最大数
+  static const uint8_t MAX_ENCODERS = 4;
+
+  /// `add()` が失敗した場合の戻り値
+  static const uint8_t INVALID_INDEX = 0xFF;
+
+  /**
+   * @brief 前回と今回のA相・B相の状態から、数の増減を取得する
+   *
+   * @param previous 前回の状態（A相を1ビット目、B相を0ビット目とする0〜3）
+   * @param current 今回の状態（0〜3）
+   * @return 数の増減（-1、0、1）
+   */
+  static int8_t decode(uint8_t previous, uint8_t current);
+
+  /**
+   * @brief エンコーダーを追加するメソッド
+   *
+   * ピンを内部プルアップ抵抗付きの入力モードに設定します。
+   * 全てのエンコーダーは同じポートに接続する必要があります。
+   *
+   * @param pinA A相のピン番号
+   * @param pinB B相のピン番号
+   * @return エンコーダーの番号（追加できない場合は `INVALID_INDEX`）
+   */
+  uint8_t add(uint8_t pinA, uint8_t pinB);
+
+  /**
+   * @brief ピン変化割り込みを有効にするメソッド
+   *
+   * エンコーダーを全て追加した後に呼び出します。
+   */
+  void begin();
+
+  /**
+   * @brief ポートを読み込み、全てのエンコーダーの数を更新するメソッド
+   *
+   * ピン変化割り込みハンドラから呼び出します。
+   */
+  void handleInterrupt() { update(*inputRegister); }
+
+  /**
+   * @brief ポートの状態から、全てのエンコーダーの数を更新するメソッド
+   *
+   * @param portState ポートの入力レジスタ（PINx）の値
+   */
+  void update(uint8_t portState);
+
+  /**
+   * @brief エンコーダーの数を取得するメソッド
+   *
+   * 割り込みを禁止して読み込むため、途中で値が変わることはありません。
+   *
+   * @param index エンコーダーの番号
+   * @return エンコーダーの数
+   */
+  int32_t read(uint8_t index) const;
+
+  /**
+   * @brief 全てのエンコーダーの数を同じ時点で取得するメソッド
+   *
+   * @param counts 数を格納する配列（追加したエンコーダーの数以上）
+   */
+  void readAll(int32_t *counts) const;
+
+  /**
+   * @brief エンコーダーの数を設定するメソッド
+   *
+   * @param index エンコーダーの番号
+   * @param count 設定する数（デフォルトは0）
+   */
+  void write(uint8_t index, int32_t count = 0);
+
+  /**
+   * @brief 追加したエンコーダーの数を取得するメソッド
+   *
+   * @return エンコーダーの数
+   */
+  uint8_t size() const { return numEncoders; }
+
+private:
+  /// ピンの状態を読み込まない場合の入力レジスタ
+  static volatile uint8_t noInput;
+
+  volatile uint8_t *inputRegister = &noInput; /**< ポートの入力レジスタ */
+  uint8_t port = NOT_A_PIN;                   /**< ポートの番号 */
+  uint8_t pinMask = 0;                        /**< エンコーダーのピンのビット */
+  uint8_t numEncoders = 0;                    /**< エンコーダーの数 */
+  uint8_t maskA[MAX_ENCODERS];                /**< A相のビット */
+  uint8_t maskB[MAX_ENCODERS];                /**< B相のビット */
+  uint8_t previous[MAX_ENCODERS];             /**< 前回のA相・B相の状態 */
+  volatile int32_t counts[MAX_ENCODERS];      /**< エンコーダーの数 */
+  uint8_t firstPin = 0;                       /**< 割り込みの設定に使用するピン */
+};
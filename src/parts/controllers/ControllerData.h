@@ -57,10 +57,11 @@ public:
    *
    * スティックのX軸とY軸の状態を管理します。
    * 配列のサイズは、`numSticks` に基づいて決定されます。
+   * データを受信するまでにモーターが動き出さないように、中央（128）で初期化されます。
    */
   struct Stick {
-    uint8_t x = 0;     ///< X軸の状態（0~255）
-    uint8_t y = 0;     ///< Y軸の状態（0~255）
+    uint8_t x = 128;   ///< X軸の状態（0~255、中央は128）
+    uint8_t y = 128;   ///< Y軸の状態（0~255、中央は128）
   } sticks[numSticks]; ///< スティックの状態の配列
 };
 
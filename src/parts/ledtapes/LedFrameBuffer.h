@@ -0,0 +1,258 @@
+/**
+ * @file LedFrameBuffer.h
+ * @brief 変更があった時だけLEDテープに出力するフレームバッファのクラス定義
+ *
+ * WS2812BはLED1つあたり約30µsかけて出力し、その間は割り込みが禁止されます。
+ * このファイルで定義する `LedFrameBuffer` クラスは、前回の出力から変更された
+ * LEDの範囲を記録し、変更がない場合やリフレッシュレートの上限を超える場合は
+ * 出力を省略します。出力する場合も、最後に変更されたLEDまでしか送信しません。
+ */
+
+#pragma once
+
+#include <FastLED.h>
+#include <parts/ledtapes/LedOutput.h>
+#include <stdint.h>
+
+/**
+ * @class LedFrameBuffer
+ * @brief 変更されたLEDの範囲を記録し、出力をまとめるフレームバッファ
+ *
+ * LED配列を `set()` や `fill()` で書き換えると、値が変わったLEDの範囲を記録します。
+ * LED配列を直接書き換えた場合は `markDirty()` を呼び出してください。
+ * `show()` は変更がある場合だけ `LedOutput` に出力します。
+ *
+ * WS2812Bは先頭から受信した数のLEDだけ色を更新し、残りのLEDは前回の色を保持するため、
+ * `show()` は先頭から変更された範囲の最後のLEDまでを出力します。例えば300個のLEDの
+ * 先頭の10個だけを変更した場合、出力にかかる時間は約9msから約0.3msになります。
+ * 変更された範囲より前のLEDは、WS2812Bの仕様上省略できません。
+ *
+ * 使用例:
+ * @code
+ * CRGB leds[30];
+ * FastLedOutput output;
+ * LedFrameBuffer frameBuffer(leds, 30, &output);
+ *
+ * void loop() {
+ *   frameBuffer.set(0, CRGB::Red);
+ *   frameBuffer.show(millis()); // 2回目以降は変更がないため出力しない
+ * }
+ * @endcode
+ */
+class LedFrameBuffer {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * 最初の `show()` で必ず出力するため、全てのLEDを変更ありとして初期化します。
+   *
+   * @param leds LED配列
+   * @param numLeds LEDの数
+   * @param output 出力先（nullptr の場合は出力しない）
+   */
+  LedFrameBuffer(CRGB *leds, uint16_t numLeds, LedOutput *output)
+      : leds(leds), numLeds(numLeds), output(output) {
+    markDirty();
+  }
+
+  /**
+   * @brief LED配列を取得する
+   *
+   * @return LED配列
+   */
+  CRGB *data() { return leds; }
+
+  /**
+   * @brief LEDの数を取得する
+   *
+   * @return LEDの数
+   */
+  uint16_t size() const { return numLeds; }
+
+  /**
+   * @brief 出力先を変更する
+   *
+   * 次の `show()` で必ず出力するため、全てのLEDを変更ありとして記録します。
+   *
+   * @param output 出力先（nullptr の場合は出力しない）
+   */
+  void setOutput(LedOutput *output) {
+    this->output = output;
+    markDirty();
+  }
+
+  /**
+   * @brief 出力先を取得する
+   *
+   * @return 出力先
+   */
+  LedOutput *getOutput() const { return output; }
+
+  /**
+   * @brief 1つのLEDの色を設定する
+   *
+   * 色が変わる場合だけ、変更ありとして記録します。
+   *
+   * @param index LEDの番号
+   * @param color 設定する色
+   */
+  void set(uint16_t index, const CRGB &color) {
+    if (index >= numLeds || leds[index] == color) {
+      return;
+    }
+    leds[index] = color;
+    markDirty(index, index);
+  }
+
+  /**
+   * @brief 全てのLEDを同じ色に設定する
+   *
+   * 色が変わるLEDだけ、変更ありとして記録します。
+   *
+   * @param color 設定する色
+   */
+  void fill(const CRGB &color) {
+    for (uint16_t i = 0; i < numLeds; i++) {
+      set(i, color);
+    }
+  }
+
+  /**
+   * @brief 全てのLEDを変更ありとして記録する
+   */
+  void markDirty() {
+    if (numLeds > 0) {
+      markDirty(0, numLeds - 1);
+    }
+  }
+
+  /**
+   * @brief 指定した範囲のLEDを変更ありとして記録する
+   *
+   * @param first 範囲の最初のLEDの番号
+   * @param last 範囲の最後のLEDの番号（`first` 以上）
+   */
+  void markDirty(uint16_t first, uint16_t last) {
+    if (!dirty) {
+      dirty = true;
+      dirtyFirst = first;
+      dirtyLast = last;
+      return;
+    }
+    if (first < dirtyFirst) {
+      dirtyFirst = first;
+    }
+    if (last > dirtyLast) {
+      dirtyLast = last;
+    }
+  }
+
+  /**
+   * @brief 前回の出力から変更があるかどうか
+   *
+   * @return 変更がある場合は true
+   */
+  bool isDirty() const { return dirty; }
+
+  /**
+   * @brief 変更された範囲の最初のLEDの番号を取得する
+   *
+   * @return 最初のLEDの番号（変更がない場合は不定）
+   */
+  uint16_t dirtyBegin() const { return dirtyFirst; }
+
+  /**
+   * @brief 変更された範囲の最後のLEDの番号を取得する
+   *
+   * @return 最後のLEDの番号（変更がない場合は不定）
+   */
+  uint16_t dirtyEnd() const { return dirtyLast; }
+
+  /**
+   * @brief リフレッシュレートの上限を設定する
+   *
+   * 上限を超える頻度で `show()` を呼び出した場合、変更は次の `show()` まで保留されます。
+   *
+   * @param framesPerSecond 1秒あたりの最大フレーム数（0の場合は上限なし）
+   */
+  void setMaxRefreshRate(uint8_t framesPerSecond) {
+    minInterval = framesPerSecond == 0 ? 0 : 1000 / framesPerSecond;
+  }
+
+  /**
+   * @brief 変更がある場合だけLEDテープに出力する
+   *
+   * 先頭から変更された範囲の最後のLEDまでを出力します。
+   * 出力を要求されたフレームとして数えます。
+   *
+   * @param now 現在の時刻（ミリ秒）。通常は `millis()` の値
+   * @param force true の場合はリフレッシュレートの上限を無視する
+   * @return LEDテープに出力した場合は true
+   */
+  bool show(unsigned long now, bool force = false) {
+    requested++;
+    return flush(now, force);
+  }
+
+  /**
+   * @brief リフレッシュレートの上限で保留された変更を出力する
+   *
+   * `show()` と異なり、出力を要求されたフレームとして数えません。
+   *
+   * @param now 現在の時刻（ミリ秒）。通常は `millis()` の値
+   * @param force true の場合はリフレッシュレートの上限を無視する
+   * @return LEDテープに出力した場合は true
+   */
+  bool flush(unsigned long now, bool force = false) {
+    if (!dirty) {
+      return false;
+    }
+    if (!force && shown && now - lastShowTime < minInterval) {
+      return false;
+    }
+    if (output != nullptr) {
+      // 変更された範囲より後ろのLEDは、前回の色を保持している
+      output->show(leds, dirtyLast + 1);
+    }
+    dirty = false;
+    shown = true;
+    lastShowTime = now;
+    pushed++;
+    return true;
+  }
+
+  /**
+   * @brief `show()` が呼び出された回数を取得する
+   *
+   * @return 出力を要求されたフレームの数
+   */
+  uint32_t requestedFrames() const { return requested; }
+
+  /**
+   * @brief 実際にLEDテープに出力した回数を取得する
+   *
+   * @return 出力したフレームの数
+   */
+  uint32_t pushedFrames() const { return pushed; }
+
+  /**
+   * @brief フレームの数をリセットする
+   */
+  void resetCounters() {
+    requested = 0;
+    pushed = 0;
+  }
+
+private:
+  CRGB *leds;                     ///< LED配列
+  uint16_t numLeds;               ///< LEDの数
+  LedOutput *output;              ///< 出力先
+  bool dirty = false;             ///< 前回の出力から変更があるかどうか
+  uint16_t dirtyFirst = 0;        ///< 変更された範囲の最初のLEDの番号
+  uint16_t dirtyLast = 0;         ///< 変更された範囲の最後のLEDの番号
+  unsigned long minInterval = 0;  ///< 出力の最小間隔（ミリ秒）
+  unsigned long lastShowTime = 0; ///< 前回出力した時刻
+  bool shown = false;             ///< 1回以上出力したかどうか
+  uint32_t requested = 0;         ///< 出力を要求されたフレームの数
+  uint32_t pushed = 0;            ///< 出力したフレームの数
+};
@@ -0,0 +1,148 @@
+/**
+ * @file LedGamma.h
+ * @brief LEDの明るさを人の目の感じ方に合わせるガンマ補正テーブル
+ *
+ * LEDの明るさは出力値に比例しますが、人の目は暗い部分の変化に敏感なため、
+ * 出力値をそのまま使用すると明るい部分の変化が分かりにくくなります。
+ * このファイルで定義する `LedGamma` クラスは、出力値を
+ * `255 * (value / 255) ^ gamma` に変換するテーブルをコンパイル時に計算し、
+ * フラッシュメモリに配置します。実行時の変換は1回のテーブル参照だけです。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <stdint.h>
+#include <types/IndexSequence.h>
+
+/**
+ * @class LedGammaCurve
+ * @brief ガンマ補正の値をコンパイル時に計算するクラス
+ *
+ * C++11の `constexpr` 関数は1つの `return` 文しか書けないため、
+ * 対数と指数関数を再帰で計算します。
+ */
+class LedGammaCurve {
+public:
+  /**
+   * @brief ガンマ補正した値を計算する
+   *
+   * @param gamma10 ガンマ値の10倍（例：2.8の場合は28）
+   * @param value 補正前の値
+   * @return 補正後の値（`255 * (value / 255) ^ gamma` を四捨五入した値）
+   */
+  static constexpr uint8_t compute(uint8_t gamma10, uint8_t value) {
+    return value == 0
+               ? 0
+               : static_cast<uint8_t>(
+                     255.0 * exp(gamma10 / 10.0 * (ln(value) - ln(255))) +
+                     0.5);
+  }
+
+private:
+  /// 2の自然対数
+  static constexpr double LN2 = 0.69314718055994530942;
+
+  /**
+   * @brief 1以上の値の自然対数を計算する
+   *
+   * 値を2で割り、1以上2未満にしてから級数で計算します。
+   */
+  static constexpr double ln(double x, int exponent = 0) {
+    return x >= 2.0 ? ln(x / 2.0, exponent + 1)
+                    : exponent * LN2 +
+                          2.0 * atanh((x - 1.0) / (x + 1.0),
+                                      (x - 1.0) / (x + 1.0) *
+                                          ((x - 1.0) / (x + 1.0)),
+                                      (x - 1.0) / (x + 1.0), 1);
+  }
+
+  /**
+   * @brief 逆双曲線正接の級数 `y + y^3 / 3 + y^5 / 5 + ...` を計算する
+   *
+   * `y` は1/3未満のため、20項で十分な精度になります。
+   */
+  static constexpr double atanh(double y, double y2, double power, int n) {
+    return n > 41 ? 0.0 : power / n + atanh(y, y2, power * y2, n + 2);
+  }
+
+  /**
+   * @brief 指数関数を計算する
+   *
+   * 負の値は、正の値の逆数として計算します（級数の桁落ちを避けるため）。
+   */
+  static constexpr double exp(double x) {
+    return x < 0.0 ? 1.0 / expSeries(-x, 1.0, 1) : expSeries(x, 1.0, 1);
+  }
+
+  /**
+   * @brief 指数関数の級数 `1 + x + x^2 / 2! + ...` を計算する
+   */
+  static constexpr double expSeries(double x, double term, int n) {
+    return n > 80 ? term : term + expSeries(x, term * x / n, n + 1);
+  }
+};
+
+/**
+ * @brief ガンマ補正テーブルの実体を保持するクラス
+ *
+ * @tparam gamma10 ガンマ値の10倍
+ * @tparam Indices テーブルの添字の連番
+ */
+template <uint8_t gamma10, typename Indices> struct LedGammaTable;
+
+/**
+ * @brief 連番を展開してテーブルを初期化するための部分特殊化
+ *
+ * @tparam gamma10 ガンマ値の10倍
+ * @tparam indices 0から255までの連番
+ */
+template <uint8_t gamma10, uint16_t... indices>
+struct LedGammaTable<gamma10, IndexSequence<indices...>> {
+  /// ガンマ補正した値のテーブル（フラッシュメモリ上）
+  static const uint8_t values[256];
+};
+
+template <uint8_t gamma10, uint16_t... indices>
+const uint8_t
+    LedGammaTable<gamma10, IndexSequence<indices...>>::values[256] PROGMEM = {
+        LedGammaCurve::compute(gamma10, indices)...};
+
+/**
+ * @class LedGamma
+ * @brief フラッシュメモリ上のテーブルを使用してガンマ補正を行うクラス
+ *
+ * 使用例:
+ * @code
+ * uint8_t corrected = LedGamma<>::apply(128); // 2.8の場合は37
+ * @endcode
+ *
+ * @tparam gamma10 ガンマ値の10倍（デフォルトは28、つまり2.8）
+ */
+template <uint8_t gamma10 = 28> class LedGamma {
+public:
+  /// テーブルの実体
+  using Table =
+      LedGammaTable<gamma10, typename MakeIndexSequence<256>::Type>;
+
+  /**
+   * @brief 値をガンマ補正する
+   *
+   * @param value 補正前の値
+   * @return 補正後の値
+   */
+  static uint8_t apply(uint8_t value) {
+    return pgm_read_byte(&Table::values[value]);
+  }
+
+  /**
+   * @brief 色の各チャンネルをガンマ補正する
+   *
+   * @param color 補正前の色
+   * @return 補正後の色
+   */
+  static CRGB apply(const CRGB &color) {
+    return CRGB(apply(color.r), apply(color.g), apply(color.b));
+  }
+};
@@ -0,0 +1,187 @@
+/**
+ * @file LedOutput.h
+ * @brief LED配列をLEDテープに出力するクラス定義
+ *
+ * このファイルには、LED配列の内容をLEDテープに出力する処理の
+ * 抽象基底クラス `LedOutput` と、FastLEDを使用して出力する
+ * `FastLedOutput` クラスが定義されています。
+ * 出力先を差し替えることで、LEDテープがなくても描画結果を確認できます。
+ *
+ * 全体の明るさとガンマ補正は出力時に適用するため、明るさを変更しても
+ * LED配列を書き換える必要はありません。
+ */
+
+#pragma once
+
+#include <FastLED.h>
+#include <parts/ledtapes/LedGamma.h>
+#include <stdint.h>
+
+/**
+ * @class LedOutput
+ * @brief LED配列をLEDテープに出力するための抽象基底クラス
+ */
+class LedOutput {
+public:
+  /**
+   * @brief デストラクタ
+   *
+   * 派生クラスのオブジェクトを `LedOutput` のポインタで破棄できるように仮想にします。
+   */
+  virtual ~LedOutput() {}
+
+  /**
+   * @brief LED配列の内容をLEDテープに出力する
+   *
+   * `numLeds` がLEDテープのLEDの数より少ない場合は、先頭の `numLeds` 個だけを出力します。
+   * 残りのLEDは前回出力した色のままです（`LedFrameBuffer` が変更のない後ろのLEDを
+   * 省略するために使用します）。
+   *
+   * @param leds 出力するLED配列
+   * @param numLeds 出力するLEDの数
+   */
+  virtual void show(const CRGB *leds, uint16_t numLeds) = 0;
+
+  /**
+   * @brief 全体の明るさを設定する
+   *
+   * 出力時に各チャンネルに掛けるため、LED配列は変更されません。
+   * 次の `show()` から反映されます。
+   *
+   * @param brightness 明るさ（0～255、デフォルトは255）
+   */
+  void setBrightness(uint8_t brightness) { this->brightness = brightness; }
+
+  /**
+   * @brief 全体の明るさを取得する
+   *
+   * @return 明るさ（0～255）
+   */
+  uint8_t getBrightness() const { return brightness; }
+
+  /**
+   * @brief ガンマ補正を有効にするかどうかを設定する
+   *
+   * 有効にすると、明るさを人の目の感じ方に合わせて補正します（`LedGamma`）。
+   *
+   * @param enabled 有効にする場合は true（デフォルトは false）
+   */
+  void setGammaCorrection(bool enabled) { gammaCorrection = enabled; }
+
+protected:
+  /// 全体の明るさ
+  uint8_t brightness = 255;
+  /// ガンマ補正が有効かどうか
+  bool gammaCorrection = false;
+
+  /**
+   * @brief 出力時に掛ける明るさを取得する
+   *
+   * ガンマ補正が有効な場合は、明るさも補正します。
+   * `(value / 255) ^ gamma` は値と明るさの積に対して分配できるため、
+   * 色を補正した後に補正済みの明るさを掛ければ、積を補正したものと等しくなります。
+   *
+   * @return 出力時に掛ける明るさ
+   */
+  uint8_t outputScale() const {
+    return gammaCorrection ? LedGamma<>::apply(brightness) : brightness;
+  }
+
+  /**
+   * @brief 1チャンネルの値を出力する値に変換する
+   *
+   * ガンマ補正のテーブル参照と、明るさの掛け算を行います。
+   *
+   * @param value LED配列のチャンネルの値
+   * @param scale `outputScale()` の値
+   * @return 出力する値
+   */
+  uint8_t correct(uint8_t value, uint8_t scale) const {
+    if (gammaCorrection) {
+      value = LedGamma<>::apply(value);
+    }
+    return scale == 255 ? value : scale8(value, scale);
+  }
+};
+
+/**
+ * @class FastLedOutput
+ * @brief FastLEDのコントローラーを使用してLEDテープに出力するクラス
+ *
+ * `FastLED.show()` は登録された全てのLEDテープに出力しますが、
+ * このクラスは指定したコントローラーのLEDテープだけに出力します。
+ *
+ * 全体の明るさは、FastLEDが出力時に各チャンネルに掛けます。
+ * FastLEDは出力時にテーブルを参照できないため、ガンマ補正が有効な場合は、
+ * 補正した色を作業用のLED配列に書き込んでから出力します。作業用のLED配列は
+ * `setGammaBuffer()` で呼び出し元が用意します（LED1つあたり3バイト）。
+ * 設定していない場合や、出力するLEDの数より小さい場合は、明るさだけを補正します。
+ * SRAMを増やさずに色を補正する場合は `Ws2812Output` を使用してください。
+ *
+ * 使用例:
+ * @code
+ * CRGB gammaBuffer[30];
+ * output.setGammaBuffer(gammaBuffer, 30);
+ * output.setGammaCorrection(true);
+ * @endcode
+ */
+class FastLedOutput : public LedOutput {
+public:
+  /**
+   * @brief 出力に使用するコントローラーを設定する
+   *
+   * @param controller `FastLED.addLeds()` が返すコントローラー
+   */
+  void setController(CLEDController *controller) {
+    this->controller = controller;
+  }
+
+  /**
+   * @brief ガンマ補正した色を書き込む作業用のLED配列を設定する
+   *
+   * 出力するLED配列とは別の配列を指定してください。
+   *
+   * @param buffer 作業用のLED配列（nullptr の場合は明るさだけを補正する）
+   * @param size 作業用のLED配列のLEDの数
+   */
+  void setGammaBuffer(CRGB *buffer, uint16_t size) {
+    this->buffer = buffer;
+    bufferSize = buffer != nullptr ? size : 0;
+  }
+
+  /**
+   * @brief LED配列の内容をLEDテープに出力する
+   *
+   * コントローラーが設定されていない場合は何もしません。
+   * ガンマ補正が有効で作業用のLED配列が足りる場合は、チャンネルごとに補正した色を
+   * 出力します。足りない場合は明るさだけを補正します。
+   *
+   * @param leds 出力するLED配列
+   * @param numLeds 出力するLEDの数（コントローラーに登録したLEDの数以下）
+   */
+  void show(const CRGB *leds, uint16_t numLeds) override {
+    if (controller == nullptr) {
+      return;
+    }
+    if (gammaCorrection && numLeds <= bufferSize) {
+      // 明るさはFastLEDが掛けるため、ここでは色の補正だけを行う
+      for (uint16_t i = 0; i < numLeds; i++) {
+        buffer[i].r = correct(leds[i].r, 255);
+        buffer[i].g = correct(leds[i].g, 255);
+        buffer[i].b = correct(leds[i].b, 255);
+      }
+      leds = buffer;
+    }
+    // FastLED.setBrightness() で設定した明るさも掛ける
+    controller->show(leds, numLeds,
+                     scale8(outputScale(), FastLED.getBrightness()));
+  }
+
+private:
+  /// 出力に使用するコントローラー（未設定の場合は nullptr）
+  CLEDController *controller = nullptr;
+  /// ガンマ補正した色を書き込む作業用のLED配列（未設定の場合は nullptr）
+  CRGB *buffer = nullptr;
+  /// 作業用のLED配列のLEDの数
+  uint16_t bufferSize = 0;
+};
@@ -0,0 +1,313 @@
+/**
+ * @file LedTapeEffects.h
+ * @brief LEDテープの光り方を1フレームずつ描画するクラス定義
+ *
+ * このファイルには、LEDテープの光り方（エフェクト）を表すクラスが定義されています。
+ * 各エフェクトは状態を持つオブジェクトで、`update()` を呼び出すたびに
+ * 必要であれば1フレームだけ描画してすぐに戻ります。`delay()` を使用しないため、
+ * モーターの制御や無線通信と同時にLEDテープを光らせることができます。
+ *
+ * エフェクトは `CRGB` の配列に描画するだけで、LEDテープへの出力は行いません。
+ * 出力は `LedTape::update()` などの呼び出し元が行います。
+ */
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @class LedTapeEffect
+ * @brief LEDテープのエフェクトの抽象基底クラス
+ *
+ * フレームの間隔の管理を行い、フレームの描画は派生クラスの `render()` に任せます。
+ */
+class LedTapeEffect {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param interval フレームの間隔（ミリ秒）
+   */
+  LedTapeEffect(unsigned long interval) : interval(interval) {}
+
+  /**
+   * @brief 必要であれば次のフレームを描画する
+   *
+   * 前回のフレームから `interval` ミリ秒以上経過している場合に1フレームだけ描画します。
+   * 最初の呼び出しでは、すぐに最初のフレームを描画します。
+   *
+   * @param leds 描画先のLED配列
+   * @param numLeds LEDの数
+   * @param now 現在の時刻（ミリ秒）。通常は `millis()` の値
+   * @return LED配列の内容を変更した場合は true
+   */
+  bool update(CRGB *leds, uint16_t numLeds, unsigned long now) {
+    if (started && now - lastFrameTime < interval) {
+      return false;
+    }
+    started = true;
+    lastFrameTime = now;
+    return render(leds, numLeds, frame++);
+  }
+
+  /**
+   * @brief エフェクトを最初のフレームからやり直す
+   */
+  void reset() {
+    started = false;
+    frame = 0;
+    restart();
+  }
+
+  /**
+   * @brief 次に描画するフレームの番号を取得する
+   *
+   * @return フレームの番号（0から始まる）
+   */
+  uint16_t frameNumber() const { return frame; }
+
+protected:
+  /**
+   * @brief 1フレームを描画する
+   *
+   * @param leds 描画先のLED配列
+   * @param numLeds LEDの数
+   * @param frame フレームの番号（0から始まる）
+   * @return LED配列の内容を変更した場合は true
+   */
+  virtual bool render(CRGB *leds, uint16_t numLeds, uint16_t frame) = 0;
+
+  /**
+   * @brief エフェクト固有の状態を最初のフレームに戻す
+   *
+   * `reset()` から呼び出されます。フレームの番号は65536フレームで0に戻るため、
+   * 最初のフレームかどうかを番号で判定できないエフェクトが上書きします。
+   */
+  virtual void restart() {}
+
+  /**
+   * @brief フレームの間隔を変更する
+   *
+   * フレームごとに表示時間が異なるエフェクトで、`render()` の中から呼び出します。
+   *
+   * @param interval 次のフレームまでの間隔（ミリ秒）
+   */
+  void setInterval(unsigned long interval) { this->interval = interval; }
+
+private:
+  unsigned long interval;          ///< フレームの間隔（ミリ秒）
+  unsigned long lastFrameTime = 0; ///< 前回のフレームを描画した時刻
+  uint16_t frame = 0;              ///< 次に描画するフレームの番号
+  bool started = false;            ///< 最初のフレームを描画したかどうか
+};
+
+/**
+ * @class SolidColorEffect
+ * @brief LEDテープ全体を単色で光らせるエフェクト
+ *
+ * 最初のフレームで全てのLEDを塗りつぶし、以降は `reset()` を呼び出すまで
+ * 何も描画しません（フレームの番号が0に戻っても描画し直しません）。
+ */
+class SolidColorEffect : public LedTapeEffect {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param color 光らせたい色（0xRRGGBB形式）
+   */
+  SolidColorEffect(uint32_t color) : LedTapeEffect(0), color(color) {}
+
+protected:
+  bool render(CRGB *leds, uint16_t numLeds, uint16_t) override {
+    if (drawn) {
+      return false;
+    }
+    fill_solid(leds, numLeds, CRGB(color));
+    drawn = true;
+    return true;
+  }
+
+  void restart() override { drawn = false; }
+
+private:
+  uint32_t color;     ///< 光らせる色
+  bool drawn = false; ///< 描画したかどうか
+};
+
+/**
+ * @class BlinkEffect
+ * @brief LEDテープ全体を点滅させるエフェクト
+ *
+ * 偶数番目のフレームで指定した色、奇数番目のフレームで黒を描画します。
+ */
+class BlinkEffect : public LedTapeEffect {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param color 点滅させたい色（0xRRGGBB形式）
+   * @param interval 点滅の間隔（ミリ秒）
+   */
+  BlinkEffect(uint32_t color, unsigned long interval)
+      : LedTapeEffect(interval), color(color) {}
+
+protected:
+  bool render(CRGB *leds, uint16_t numLeds, uint16_t frame) override {
+    fill_solid(leds, numLeds, (frame & 1) ? CRGB(CRGB::Black) : CRGB(color));
+    return true;
+  }
+
+private:
+  uint32_t color; ///< 点滅させる色
+};
+
+/**
+ * @class RainbowEffect
+ * @brief LEDテープにレインボー色のグラデーションを流すエフェクト
+ *
+ * フレームごとに色相を1ずつずらします。256フレームで1周します。
+ *
+ * 次のフレームは前のフレームを1つずらしたものになるため、2フレーム目以降は
+ * LED配列を1つずらし、新しく現れる最後のLEDだけを色変換します。
+ * そのため、再生中に他の処理でLED配列を書き換えた場合は `reset()` を呼び出してください。
+ */
+class RainbowEffect : public LedTapeEffect {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param interval 色が変わる間隔（ミリ秒）
+   */
+  RainbowEffect(unsigned long interval) : LedTapeEffect(interval) {}
+
+protected:
+  bool render(CRGB *leds, uint16_t numLeds, uint16_t frame) override {
+    if (numLeds == 0) {
+      return false;
+    }
+    // 色相は256で1周するため、uint8_tの桁あふれをそのまま利用する
+    uint8_t hue = static_cast<uint8_t>(frame);
+    if (frame == 0 || leds != renderedLeds || numLeds != renderedNumLeds) {
+      // 最初のフレームは全てのLEDを色変換する
+      for (uint16_t i = 0; i < numLeds; i++) {
+        leds[i] = CHSV(hue++, 255, 255);
+      }
+      renderedLeds = leds;
+      renderedNumLeds = numLeds;
+    } else {
+      // 前のフレームを1つずらし、最後のLEDだけを色変換する
+      memmove(leds, leds + 1, (numLeds - 1) * sizeof(CRGB));
+      leds[numLeds - 1] =
+          CHSV(static_cast<uint8_t>(hue + numLeds - 1), 255, 255);
+    }
+    return true;
+  }
+
+private:
+  const CRGB *renderedLeds = nullptr; ///< 前のフレームを描画したLED配列
+  uint16_t renderedNumLeds = 0;       ///< 前のフレームを描画したLEDの数
+};
+
+/**
+ * @class ChaseEffect
+ * @brief LEDテープの1つのLEDだけを順番に光らせるエフェクト
+ *
+ * フレームごとに光らせるLEDを1つずつ進め、最後のLEDの次は最初のLEDに戻ります。
+ * 光らせる位置はフレームの番号ではなく自身で数えるため、フレームの番号が
+ * 0に戻っても位置は飛びません。
+ */
+class ChaseEffect : public LedTapeEffect {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param color 光らせる色（0xRRGGBB形式）
+   * @param interval LEDが移動する間隔（ミリ秒）
+   */
+  ChaseEffect(uint32_t color, unsigned long interval)
+      : LedTapeEffect(interval), color(color) {}
+
+protected:
+  bool render(CRGB *leds, uint16_t numLeds, uint16_t) override {
+    if (numLeds == 0) {
+      return false;
+    }
+    // 前のフレームで光らせたLEDを消す
+    if (lit < numLeds) {
+      leds[lit] = CRGB::Black;
+    }
+    if (position >= numLeds) {
+      position = 0;
+    }
+    leds[position] = color;
+    lit = position;
+    position++;
+    return true;
+  }
+
+  void restart() override {
+    position = 0;
+    lit = NONE;
+  }
+
+private:
+  /// 光らせたLEDがないことを示す値
+  static const uint16_t NONE = 0xFFFF;
+
+  uint32_t color;        ///< 光らせる色
+  uint16_t position = 0; ///< 次に光らせるLEDの位置
+  uint16_t lit = NONE;   ///< 前のフレームで光らせたLEDの位置
+};
+
+/**
+ * @class GradientEffect
+ * @brief ベースカラーから黒へのグラデーションを表示するエフェクト
+ *
+ * 最初のLEDが最も暗く、最後のLEDがベースカラーに最も近い明るさになります。
+ * 最初のフレームで描画し、以降は `reset()` を呼び出すまで何も描画しません。
+ */
+class GradientEffect : public LedTapeEffect {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param baseColor グラデーションのベースカラー（0xRRGGBB形式）
+   */
+  GradientEffect(uint32_t baseColor) : LedTapeEffect(0), baseColor(baseColor) {}
+
+protected:
+  bool render(CRGB *leds, uint16_t numLeds, uint16_t) override {
+    if (drawn || numLeds == 0) {
+      return false;
+    }
+    drawn = true;
+    // LEDごとの明るさは 255 * i / numLeds を切り上げた値
+    // 除算を避けるため、1つ進むごとの商と余りを先に求めて足していく
+    uint8_t stepQuotient = 255 / numLeds;
+    uint16_t stepRemainder = 255 % numLeds;
+    uint8_t quotient = 0;
+    uint16_t remainder = 0;
+    CRGB color = CRGB(baseColor);
+    for (uint16_t i = 0; i < numLeds; i++) {
+      uint8_t scale = quotient + (remainder != 0 ? 1 : 0);
+      leds[i] = color;
+      leds[i].nscale8(scale);
+
+      quotient += stepQuotient;
+      remainder += stepRemainder;
+      if (remainder >= numLeds) {
+        remainder -= numLeds;
+        quotient++;
+      }
+    }
+    return true;
+  }
+
+  void restart() override { drawn = false; }
+
+private:
+  uint32_t baseColor; ///< グラデーションのベースカラー
+  bool drawn = false; ///< 描画したかどうか
+};
@@ -0,0 +1,138 @@
+/**
+ * @file LedTapePlayer.h
+ * @brief フラッシュメモリに格納した光り方を再生するクラス定義
+ *
+ * このファイルには、ランレングス圧縮と差分フレームで記録した光り方（ライトショー）を
+ * 再生する `LedTapePlayer` クラスが定義されています。
+ * データはPC上で `scripts/encode_led_rle.py` を使用して作成します。
+ *
+ * データの形式（数値はリトルエンディアン）:
+ *
+ * | バイト数 | 内容                 |
+ * | -------- | -------------------- |
+ * | 2        | LEDの数              |
+ * | 2        | フレームの数         |
+ * | 可変     | フレームの並び       |
+ *
+ * 各フレームは、表示時間（2バイト、ミリ秒）と、LEDの数に達するまで続く命令の並びです。
+ *
+ * | 命令            | 内容                                              |
+ * | --------------- | ------------------------------------------------- |
+ * | `0nnnnnnn`      | `n + 1` 個のLEDを前のフレームのまま残す           |
+ * | `1nnnnnnn R G B`| `n + 1` 個のLEDを色（R, G, B）で塗る              |
+ *
+ * 最初のフレームは全てのLEDを塗る命令だけで構成されます（繰り返し再生の起点になるため）。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <parts/ledtapes/LedTapeEffects.h>
+#include <stdint.h>
+
+/**
+ * @class LedTapePlayer
+ * @brief フラッシュメモリに格納した光り方を1フレームずつ再生するエフェクト
+ *
+ * フレームの命令をLED配列に直接展開するため、フレームのためのメモリを確保しません。
+ * フレームの表示時間はフレームごとに指定できます。
+ *
+ * 使用例:
+ * @code
+ * #include "show.h" // encode_led_rle.py で作成した const uint8_t show[] PROGMEM
+ *
+ * StaticLedTape<6, 30> ledTape;
+ * LedTapePlayer player(show);
+ *
+ * void setup() { ledTape.play(player); }
+ * void loop() { ledTape.update(); }
+ * @endcode
+ */
+class LedTapePlayer : public LedTapeEffect {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param data フラッシュメモリ上のデータ（`PROGMEM`）
+   * @param loop 最後のフレームの後に最初から繰り返すかどうか（デフォルトは true）
+   */
+  LedTapePlayer(const uint8_t *data, bool loop = true)
+      : LedTapeEffect(0), data(data), loop(loop) {}
+
+  /**
+   * @brief 再生が終わったかどうか
+   *
+   * @return 繰り返さない設定で、最後のフレームまで表示した場合は true
+   */
+  bool finished() const { return done; }
+
+protected:
+  bool render(CRGB *leds, uint16_t numLeds, uint16_t) override {
+    // 再生前、または最後のフレームの後で繰り返す場合は先頭に戻る
+    // （フレームの番号は65536フレームで0に戻るため、読み込む位置で判定する）
+    if (offset == 0 || (framesLeft == 0 && loop)) {
+      offset = HEADER_SIZE;
+      framesLeft = readWord(2);
+      done = false;
+    }
+    if (framesLeft == 0) {
+      return false;
+    }
+
+    // 次のフレームまでの間隔
+    setInterval(readWord(offset));
+    offset += 2;
+
+    uint16_t dataLeds = readWord(0);
+    uint16_t position = 0;
+    while (position < dataLeds) {
+      uint8_t command = pgm_read_byte(data + offset++);
+      uint8_t count = (command & 0x7F) + 1;
+      if (command & 0x80) {
+        // 色で塗る
+        CRGB color(pgm_read_byte(data + offset), pgm_read_byte(data + offset + 1),
+                   pgm_read_byte(data + offset + 2));
+        offset += 3;
+        for (uint8_t i = 0; i < count; i++, position++) {
+          if (position < numLeds) {
+            leds[position] = color;
+          }
+        }
+      } else {
+        // 前のフレームのまま残す
+        position += count;
+      }
+    }
+    framesLeft--;
+    done = framesLeft == 0 && !loop;
+    return true;
+  }
+
+  void restart() override {
+    offset = 0;
+    framesLeft = 0;
+    done = false;
+  }
+
+private:
+  /// データの先頭にある、LEDの数とフレームの数のバイト数
+  static const uint8_t HEADER_SIZE = 4;
+
+  const uint8_t *data;     ///< フラッシュメモリ上のデータ
+  bool loop;               ///< 最後のフレームの後に繰り返すかどうか
+  uint16_t offset = 0;     ///< 次に読み込む位置（再生前は0）
+  uint16_t framesLeft = 0; ///< 残りのフレームの数
+  bool done = false;       ///< 再生が終わったかどうか
+
+  /**
+   * @brief データから2バイトの数値を読み込む
+   *
+   * @param position 読み込む位置
+   * @return 読み込んだ数値
+   */
+  uint16_t readWord(uint16_t position) const {
+    return pgm_read_byte(data + position) |
+           (pgm_read_byte(data + position + 1) << 8);
+  }
+};
@@ -0,0 +1,184 @@
+/**
+ * @file PaletteFrameBuffer.h
+ * @brief LEDの色をパレットの番号で保持するフレームバッファのクラス定義
+ *
+ * `CRGB` の配列はLED1つあたり3バイトのSRAMを使用するため、ATmega328P（SRAM 2KB）では
+ * 300個のLEDだけで900バイトを使用してしまいます。このファイルで定義する
+ * `PaletteFrameBuffer` クラスは、LEDごとに4ビットまたは8ビットのパレットの番号だけを
+ * 保持し、出力時にパレットを参照して色に戻します。
+ *
+ * | 形式          | LED1つあたり | 300個のLED（パレットを含む） |
+ * | ------------- | ------------ | ---------------------------- |
+ * | `CRGB` の配列 | 3バイト      | 900バイト                    |
+ * | 8ビット       | 1バイト      | 300バイト + 3バイト × 色数   |
+ * | 4ビット       | 0.5バイト    | 150バイト + 48バイト         |
+ */
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @class PaletteFrameBuffer
+ * @brief LEDの色をパレットの番号で保持するフレームバッファ
+ *
+ * 出力は `Ws2812Output::stream()` で行い、LEDを1つ送信するたびにパレットを参照します。
+ * そのため、`CRGB` の配列を用意する必要はありません。
+ *
+ * 使用例:
+ * @code
+ * PaletteFrameBuffer<300> frameBuffer; // 4ビット（16色）
+ * Ws2812Output<6> output;
+ *
+ * void setup() {
+ *   frameBuffer.setPaletteColor(1, LedTape::Red);
+ *   frameBuffer.setPaletteColor(2, LedTape::Blue);
+ *   frameBuffer.fill(1);
+ *   frameBuffer.set(0, 2);
+ *   frameBuffer.show(output);
+ * }
+ * @endcode
+ *
+ * @tparam NumLeds LEDの数
+ * @tparam bitsPerLed LED1つあたりのビット数（4または8、デフォルトは4）
+ * @tparam paletteSize パレットの色数（デフォルトは16）。
+ * 8ビットの場合は256色まで指定できますが、パレットは1色あたり3バイトのSRAMを使用します。
+ */
+template <uint16_t NumLeds, uint8_t bitsPerLed = 4, uint16_t paletteSize = 16>
+class PaletteFrameBuffer {
+  static_assert(bitsPerLed == 4 || bitsPerLed == 8,
+                "LED1つあたりのビット数は4または8でなければなりません");
+  static_assert(paletteSize >= 1 && paletteSize <= (1 << bitsPerLed),
+                "パレットの色数が多すぎます");
+
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * 全てのLEDをパレットの0番に、パレットの全ての色を黒に初期化します。
+   */
+  PaletteFrameBuffer() {
+    memset(indices, 0, sizeof(indices));
+    for (uint16_t i = 0; i < paletteSize; i++) {
+      palette[i] = CRGB(0, 0, 0);
+    }
+  }
+
+  /**
+   * @brief LEDの数を取得する
+   *
+   * @return LEDの数
+   */
+  uint16_t size() const { return NumLeds; }
+
+  /**
+   * @brief パレットの色を設定する
+   *
+   * パレットの色を変えると、その番号のLEDの色がまとめて変わります。
+   *
+   * @param index パレットの番号
+   * @param color 設定する色（`LedTape::Red` などの `HTMLColorCode` も指定できる）
+   */
+  void setPaletteColor(uint8_t index, const CRGB &color) {
+    if (index >= paletteSize || palette[index] == color) {
+      return;
+    }
+    palette[index] = color;
+    dirty = true;
+  }
+
+  /**
+   * @brief パレットの色を取得する
+   *
+   * @param index パレットの番号
+   * @return パレットの色
+   */
+  CRGB getPaletteColor(uint8_t index) const {
+    return index < paletteSize ? palette[index] : CRGB(0, 0, 0);
+  }
+
+  /**
+   * @brief 1つのLEDのパレットの番号を設定する
+   *
+   * @param led LEDの番号
+   * @param index パレットの番号
+   */
+  void set(uint16_t led, uint8_t index) {
+    if (led >= NumLeds || index >= paletteSize || get(led) == index) {
+      return;
+    }
+    if (bitsPerLed == 8) {
+      indices[led] = index;
+    } else {
+      // 偶数番目のLEDは下位4ビット、奇数番目のLEDは上位4ビットに格納する
+      uint8_t &pair = indices[led >> 1];
+      pair = (led & 1) ? (pair & 0x0F) | (index << 4) : (pair & 0xF0) | index;
+    }
+    dirty = true;
+  }
+
+  /**
+   * @brief 1つのLEDのパレットの番号を取得する
+   *
+   * @param led LEDの番号（`NumLeds` 未満）
+   * @return パレットの番号
+   */
+  uint8_t get(uint16_t led) const {
+    if (bitsPerLed == 8) {
+      return indices[led];
+    }
+    uint8_t pair = indices[led >> 1];
+    return (led & 1) ? pair >> 4 : pair & 0x0F;
+  }
+
+  /**
+   * @brief 全てのLEDを同じパレットの番号に設定する
+   *
+   * @param index パレットの番号
+   */
+  void fill(uint8_t index) {
+    if (index >= paletteSize) {
+      return;
+    }
+    uint8_t value = bitsPerLed == 8 ? index : (index << 4) | index;
+    memset(indices, value, sizeof(indices));
+    dirty = true;
+  }
+
+  /**
+   * @brief LEDの色を取得する
+   *
+   * `Ws2812Output::stream()` から、LEDを1つ送信するたびに呼び出されます。
+   *
+   * @param led LEDの番号（`NumLeds` 未満）
+   * @return LEDの色
+   */
+  CRGB operator()(uint16_t led) const { return palette[get(led)]; }
+
+  /**
+   * @brief 変更がある場合だけLEDテープに出力する
+   *
+   * @tparam Output `stream()` を持つ出力先の型。例：`Ws2812Output`
+   * @param output 出力先
+   * @param force true の場合は変更がなくても出力する
+   * @return LEDテープに出力した場合は true
+   */
+  template <typename Output> bool show(Output &output, bool force = false) {
+    if (!dirty && !force) {
+      return false;
+    }
+    output.stream(*this, NumLeds);
+    dirty = false;
+    return true;
+  }
+
+private:
+  /// LEDごとのパレットの番号（4ビットの場合は2つのLEDで1バイト）
+  uint8_t indices[bitsPerLed == 8 ? NumLeds : (NumLeds + 1) / 2];
+  /// パレット
+  CRGB palette[paletteSize];
+  /// 前回の出力から変更があるかどうか
+  bool dirty = true;
+};
@@ -0,0 +1,151 @@
+/**
+ * @file Ws2812Output.h
+ * @brief WS2812Bに直接出力するクラス定義
+ *
+ * このファイルには、FastLEDを使用せずにWS2812Bへ信号を出力する
+ * `Ws2812Output` クラスが定義されています。LEDを1つ出力するたびに色を変換するため、
+ * ガンマ補正や明るさの調整のために別のLED配列を用意する必要がありません。
+ *
+ * @note ATmega328Pなどの16MHzのAVRマイコン専用です。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <digitalWriteFast.h>
+#include <parts/ledtapes/LedOutput.h>
+#include <stdint.h>
+
+/**
+ * @class Ws2812Output
+ * @brief WS2812Bに直接出力し、出力時にガンマ補正と明るさの調整を行うクラス
+ *
+ * LEDの色を1つ取り出すたびに、チャンネルごとに1回のテーブル参照（ガンマ補正）と
+ * 1回の掛け算（明るさ）を行い、そのまま送信します。変換はLEDとLEDの間の
+ * Lowの期間に行います（WS2812Bは数µsまでのLowの延長を許容します）。
+ *
+ * 出力中は割り込みが禁止されます（LED1つあたり約30µs）。
+ *
+ * 使用例:
+ * @code
+ * StaticLedTape<6, 30> ledTape;
+ * Ws2812Output<6> output;
+ *
+ * void setup() {
+ *   output.setGammaCorrection(true);
+ *   ledTape.setOutput(output);
+ *   ledTape.setBrightness(64); // LED配列を書き換えずに暗くする
+ * }
+ * @endcode
+ *
+ * @tparam DataPin LED信号用のピン番号（コンパイル時に決まる必要があります）
+ */
+template <uint8_t DataPin> class Ws2812Output : public LedOutput {
+#if !defined(__AVR__) || F_CPU != 16000000L
+  static_assert(DataPin != DataPin,
+                "Ws2812Outputは16MHzのAVRマイコンでのみ使用できます");
+#endif
+
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * データピンを出力モードに設定します。
+   */
+  Ws2812Output() {
+    pinModeFast(DataPin, OUTPUT);
+    digitalWriteFast(DataPin, LOW);
+  }
+
+  /**
+   * @brief LED配列の内容をLEDテープに出力する
+   *
+   * @param leds 出力するLED配列
+   * @param numLeds LEDの数
+   */
+  void show(const CRGB *leds, uint16_t numLeds) override {
+    stream(ArraySource{leds}, numLeds);
+  }
+
+  /**
+   * @brief LEDの色を1つずつ取り出しながらLEDテープに出力する
+   *
+   * `source(i)` で `i` 番目のLEDの色を取り出します。
+   * LED配列を持たない形式（パレットなど）から直接出力する場合に使用します。
+   * 色の取り出しは数µs以内に終わる必要があります。
+   *
+   * @tparam Source `CRGB operator()(uint16_t index) const` を持つ型
+   * @param source LEDの色を取り出すオブジェクト
+   * @param numLeds LEDの数
+   */
+  template <typename Source>
+  void stream(const Source &source, uint16_t numLeds) {
+    uint8_t scale = outputScale();
+
+    // 前回の出力からリセット時間（新しいWS2812Bは280µs以上）が経つまで待つ
+    while (micros() - lastShowTime < 300)
+      ;
+
+    uint8_t oldSREG = SREG;
+    cli();
+    for (uint16_t i = 0; i < numLeds; i++) {
+      CRGB color = source(i);
+      // WS2812BはG、R、Bの順に受信する
+      uint8_t green = correct(color.g, scale);
+      uint8_t red = correct(color.r, scale);
+      uint8_t blue = correct(color.b, scale);
+      sendByte(green);
+      sendByte(red);
+      sendByte(blue);
+    }
+    SREG = oldSREG;
+    lastShowTime = micros();
+  }
+
+private:
+  /// 前回出力を終えた時刻（マイクロ秒）
+  unsigned long lastShowTime = 0;
+
+  /// LED配列から色を取り出すクラス
+  struct ArraySource {
+    const CRGB *leds; ///< LED配列
+
+    /// `index` 番目のLEDの色を取り出す
+    CRGB operator()(uint16_t index) const { return leds[index]; }
+  };
+
+  /**
+   * @brief 1バイトを上位ビットから送信する
+   *
+   * 16MHzで1ビットあたり19～20サイクル（約1.2µs）で送信します。
+   * - 0: High 5サイクル（0.31µs）、Low 15サイクル（0.94µs）
+   * - 1: High 13サイクル（0.81µs）、Low 6サイクル（0.38µs）
+   *
+   * @param value 送信する値
+   */
+  static inline __attribute__((always_inline)) void sendByte(uint8_t value) {
+#if defined(__AVR__)
+    uint8_t bits = 8;
+    asm volatile("1:\n\t"
+                 "sbi %[port], %[bit]\n\t" // 2: Highにする
+                 "nop\n\t"                 // 1
+                 "nop\n\t"                 // 1
+                 "sbrs %[value], 7\n\t"    // 1/2: 最上位ビットが1なら次を飛ばす
+                 "cbi %[port], %[bit]\n\t" // 2: 0の場合はここでLowにする
+                 "lsl %[value]\n\t"        // 1: 次のビットに進む
+                 "rjmp .+0\n\t"            // 2
+                 "rjmp .+0\n\t"            // 2
+                 "rjmp .+0\n\t"            // 2
+                 "cbi %[port], %[bit]\n\t" // 2: 1の場合はここでLowにする
+                 "nop\n\t"                 // 1
+                 "dec %[bits]\n\t"         // 1
+                 "brne 1b\n\t"             // 2
+                 : [value] "+r"(value), [bits] "+r"(bits)
+                 : [port] "I"(_SFR_IO_ADDR(*__digitalPinToPortReg(DataPin))),
+                   [bit] "I"(__digitalPinToBit(DataPin)));
+#else
+    (void)value;
+#endif
+  }
+};
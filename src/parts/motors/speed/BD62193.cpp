@@ -5,9 +5,8 @@
 // コンストラクタ: モーター制御用のピンを設定
 BD62193::BD62193(uint8_t inA_PIN, uint8_t inB_PIN, uint8_t pwm_PIN)
     : inA_PIN(inA_PIN), inB_PIN(inB_PIN), pwm_PIN(pwm_PIN),
-      speedAdjustable(true) {
-  // ピンを出力モードに設定
-  pinModeFast(pwm_PIN, OUTPUT);
+      speedAdjustable(true), pwmOutput(pwm_PIN) {
+  // ピンを出力モードに設定 (PWMピンは pwmOutput が設定)
   pinModeFast(inA_PIN, OUTPUT);
   pinModeFast(inB_PIN, OUTPUT);
 }
@@ -20,55 +19,56 @@ BD62193::BD62193(uint8_t inA_PIN, uint8_t inB_PIN)
   pinModeFast(inB_PIN, OUTPUT);
 }
 
-// モーターを制御する内部メソッド (PWMピンを使用する場合)
-void BD62193::run(bool inAState, bool inBState, uint8_t pwmValue) {
-  // PWMピンに指定されたPWM値を出力
-  analogWrite(pwm_PIN, pwmValue);
-  // inA_PINとinB_PINに指定された状態を出力
-  digitalWriteFast(inA_PIN, inAState);
-  digitalWriteFast(inB_PIN, inBState);
-}
-
-// モーターを制御する内部メソッド (PWMピンを使用しない場合)
-void BD62193::run(bool inAState, bool inBState) {
-  // inA_PINとinB_PINに指定された状態を出力
-  digitalWriteFast(inA_PIN, inAState);
-  digitalWriteFast(inB_PIN, inBState);
-}
-
 // 正転メソッド: モーターを前進させる
 void BD62193::forward() {
   // 最大出力で前進
-  setSpeed(1.0);
+  setPwm(255);
 }
 
 // 後転メソッド: モーターを後退させる
 void BD62193::reverse() {
   // 最大出力で後退
-  setSpeed(-1.0);
+  setPwm(-255);
 }
 
 // モーター停止メソッド: モーターを停止させる
 void BD62193::stop() {
-  // 速度を0に設定してモーターを停止
-  setSpeed(0);
+  // PWM値を0に設定してモーターを停止
+  setPwm(0);
 }
 
-// モーターの速度を設定するメソッド
-void BD62193::setSpeed(float rate) {
-  // スピードの範囲を-1.0から1.0に制限
-  rate = constrain(rate, -1.0, 1.0);
+// モーターの速度をPWM値で設定するメソッド
+void BD62193::setPwm(int16_t pwm) {
+  // PWM値の範囲を-255から255に制限
+  pwm = constrain(pwm, -255, 255);
 
-  if (rate == 0) {
-    // 速度が0の場合、モーターを停止
-    run(LOW, LOW);
-  } else if (!speedAdjustable) {
-    // PWMを使用しない場合、inAStateとinBStateを設定
-    run(rate > 0, rate < 0);
-  } else {
-    // 速度に応じたPWM値を計算
-    uint8_t pwmValue = (uint8_t)(abs(rate) * 255);
-    // モーターを制御
-    run(pwmValue, rate > 0, rate < 0);
+  if (pwm != 0 && speedAdjustable) {
+    // PWMピンに速度に応じたPWM値を出力（コンペアレジスタに直接書き込む）
+    pwmOutput.write(static_cast<uint8_t>(pwm > 0 ? pwm : -pwm));
   }
+  // inA_PINとinB_PINに回転方向を出力（PWM値が0の場合は両方LOWで停止）
+  digitalWriteFast(inA_PIN, pwm > 0);
+  digitalWriteFast(inB_PIN, pwm < 0);
+}
+
+// PWM値に対応するピンへの出力を取得するメソッド
+uint8_t BD62193::getPinWrites(int16_t pwm, MotorPinWrite *writes) const {
+  // PWM値の範囲を-255から255に制限
+  pwm = constrain(pwm, -255, 255);
+
+  uint8_t count = 0;
+  if (pwm != 0 && speedAdjustable) {
+    // PWMピンに速度に応じたPWM値を出力
+    writes[count++] =
+        MotorPinWrite::analog(pwm_PIN, static_cast<uint8_t>(pwm > 0 ? pwm : -pwm));
+  }
+  // inA_PINとinB_PINに回転方向を出力（PWM値が0の場合は両方LOWで停止）
+  writes[count++] = MotorPinWrite::digital(inA_PIN, pwm > 0);
+  writes[count++] = MotorPinWrite::digital(inB_PIN, pwm < 0);
+  return count;
+}
+
+// PWMの周波数を設定するメソッド
+bool BD62193::setPwmFrequency(PwmFrequency frequency) {
+  return pwmOutput.setFrequency(frequency);
 }
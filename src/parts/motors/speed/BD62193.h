@@ -3,8 +3,10 @@
  * @brief BD62193モータードライバのクラス定義
  *
  * このファイルには、BD62193モータードライバを制御するための
- * `BD62193` クラスが定義されています。このクラスは `ISpeedAdjustable` クラスを
- * 継承し、モーターの前進、後退、停止、速度設定の機能を提供します。
+ * `BD62193` クラスと `StaticBD62193` クラスが定義されています。`BD62193` クラスは
+ * `ISpeedAdjustable` クラスを継承し、モーターの前進、後退、停止、速度設定の
+ * 機能を提供します。`StaticBD62193` クラスはピン番号をコンパイル時に指定し、
+ * 仮想関数を使用せずに同じ機能を提供します。
  *
  * @note このクラスは、PWM制御をサポートしており、モーターの制御に
  *       使用されるピンの設定を行います。
@@ -13,6 +15,9 @@
 #pragma once
 
 #include "ISpeedAdjustable.h"
+#include "SpeedAdjustable.h"
+#include <digitalWriteFast.h>
+#include <fasts/FastPwm.h>
 
 /**
  * @class BD62193
@@ -28,28 +33,7 @@ private:
   uint8_t inB_PIN;      /**< モーターの入力Bピンの番号 */
   uint8_t pwm_PIN;      /**< PWM信号を出力するピンの番号 */
   bool speedAdjustable; /**< 速度調整が可能かどうか */
-
-  /**
-   * @brief モーターを制御する内部メソッド
-   *
-   * このメソッドは、指定されたPWM値と入力ピンの状態に基づいて
-   * モーターを制御します。
-   *
-   * @param inAState 入力Aピンの状態（HIGH または LOW）
-   * @param inBState 入力Bピンの状態（HIGH または LOW）
-   * @param pwmValue 速度に対応するPWM値（0〜255）
-   */
-  void run(bool inAState, bool inBState, uint8_t pwmValue);
-
-  /**
-   * @brief モーターを制御する内部メソッド (PWMピンを使用しない場合)
-   *
-   * PWMピンを使用しない場合にモーターを制御するための内部メソッドです。
-   *
-   * @param inAState 入力Aピンの状態（HIGH または LOW）
-   * @param inBState 入力Bピンの状態（HIGH または LOW）
-   */
-  void run(bool inAState, bool inBState);
+  FastPwm pwmOutput;    /**< PWMピンへの出力 */
 
 public:
   /**
@@ -95,12 +79,100 @@ public:
   void stop() override;
 
   /**
-   * @brief モーターの速度を設定するメソッド
+   * @brief モーターの速度をPWM値で設定するメソッド
+   *
+   * このメソッドは、モーターの速度を整数のPWM値で設定します。PWM値は
+   * -255（最大逆転速度）から255（最大速度）までの範囲で設定できます。
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   */
+  void setPwm(int16_t pwm) override;
+
+  /**
+   * @brief PWM値に対応するピンへの出力を取得するメソッド
+   *
+   * `setPwm()` が行う出力を、出力する順に `writes` に格納します。
+   * `MotorGroup` が使用します（`setPwm()` はピンに直接出力します）。
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   * @param writes 出力を格納する配列（`MAX_PIN_WRITES` 個以上）
+   * @return 格納した出力の数
+   */
+  uint8_t getPinWrites(int16_t pwm, MotorPinWrite *writes) const override;
+
+  /**
+   * @brief PWMの周波数を設定するメソッド
+   *
+   * 周波数を高くすると、PWMによるモーターの音が聞こえなくなります。
+   * 同じタイマーを使用する他のピンの周波数も変わります。
+   *
+   * @param frequency PWMの周波数
+   * @return 設定できた場合は true（Timer0のピン5、6、タイマーのないピン、
+   * MsTimer2が使用しているTimer2のピン3、11は false）
+   */
+  bool setPwmFrequency(PwmFrequency frequency);
+};
+
+/**
+ * @class StaticBD62193
+ * @brief ピン番号をコンパイル時に指定するBD62193モータードライバのクラス
+ *
+ * ピン番号が定数のため、`digitalWriteFast()` は1命令のポート操作になり、
+ * PWM出力はコンパイル時に決まるコンペアレジスタに直接書き込みます（`StaticPwm`）。
+ * 仮想関数を持たないため、メソッドの呼び出しはインライン展開されます。
+ * `ISpeedAdjustable` として扱う場合は `VirtualMotor` を使用してください。
+ *
+ * 使用例:
+ * @code
+ * StaticBD62193<2, 4, 3> motor;
+ * motor.setPwm(128);
+ * @endcode
+ *
+ * @tparam InAPin モーターの入力Aピンの番号
+ * @tparam InBPin モーターの入力Bピンの番号
+ * @tparam PwmPin モーターのPWMピンの番号（速度調整用）
+ */
+template <uint8_t InAPin, uint8_t InBPin, uint8_t PwmPin>
+class StaticBD62193
+    : public SpeedAdjustable<StaticBD62193<InAPin, InBPin, PwmPin>> {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * モーター制御用のピンを出力モードに設定します。
+   */
+  StaticBD62193() {
+    pinModeFast(PwmPin, OUTPUT);
+    pinModeFast(InAPin, OUTPUT);
+    pinModeFast(InBPin, OUTPUT);
+  }
+
+  /**
+   * @brief モーターの速度をPWM値で設定するメソッド
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   */
+  void setPwm(int16_t pwm) {
+    pwm = constrain(pwm, -255, 255);
+    if (pwm != 0) {
+      // PWMピンに速度に応じたPWM値を出力（コンペアレジスタに直接書き込む）
+      StaticPwm<PwmPin>::write(static_cast<uint8_t>(pwm > 0 ? pwm : -pwm));
+    }
+    // inA_PINとinB_PINに回転方向を出力（PWM値が0の場合は両方LOWで停止）
+    digitalWriteFast(InAPin, pwm > 0);
+    digitalWriteFast(InBPin, pwm < 0);
+  }
+
+  /**
+   * @brief PWMの周波数を設定するメソッド
    *
-   * モーターの速度を指定した割合で設定します。速度は0.0（停止）から
-   * 1.0（最大速度）までの範囲で設定できます。
+   * 同じタイマーを使用する他のピンの周波数も変わります。
    *
-   * @param rate モーターの速度割合（0.0〜1.0）
+   * @param frequency PWMの周波数
+   * @return 設定できた場合は true（Timer0のピン5、6、タイマーのないピン、
+   * MsTimer2が使用しているTimer2のピン3、11は false）
    */
-  void setSpeed(float rate) override;
-};
\ No newline at end of file
+  bool setPwmFrequency(PwmFrequency frequency) {
+    return StaticPwm<PwmPin>::setFrequency(frequency);
+  }
+};
@@ -0,0 +1,73 @@
+/**
+ * @file ControllerDrive.h
+ * @brief コントローラーの入力でモーターを制御する関数の定義
+ *
+ * このファイルには、`ControllerData` のスティックやモーターボタンの状態を
+ * モーターの速度に変換する関数が定義されています。関数はモーターの型を
+ * テンプレート引数にとるため、`StaticBD62193` などの仮想関数を持たない
+ * モーターではインライン展開され、`ISpeedAdjustable` では仮想関数を呼び出します。
+ */
+
+#pragma once
+
+#include <parts/controllers/MotorButtonStateArray.h>
+#include <stdint.h>
+
+/**
+ * @brief スティックの値をPWM値に変換する
+ *
+ * 0を-255、255を255に変換します。中央付近の値は0にします。
+ *
+ * @param value スティックの値（0〜255、中央は127または128）
+ * @param deadZone 0にする中央付近の幅（PWM値、デフォルトは16）
+ * @return PWM値（-255〜255）
+ */
+inline int16_t stickToPwm(uint8_t value, uint8_t deadZone = 16) {
+  int16_t pwm = static_cast<int16_t>(value) * 2 - 255;
+  return (pwm > deadZone || pwm < -deadZone) ? pwm : 0;
+}
+
+/**
+ * @brief スティックの値でモーターの速度を設定する
+ *
+ * 使用例:
+ * @code
+ * driveByStick(leftMotor, controllerData.sticks[0].y);
+ * @endcode
+ *
+ * @tparam Motor モーターの型（`setPwm(int16_t)` を持つ型）
+ * @param motor モーター
+ * @param value スティックの値（0〜255）
+ * @param deadZone 0にする中央付近の幅（PWM値、デフォルトは16）
+ */
+template <typename Motor>
+inline void driveByStick(Motor &motor, uint8_t value, uint8_t deadZone = 16) {
+  motor.setPwm(stickToPwm(value, deadZone));
+}
+
+/**
+ * @brief モーターボタンの状態でモーターを制御する
+ *
+ * 使用例:
+ * @code
+ * driveByButton(armMotor, controllerData.motorButtons[0]);
+ * @endcode
+ *
+ * @tparam Motor モーターの型（`forward()`、`reverse()`、`stop()` を持つ型）
+ * @param motor モーター
+ * @param state モーターボタンの状態
+ */
+template <typename Motor>
+inline void driveByButton(Motor &motor, MotorButtonState state) {
+  switch (state) {
+  case MotorButtonState::FORWARD:
+    motor.forward();
+    break;
+  case MotorButtonState::REVERSE:
+    motor.reverse();
+    break;
+  default:
+    motor.stop();
+    break;
+  }
+}
@@ -6,12 +6,52 @@
  * が定義されています。`ISpeedAdjustable` クラスは、モーターの速度設定、前進、
  * 後退、停止のためのインターフェースを提供します。このクラスを継承する
  * クラスは、これらのメソッドを実装する必要があります。
+ *
+ * 速度は整数のPWM値（-255〜255）で設定する `setPwm()` が基本です。
+ * AVRマイコンには浮動小数点数の演算器がないため、制御周期ごとに速度を
+ * 設定する場合は `setSpeed()` より `setPwm()` の方が高速です。
  */
 
 #pragma once
 
 #include <Arduino.h>
 
+/**
+ * @struct MotorPinWrite
+ * @brief モータードライバのピンに出力する値
+ *
+ * `MotorGroup` が複数のモーターの出力をまとめて書き込むために使用します。
+ */
+struct MotorPinWrite {
+  uint8_t pin;   ///< ピンの番号
+  uint8_t value; ///< 出力する値（デジタル出力は HIGH または LOW、PWM出力は0〜255）
+  bool pwm;      ///< PWM出力（`analogWrite()`）の場合は true
+
+  /**
+   * @brief デジタル出力を作成する
+   *
+   * @param pin ピンの番号
+   * @param state 出力する状態（HIGH の場合は true）
+   * @return デジタル出力
+   */
+  static MotorPinWrite digital(uint8_t pin, bool state) {
+    MotorPinWrite write = {pin, static_cast<uint8_t>(state ? HIGH : LOW), false};
+    return write;
+  }
+
+  /**
+   * @brief PWM出力を作成する
+   *
+   * @param pin ピンの番号
+   * @param value PWM値（0〜255）
+   * @return PWM出力
+   */
+  static MotorPinWrite analog(uint8_t pin, uint8_t value) {
+    MotorPinWrite write = {pin, value, true};
+    return write;
+  }
+};
+
 /**
  * @class ISpeedAdjustable
  * @brief モーターを制御するための抽象基底クラス
@@ -22,15 +62,33 @@
  */
 class ISpeedAdjustable {
 public:
+  /// `getPinWrites()` が返す出力の最大数
+  static const uint8_t MAX_PIN_WRITES = 3;
+
+  /**
+   * @brief モーターの速度をPWM値で設定するメソッド
+   *
+   * このメソッドは、モーターの速度を整数のPWM値で設定します。PWM値は
+   * -255（最大逆転速度）から255（最大速度）までの範囲で設定でき、
+   * 範囲外の値は範囲内に制限されます。
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   */
+  virtual void setPwm(int16_t pwm) = 0;
+
   /**
    * @brief モーターの速度を設定するメソッド
    *
    * このメソッドは、モーターの速度を指定した割合で設定します。速度は
    * -1.0（最大逆転速度）から1.0（最大速度）までの範囲で設定できます。
+   * 割合をPWM値（小数点以下は切り捨て）に変換して `setPwm()` を呼び出します。
    *
    * @param rate モーターの速度割合（-1.0〜1.0）
    */
-  virtual void setSpeed(float rate) = 0;
+  virtual void setSpeed(float rate) {
+    rate = constrain(rate, -1.0, 1.0);
+    setPwm(static_cast<int16_t>(rate * 255));
+  }
 
   /**
    * @brief モーターを前進させるメソッド
@@ -52,4 +110,23 @@ public:
    * このメソッドは、モーターを停止させるための制御信号を出力します。
    */
   virtual void stop() = 0;
+
+  /**
+   * @brief PWM値に対応するピンへの出力を取得するメソッド
+   *
+   * このメソッドは、`setPwm()` が行う出力を、出力する順に `writes` に格納します。
+   * `MotorGroup` は、この出力を複数のモーターでまとめて書き込みます。
+   * 対応していない場合は0を返し、`MotorGroup` は `setPwm()` を呼び出します。
+   * `MotorGroup` はPWM値128と-128の出力から使用するピンを調べるため、
+   * それ以外のPWM値でも、これらに含まれるピンだけに出力してください。
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   * @param writes 出力を格納する配列（`MAX_PIN_WRITES` 個以上）
+   * @return 格納した出力の数
+   */
+  virtual uint8_t getPinWrites(int16_t pwm, MotorPinWrite *writes) const {
+    (void)pwm;
+    (void)writes;
+    return 0;
+  }
 };
\ No newline at end of file
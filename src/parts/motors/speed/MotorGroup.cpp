@@ -0,0 +1,164 @@
+#include "MotorGroup.h"
+#include <Arduino.h>
+
+// コンストラクタ: モーターの配列を保持する
+// (モーターが構築済みとは限らないため、仮想関数は呼び出さない)
+MotorGroup::MotorGroup(ISpeedAdjustable *const *motors, uint8_t numMotors)
+    : numMotors(numMotors < MAX_MOTORS ? numMotors : MAX_MOTORS) {
+  for (uint8_t i = 0; i < this->numMotors; i++) {
+    this->motors[i] = motors[i];
+    pwm[i] = 0;
+  }
+}
+
+// 各モーターが使用するピンのコンペアレジスタを調べる
+void MotorGroup::findTimerPins() {
+  for (uint8_t i = 0; i < numMotors; i++) {
+    // 正転と後転の出力から、モーターが使用する全てのピンを集める
+    MotorPinWrite writes[ISpeedAdjustable::MAX_PIN_WRITES];
+    uint8_t count = motors[i]->getPinWrites(128, writes);
+    for (uint8_t j = 0; j < count; j++) {
+      addTimerPin(writes[j].pin);
+    }
+    count = motors[i]->getPinWrites(-128, writes);
+    for (uint8_t j = 0; j < count; j++) {
+      addTimerPin(writes[j].pin);
+    }
+  }
+  channelsReady = true;
+}
+
+// モーターのPWM値を設定するメソッド (出力は update() で行う)
+void MotorGroup::setPwm(uint8_t index, int16_t pwm) {
+  if (index < numMotors) {
+    this->pwm[index] = pwm;
+  }
+}
+
+// 全てのモーターを停止させるメソッド
+void MotorGroup::stop() {
+  for (uint8_t i = 0; i < numMotors; i++) {
+    pwm[i] = 0;
+  }
+  update();
+}
+
+// 全てのモーターのPWM値をまとめて出力するメソッド
+void MotorGroup::update() {
+  if (!channelsReady) {
+    findTimerPins();
+  }
+
+  PortWrite ports[MAX_PORTS];
+  uint8_t numPorts = 0;
+  CompareWrite compares[FastPwm::MAX_CHANNELS];
+  uint8_t numCompares = 0;
+  FastPwm::CompareChannel detaches[FastPwm::MAX_CHANNELS];
+  uint8_t numDetaches = 0;
+
+  // 割り込みを禁止する前に、全てのモーターの出力を集める
+  for (uint8_t i = 0; i < numMotors; i++) {
+    MotorPinWrite writes[ISpeedAdjustable::MAX_PIN_WRITES];
+    uint8_t count = motors[i]->getPinWrites(pwm[i], writes);
+    if (count == 0) {
+      // 出力をまとめられないモーターは、ここで出力する
+      motors[i]->setPwm(pwm[i]);
+      continue;
+    }
+
+    for (uint8_t j = 0; j < count; j++) {
+      const MotorPinWrite &write = writes[j];
+      FastPwm::CompareChannel channel = findChannel(write.pin);
+      if (write.pwm && write.value != 0 && write.value != 255 &&
+          channel.isValid()) {
+        // PWM出力はコンペアレジスタに書き込む
+        if (numCompares < FastPwm::MAX_CHANNELS) {
+          CompareWrite compare = {channel, write.value};
+          compares[numCompares++] = compare;
+        } else {
+          channel.attach(write.value);
+        }
+        continue;
+      }
+
+      // analogWrite() と同様に、0と255のPWM出力やタイマーのないピンは
+      // デジタル出力にする
+      bool state = write.pwm ? write.value >= 128 : write.value != LOW;
+      if (channel.isValid()) {
+        if (numDetaches < FastPwm::MAX_CHANNELS) {
+          detaches[numDetaches++] = channel;
+        } else {
+          channel.detach();
+        }
+      }
+      if (!addPortWrite(ports, numPorts, write.pin, state)) {
+        // ポートの数が多すぎる場合は、ここで出力する
+        digitalWrite(write.pin, state);
+      }
+    }
+  }
+
+  // 割り込みを禁止して、全ての出力を続けて書き込む
+  uint8_t oldSREG = SREG;
+  cli();
+  for (uint8_t i = 0; i < numDetaches; i++) {
+    detaches[i].detach();
+  }
+  for (uint8_t i = 0; i < numPorts; i++) {
+    *ports[i].reg = (*ports[i].reg & ~ports[i].mask) | ports[i].bits;
+  }
+  for (uint8_t i = 0; i < numCompares; i++) {
+    compares[i].channel.attach(compares[i].value);
+  }
+  SREG = oldSREG;
+}
+
+// デジタル出力を、ポートに対する書き込みに追加する
+bool MotorGroup::addPortWrite(PortWrite *ports, uint8_t &numPorts,
+                              uint8_t pin, bool state) {
+  uint8_t port = digitalPinToPort(pin);
+  if (port == NOT_A_PIN) {
+    return true;
+  }
+  volatile uint8_t *reg = portOutputRegister(port);
+  uint8_t bit = digitalPinToBitMask(pin);
+
+  // 同じポートへの書き込みがあれば、そこにまとめる
+  for (uint8_t i = 0; i < numPorts; i++) {
+    if (ports[i].reg == reg) {
+      ports[i].mask |= bit;
+      ports[i].bits = state ? (ports[i].bits | bit) : (ports[i].bits & ~bit);
+      return true;
+    }
+  }
+  if (numPorts == MAX_PORTS) {
+    return false;
+  }
+  PortWrite write = {reg, bit, static_cast<uint8_t>(state ? bit : 0)};
+  ports[numPorts++] = write;
+  return true;
+}
+
+// ピンをタイマーのあるピンの一覧に追加する
+void MotorGroup::addTimerPin(uint8_t pin) {
+  if (numChannels == FastPwm::MAX_CHANNELS || findChannel(pin).isValid()) {
+    return;
+  }
+  FastPwm::CompareChannel channel = FastPwm::channel(digitalPinToTimer(pin));
+  if (channel.isValid()) {
+    timerPins[numChannels] = pin;
+    channels[numChannels] = channel;
+    numChannels++;
+  }
+}
+
+// ピンのコンペアレジスタを取得する
+FastPwm::CompareChannel MotorGroup::findChannel(uint8_t pin) const {
+  for (uint8_t i = 0; i < numChannels; i++) {
+    if (timerPins[i] == pin) {
+      return channels[i];
+    }
+  }
+  FastPwm::CompareChannel none = {nullptr, 0, nullptr, false};
+  return none;
+}
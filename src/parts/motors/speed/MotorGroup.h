@@ -0,0 +1,149 @@
+/**
+ * @file MotorGroup.h
+ * @brief 複数のモーターの出力をまとめて書き込むクラス定義
+ *
+ * このファイルには、複数のモータードライバの出力をまとめて書き込む
+ * `MotorGroup` クラスが定義されています。
+ *
+ * モーターを1つずつ `setPwm()` で制御すると、ピンごとに `digitalWrite()` や
+ * `analogWrite()` が呼び出されるため、最初のモーターと最後のモーターの出力が
+ * 切り替わる時刻がずれます。`MotorGroup` は、同じポートのピンへの出力を
+ * 1回のポートの書き込みにまとめ、PWM値の書き込みを続けて行います。
+ *
+ * @note PWM出力はATmega328PのTimer0〜Timer2のピンに対応しています。
+ */
+
+#pragma once
+
+#include "ISpeedAdjustable.h"
+#include <fasts/FastPwm.h>
+
+/**
+ * @class MotorGroup
+ * @brief 複数のモーターの出力をまとめて書き込むクラス
+ *
+ * `setPwm()` で各モーターのPWM値を設定し、`update()` でまとめて出力します。
+ * `update()` は、割り込みを禁止して、ポートごとに1回の書き込みと、
+ * PWMのコンペアレジスタへの書き込みを続けて行います。
+ *
+ * 使用例:
+ * @code
+ * BD62193 frontLeft(2, 4, 3), frontRight(7, 8, 5);
+ * BD62193 rearLeft(12, 13, 6), rearRight(14, 15, 9);
+ * ISpeedAdjustable *wheels[] = {&frontLeft, &frontRight, &rearLeft, &rearRight};
+ * MotorGroup chassis(wheels, 4);
+ *
+ * void loop() {
+ *   chassis.setPwm(0, 200);
+ *   chassis.setPwm(1, -200);
+ *   chassis.setPwm(2, 200);
+ *   chassis.setPwm(3, -200);
+ *   chassis.update(); // 4つのモーターの出力が同時に切り替わる
+ * }
+ * @endcode
+ */
+class MotorGroup {
+public:
+  /// まとめて制御できるモーターの最大数
+  static const uint8_t MAX_MOTORS = 6;
+
+  /**
+   * @brief コンストラクタ
+   *
+   * 全てのモーターのPWM値を0に初期化します（出力は `update()` で行います）。
+   * モーターの仮想関数は呼び出さないため、グローバル変数のモーターより先に
+   * 構築されても問題ありません。
+   *
+   * @param motors モーターの配列
+   * @param numMotors モーターの数（`MAX_MOTORS` を超える分は無視されます）
+   */
+  MotorGroup(ISpeedAdjustable *const *motors, uint8_t numMotors);
+
+  /**
+   * @brief モーターのPWM値を設定するメソッド
+   *
+   * 出力は `update()` を呼び出すまで行われません。
+   *
+   * @param index モーターの番号（コンストラクタに渡した配列の添字）
+   * @param pwm モーターのPWM値（-255〜255）
+   */
+  void setPwm(uint8_t index, int16_t pwm);
+
+  /**
+   * @brief 全てのモーターのPWM値をまとめて出力するメソッド
+   *
+   * 最初の呼び出しで、各モーターが使用するピンのコンペアレジスタを調べておき、
+   * 以降の呼び出しではピンからタイマーを調べません。
+   */
+  void update();
+
+  /**
+   * @brief 全てのモーターを停止させるメソッド
+   *
+   * 全てのモーターのPWM値を0に設定し、すぐに出力します。
+   */
+  void stop();
+
+private:
+  /// 1つのポートに対する書き込み
+  struct PortWrite {
+    volatile uint8_t *reg; ///< ポートの出力レジスタ
+    uint8_t mask;          ///< 書き込むビット
+    uint8_t bits;          ///< HIGH にするビット
+  };
+
+  /// 1つのコンペアレジスタに対する書き込み
+  struct CompareWrite {
+    FastPwm::CompareChannel channel; ///< コンペアレジスタ
+    uint8_t value;                   ///< PWM値
+  };
+
+  /// 1つのポートに対する書き込みの最大数（ATmega328PのポートB、C、D）
+  static const uint8_t MAX_PORTS = 3;
+
+  ISpeedAdjustable *motors[MAX_MOTORS]; /**< モーターの配列 */
+  int16_t pwm[MAX_MOTORS];              /**< 各モーターのPWM値 */
+  uint8_t numMotors;                    /**< モーターの数 */
+
+  uint8_t timerPins[FastPwm::MAX_CHANNELS]; /**< タイマーのあるピンの番号 */
+  FastPwm::CompareChannel channels[FastPwm::MAX_CHANNELS]; /**< ピンのコンペアレジスタ */
+  uint8_t numChannels = 0; /**< タイマーのあるピンの数 */
+  bool channelsReady = false; /**< コンペアレジスタを調べたかどうか */
+
+  /**
+   * @brief 各モーターが使用するピンのコンペアレジスタを調べる
+   *
+   * モーターの `getPinWrites()` を呼び出すため、全てのモーターの構築後
+   * （最初の `update()`）に行います。
+   */
+  void findTimerPins();
+
+  /**
+   * @brief ピンをタイマーのあるピンの一覧に追加する
+   *
+   * タイマーのないピンや、追加済みのピンは無視します。
+   *
+   * @param pin ピンの番号
+   */
+  void addTimerPin(uint8_t pin);
+
+  /**
+   * @brief ピンのコンペアレジスタを取得する
+   *
+   * @param pin ピンの番号
+   * @return コンペアレジスタ（タイマーのないピンは `isValid()` が false）
+   */
+  FastPwm::CompareChannel findChannel(uint8_t pin) const;
+
+  /**
+   * @brief デジタル出力を、ポートに対する書き込みに追加する
+   *
+   * @param ports ポートに対する書き込みの配列
+   * @param numPorts ポートに対する書き込みの数
+   * @param pin ピンの番号
+   * @param state 出力する状態
+   * @return 追加できた場合は true（ポートの数が多すぎる場合は false）
+   */
+  static bool addPortWrite(PortWrite *ports, uint8_t &numPorts, uint8_t pin,
+                           bool state);
+};
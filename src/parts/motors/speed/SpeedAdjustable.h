@@ -0,0 +1,132 @@
+/**
+ * @file SpeedAdjustable.h
+ * @brief 仮想関数を使用しないモータードライバの基底クラス定義
+ *
+ * このファイルには、CRTP（派生クラスを型引数にとる基底クラス）を使用した
+ * モータードライバの基底クラス `SpeedAdjustable` と、それを `ISpeedAdjustable`
+ * として扱うための `VirtualMotor` クラスが定義されています。
+ *
+ * `ISpeedAdjustable` を継承したクラスは、オブジェクトごとに仮想関数テーブルへの
+ * ポインタを持ち、メソッドの呼び出しは間接呼び出しになります。`SpeedAdjustable`
+ * を継承したクラスは仮想関数を持たないため、テンプレートで書いた処理の中で
+ * メソッドをインライン展開できます。
+ */
+
+#pragma once
+
+#include "ISpeedAdjustable.h"
+
+/**
+ * @class SpeedAdjustable
+ * @brief 仮想関数を使用しないモータードライバの基底クラス
+ *
+ * 派生クラスは `void setPwm(int16_t pwm)` を定義します。`setSpeed()`、
+ * `forward()`、`reverse()`、`stop()` は `setPwm()` を呼び出します。
+ *
+ * 使用例:
+ * @code
+ * class MyMotor : public SpeedAdjustable<MyMotor> {
+ * public:
+ *   void setPwm(int16_t pwm) { ... }
+ * };
+ * @endcode
+ *
+ * @tparam Derived 派生クラスの型
+ */
+template <typename Derived> class SpeedAdjustable {
+public:
+  /**
+   * @brief モーターの速度を設定するメソッド
+   *
+   * 割合をPWM値（小数点以下は切り捨て）に変換して `setPwm()` を呼び出します。
+   *
+   * @param rate モーターの速度割合（-1.0〜1.0）
+   */
+  void setSpeed(float rate) {
+    rate = constrain(rate, -1.0, 1.0);
+    derived().setPwm(static_cast<int16_t>(rate * 255));
+  }
+
+  /**
+   * @brief モーターを最大の速度で前進させるメソッド
+   */
+  void forward() { derived().setPwm(255); }
+
+  /**
+   * @brief モーターを最大の速度で後退させるメソッド
+   */
+  void reverse() { derived().setPwm(-255); }
+
+  /**
+   * @brief モーターを停止させるメソッド
+   */
+  void stop() { derived().setPwm(0); }
+
+  /**
+   * @brief PWM値に対応するピンへの出力を取得するメソッド
+   *
+   * 派生クラスで定義しない場合は0を返し、`MotorGroup` は `setPwm()` を呼び出します。
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   * @param writes 出力を格納する配列
+   * @return 格納した出力の数
+   */
+  uint8_t getPinWrites(int16_t pwm, MotorPinWrite *writes) const {
+    (void)pwm;
+    (void)writes;
+    return 0;
+  }
+
+protected:
+  /// 派生クラスからのみ構築できるようにする
+  SpeedAdjustable() = default;
+
+private:
+  /// 派生クラスの参照を取得する
+  Derived &derived() { return static_cast<Derived &>(*this); }
+};
+
+/**
+ * @class VirtualMotor
+ * @brief 仮想関数を使用しないモータードライバを `ISpeedAdjustable` として扱うクラス
+ *
+ * 種類の異なるモーターを `ISpeedAdjustable` の配列にまとめる場合（`MotorGroup` など）
+ * に使用します。このクラスを経由した呼び出しは間接呼び出しになりますが、
+ * `get()` で取り出したモーターへの呼び出しはインライン展開できます。
+ *
+ * 使用例:
+ * @code
+ * VirtualMotor<StaticBD62193<2, 4, 3>> left;
+ * VirtualMotor<StaticTB67H450<9, 10>> right;
+ * ISpeedAdjustable *wheels[] = {&left, &right};
+ * MotorGroup chassis(wheels, 2);
+ * @endcode
+ *
+ * @tparam Motor モーターの型（`SpeedAdjustable` を継承したクラス）
+ */
+template <typename Motor> class VirtualMotor : public ISpeedAdjustable {
+public:
+  /**
+   * @brief モーターを取得する
+   *
+   * @return モーター
+   */
+  Motor &get() { return motor; }
+
+  void setPwm(int16_t pwm) override { motor.setPwm(pwm); }
+
+  void setSpeed(float rate) override { motor.setSpeed(rate); }
+
+  void forward() override { motor.forward(); }
+
+  void reverse() override { motor.reverse(); }
+
+  void stop() override { motor.stop(); }
+
+  uint8_t getPinWrites(int16_t pwm, MotorPinWrite *writes) const override {
+    return motor.getPinWrites(pwm, writes);
+  }
+
+private:
+  Motor motor; /**< モーター */
+};
@@ -0,0 +1,69 @@
+#include "SpeedPid.h"
+#include <Arduino.h>
+
+// コンストラクタ: 制御するモーターとゲインを設定
+SpeedPid::SpeedPid(ISpeedAdjustable &motor, uint16_t kp, uint16_t ki,
+                   uint16_t kd)
+    : motor(motor), kp(kp), ki(ki), kd(kd) {}
+
+// ゲインを設定するメソッド
+void SpeedPid::setGains(uint16_t kp, uint16_t ki, uint16_t kd) {
+  this->kp = kp;
+  this->ki = ki;
+  this->kd = kd;
+}
+
+// 回転速度を測り、PWM値を計算してモーターに出力するメソッド
+int16_t SpeedPid::update(int32_t count) {
+  int32_t delta = count - lastCount;
+  lastCount = count;
+  if (!started) {
+    // 最初の呼び出しはカウント値を記録するだけ
+    started = true;
+    return output;
+  }
+
+  // 偏差と、微分項に使用する速度の変化（目標の変化による急な出力を避ける）
+  int16_t measured = limitError(delta);
+  int16_t error = limitError(static_cast<int32_t>(target) - measured);
+  int16_t change = limitError(static_cast<int32_t>(measured) - speed);
+  speed = measured;
+
+  // PWM値が上限または下限に達している間は、その方向に積算しない
+  bool saturated = (output >= 255 && error > 0) || (output <= -255 && error < 0);
+  if (!saturated) {
+    integral += static_cast<int32_t>(ki) * error;
+    if (integral > INTEGRAL_LIMIT) {
+      integral = INTEGRAL_LIMIT;
+    } else if (integral < -INTEGRAL_LIMIT) {
+      integral = -INTEGRAL_LIMIT;
+    }
+  }
+
+  int32_t sum = static_cast<int32_t>(kp) * error + integral -
+                static_cast<int32_t>(kd) * change;
+  int32_t pwm = sum / 256;
+  output = static_cast<int16_t>(constrain(pwm, -255L, 255L));
+  motor.setPwm(output);
+  return output;
+}
+
+// 制御の状態を初期化し、モーターを停止させるメソッド
+void SpeedPid::reset() {
+  integral = 0;
+  speed = 0;
+  output = 0;
+  started = false;
+  motor.setPwm(0);
+}
+
+// 値を -ERROR_LIMIT 〜 ERROR_LIMIT に制限する
+int16_t SpeedPid::limitError(int32_t value) {
+  if (value > ERROR_LIMIT) {
+    return ERROR_LIMIT;
+  }
+  if (value < -ERROR_LIMIT) {
+    return -ERROR_LIMIT;
+  }
+  return static_cast<int16_t>(value);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file SpeedPid.h
+ * @brief エンコーダーの値を使用してモーターの回転速度を一定に保つクラス定義
+ *
+ * このファイルには、モーターの回転速度をPID制御する `SpeedPid` クラスが
+ * 定義されています。`setSpeed()` で設定した出力の割合は、電池の電圧や負荷に
+ * よって実際の回転速度が変わります。`SpeedPid` はエンコーダーで測った回転速度が
+ * 目標の速度になるように、PWM値を調整し続けます。
+ */
+
+#pragma once
+
+#include "ISpeedAdjustable.h"
+
+/**
+ * @class SpeedPid
+ * @brief モーターの回転速度を固定小数点数のPID制御で一定に保つクラス
+ *
+ * `update()` を一定の周期で呼び出し、その時点のエンコーダーのカウント値を渡します。
+ * 前回からのカウント値の差を回転速度として、目標の速度との差からPWM値を計算し、
+ * モーターに出力します。計算は整数だけで行い、処理時間は一定です。
+ *
+ * ゲインは256を1.0とする固定小数点数で指定します。
+ * PWM値 = (Kp × 偏差 + Ki × 偏差の積算 - Kd × 速度の変化) / 256
+ *
+ * 積分項はPWM値の範囲（-255〜255）に制限し、PWM値が上限または下限に達している間は
+ * その方向に積算しないため、モーターが目標の速度に届かない状態が続いても
+ * 積分項が大きくなりすぎません（アンチワインドアップ）。
+ *
+ * 使用例:
+ * @code
+ * BD62193 motor(2, 4, 3);
+ * SpeedPid pid(motor, 512, 64, 0); // Kp = 2.0, Ki = 0.25, Kd = 0
+ *
+ * void loop() {
+ *   static unsigned long last = 0;
+ *   if (millis() - last >= 10) { // 10msごとに制御する
+ *     last += 10;
+ *     pid.setTarget(40); // 10msあたり40カウント
+ *     pid.update(encoder.read());
+ *   }
+ * }
+ * @endcode
+ */
+class SpeedPid {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @param motor 制御するモーター
+   * @param kp 比例ゲイン（256が1.0）
+   * @param ki 積分ゲイン（256が1.0）
+   * @param kd 微分ゲイン（256が1.0）
+   */
+  SpeedPid(ISpeedAdjustable &motor, uint16_t kp, uint16_t ki, uint16_t kd);
+
+  /**
+   * @brief ゲインを設定するメソッド
+   *
+   * @param kp 比例ゲイン（256が1.0）
+   * @param ki 積分ゲイン（256が1.0）
+   * @param kd 微分ゲイン（256が1.0）
+   */
+  void setGains(uint16_t kp, uint16_t ki, uint16_t kd);
+
+  /**
+   * @brief 目標の回転速度を設定するメソッド
+   *
+   * @param ticksPerUpdate `update()` の1周期あたりのエンコーダーのカウント数
+   */
+  void setTarget(int16_t ticksPerUpdate) { target = ticksPerUpdate; }
+
+  /**
+   * @brief 回転速度を測り、PWM値を計算してモーターに出力するメソッド
+   *
+   * 一定の周期で呼び出します。最初の呼び出しと `reset()` の後の最初の呼び出しでは
+   * カウント値を記録するだけで、モーターには出力しません。
+   *
+   * @param count エンコーダーのカウント値（積算値）
+   * @return 出力したPWM値（-255〜255）
+   */
+  int16_t update(int32_t count);
+
+  /**
+   * @brief 制御の状態を初期化し、モーターを停止させるメソッド
+   */
+  void reset();
+
+  /**
+   * @brief 目標の回転速度を取得するメソッド
+   *
+   * @return `update()` の1周期あたりのエンコーダーのカウント数
+   */
+  int16_t getTarget() const { return target; }
+
+  /**
+   * @brief 前回の `update()` で測った回転速度を取得するメソッド
+   *
+   * @return `update()` の1周期あたりのエンコーダーのカウント数
+   */
+  int16_t getSpeed() const { return speed; }
+
+  /**
+   * @brief 前回の `update()` で出力したPWM値を取得するメソッド
+   *
+   * @return PWM値（-255〜255）
+   */
+  int16_t getPwm() const { return output; }
+
+private:
+  /// 積分項の上限（PWM値の255を256倍した値）
+  static const int32_t INTEGRAL_LIMIT = 255L * 256;
+  /// 偏差と速度の変化の上限（32ビットの計算が桁あふれしないようにする）
+  static const int16_t ERROR_LIMIT = 8191;
+
+  ISpeedAdjustable &motor; /**< 制御するモーター */
+  uint16_t kp;             /**< 比例ゲイン（256が1.0） */
+  uint16_t ki;             /**< 積分ゲイン（256が1.0） */
+  uint16_t kd;             /**< 微分ゲイン（256が1.0） */
+  int16_t target = 0;      /**< 目標の回転速度 */
+  int16_t speed = 0;       /**< 前回測った回転速度 */
+  int16_t output = 0;      /**< 前回出力したPWM値 */
+  int32_t integral = 0;    /**< 積分項（PWM値の256倍） */
+  int32_t lastCount = 0;   /**< 前回のカウント値 */
+  bool started = false;    /**< カウント値を記録したかどうか */
+
+  /**
+   * @brief 値を `-ERROR_LIMIT` 〜 `ERROR_LIMIT` に制限する
+   *
+   * @param value 制限する値
+   * @return 制限した値
+   */
+  static int16_t limitError(int32_t value);
+};
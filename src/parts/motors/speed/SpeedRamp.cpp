@@ -0,0 +1,77 @@
+#include "SpeedRamp.h"
+#include <Arduino.h>
+
+// コンストラクタ: 制御するモーターと変化の速さを設定
+SpeedRamp::SpeedRamp(ISpeedAdjustable &motor, uint16_t maxSlope)
+    : motor(motor) {
+  setMaxSlope(maxSlope);
+}
+
+// 1秒あたりのPWM値の最大の変化量を設定するメソッド
+void SpeedRamp::setMaxSlope(uint16_t maxSlope) {
+  if (maxSlope == 0) {
+    maxSlope = 1;
+  }
+  // 1マイクロ秒あたりの変化量 maxSlope * 2^22 / 10^6 を、
+  // 2^22 / 10^6 = 4 + 12144 / 62500 に分けて桁あふれせずに計算
+  step = maxSlope * 4UL + (maxSlope * 12144UL + 31250) / 62500;
+  // この時間以上経過した場合は、どの速度からでも目標の速度に達する
+  fullRangeMicros = FULL_RANGE / step;
+}
+
+// 目標のPWM値を設定するメソッド (出力は tick() で行う)
+void SpeedRamp::setPwm(int16_t pwm) {
+  pwm = constrain(pwm, -255, 255);
+  target = static_cast<int32_t>(pwm) << FRACTION_BITS;
+}
+
+// 正転メソッド: 目標の速度を最大の速度で前進に設定
+void SpeedRamp::forward() { setPwm(255); }
+
+// 後転メソッド: 目標の速度を最大の速度で後退に設定
+void SpeedRamp::reverse() { setPwm(-255); }
+
+// モーター停止メソッド: 目標の速度を停止に設定
+void SpeedRamp::stop() { setPwm(0); }
+
+// すぐにモーターを停止させるメソッド
+void SpeedRamp::stopNow() {
+  position = target = 0;
+  output = 0;
+  motor.setPwm(0);
+}
+
+// 経過時間に応じて速度を目標の速度に近づけるメソッド
+void SpeedRamp::tick(unsigned long nowMicros) {
+  uint32_t elapsed = nowMicros - lastTick;
+  lastTick = nowMicros;
+  if (!started) {
+    // 最初の呼び出しは時刻を記録するだけ
+    started = true;
+    return;
+  }
+
+  // 経過時間に応じた変化量（長時間経過した場合は桁あふれを避けて最大値にする）
+  uint32_t delta = FULL_RANGE;
+  if (elapsed < fullRangeMicros) {
+    delta = elapsed * step;
+  }
+
+  // 目標の速度を超えないように近づける
+  if (position < target) {
+    position = static_cast<uint32_t>(target - position) <= delta
+                   ? target
+                   : position + static_cast<int32_t>(delta);
+  } else if (position > target) {
+    position = static_cast<uint32_t>(position - target) <= delta
+                   ? target
+                   : position - static_cast<int32_t>(delta);
+  }
+
+  // PWM値が変化した場合だけ出力する
+  int16_t pwm = toPwm(position);
+  if (pwm != output) {
+    output = pwm;
+    motor.setPwm(pwm);
+  }
+}
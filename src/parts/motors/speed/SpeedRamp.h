@@ -0,0 +1,142 @@
+/**
+ * @file SpeedRamp.h
+ * @brief モーターの速度を少しずつ変化させるクラス定義
+ *
+ * このファイルには、モーターの速度の変化の速さ（加速度）を制限する
+ * `SpeedRamp` クラスが定義されています。速度を急に切り替えると、モーターに
+ * 大きな電流が流れてマイコンの電源電圧が下がることがあります。
+ * `SpeedRamp` は目標の速度まで一定の速さで近づけるため、
+ * `delay()` で待たずに電流の急な変化を防げます。
+ */
+
+#pragma once
+
+#include "ISpeedAdjustable.h"
+
+/**
+ * @class SpeedRamp
+ * @brief モーターの速度を目標の速度まで一定の速さで変化させるクラス
+ *
+ * `ISpeedAdjustable` を継承しているため、モーターの代わりに使用できます。
+ * `setSpeed()` や `setPwm()` は目標の速度を設定するだけで、実際の出力は
+ * `tick()` を呼び出すたびに、経過時間に応じて目標の速度に近づけます。
+ * `tick()` の処理時間は、経過時間や速度の差に関わらず一定です。
+ *
+ * 使用例:
+ * @code
+ * BD62193 motor(2, 4, 3);
+ * SpeedRamp ramp(motor, 510); // -255から255まで1秒で変化させる
+ *
+ * void loop() {
+ *   ramp.setSpeed(1.0); // 目標の速度を設定する
+ *   ramp.tick(micros()); // 毎回呼び出す
+ * }
+ * @endcode
+ */
+class SpeedRamp : public ISpeedAdjustable {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * @note 変化量が10未満の場合、実際の変化の速さの誤差が数%になります。
+   *
+   * @param motor 制御するモーター
+   * @param maxSlope 1秒あたりのPWM値の最大の変化量（1〜65535）
+   */
+  SpeedRamp(ISpeedAdjustable &motor, uint16_t maxSlope);
+
+  /**
+   * @brief 1秒あたりのPWM値の最大の変化量を設定するメソッド
+   *
+   * @param maxSlope 1秒あたりのPWM値の最大の変化量（1〜65535）
+   */
+  void setMaxSlope(uint16_t maxSlope);
+
+  /**
+   * @brief 目標のPWM値を設定するメソッド
+   *
+   * 出力は `tick()` で行います。
+   *
+   * @param pwm 目標のPWM値（-255〜255）
+   */
+  void setPwm(int16_t pwm) override;
+
+  /**
+   * @brief 目標の速度を最大の速度で前進に設定するメソッド
+   */
+  void forward() override;
+
+  /**
+   * @brief 目標の速度を最大の速度で後退に設定するメソッド
+   */
+  void reverse() override;
+
+  /**
+   * @brief 目標の速度を停止に設定するメソッド
+   *
+   * 速度は少しずつ0に近づきます。すぐに停止させる場合は `stopNow()` を使用します。
+   */
+  void stop() override;
+
+  /**
+   * @brief 速度の変化の速さを制限せずに、すぐにモーターを停止させるメソッド
+   */
+  void stopNow();
+
+  /**
+   * @brief 経過時間に応じて速度を目標の速度に近づけるメソッド
+   *
+   * 最初の呼び出しでは時刻を記録するだけで、速度は変化しません。
+   * PWM値が変化した場合だけモーターに出力します。
+   *
+   * @param nowMicros 現在の時刻（マイクロ秒）。通常は `micros()` の値
+   */
+  void tick(unsigned long nowMicros);
+
+  /**
+   * @brief 現在出力しているPWM値を取得するメソッド
+   *
+   * @return 現在出力しているPWM値（-255〜255）
+   */
+  int16_t getPwm() const { return output; }
+
+  /**
+   * @brief 目標のPWM値を取得するメソッド
+   *
+   * @return 目標のPWM値（-255〜255）
+   */
+  int16_t getTargetPwm() const { return toPwm(target); }
+
+  /**
+   * @brief 目標の速度に達したかどうかを取得するメソッド
+   *
+   * @return 目標の速度に達した場合は true
+   */
+  bool isSettled() const { return position == target; }
+
+private:
+  /// PWM値の小数部のビット数（PWM値を `2^22` 倍した固定小数点数で計算する）
+  static const uint8_t FRACTION_BITS = 22;
+  /// PWM値の変化量の最大値（-255から255まで）
+  static const uint32_t FULL_RANGE = 510UL << FRACTION_BITS;
+
+  ISpeedAdjustable &motor; /**< 制御するモーター */
+  int32_t position = 0;    /**< 現在の速度（固定小数点数） */
+  int32_t target = 0;      /**< 目標の速度（固定小数点数） */
+  int16_t output = 0;      /**< 現在出力しているPWM値 */
+  uint32_t step = 0;       /**< 1マイクロ秒あたりの変化量（固定小数点数） */
+  uint32_t fullRangeMicros = 0; /**< `FULL_RANGE` だけ変化するのにかかる時間 */
+  unsigned long lastTick = 0;   /**< 前回 `tick()` を呼び出した時刻 */
+  bool started = false;         /**< `tick()` を呼び出したことがあるかどうか */
+
+  /**
+   * @brief 固定小数点数の速度をPWM値に変換する（0に近い方に切り捨て）
+   *
+   * @param value 固定小数点数の速度
+   * @return PWM値
+   */
+  static int16_t toPwm(int32_t value) {
+    return value >= 0 ? static_cast<int16_t>(value >> FRACTION_BITS)
+                      : -static_cast<int16_t>((-value) >> FRACTION_BITS);
+  }
+};
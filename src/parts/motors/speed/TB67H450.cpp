@@ -3,58 +3,59 @@
 #include <digitalWriteFast.h>
 
 // コンストラクタ: モーター制御用のピンを設定
-TB67H450::TB67H450(uint8_t in1, uint8_t in2) : in1(in1), in2(in2) {
-  // ピンを出力モードに設定
-  pinModeFast(in1, OUTPUT);
-  pinModeFast(in2, OUTPUT);
-}
-
-// モーターを制御する内部メソッド
-// PWM信号を使用してモーターを制御
-void TB67H450::runAnalogue(uint8_t analogueValue1, uint8_t analogueValue2) {
-  // 指定されたピンに PWM 信号を出力
-  analogWrite(in1, analogueValue1);
-  analogWrite(in2, analogueValue2);
-}
-
-// モーターを制御する内部メソッド
-// デジタル信号を使用してモーターを制御
-void TB67H450::runDigital(bool digitalValue1, bool digitalValue2) {
-  // 指定されたピンにデジタル信号を出力
-  digitalWriteFast(in1, digitalValue1);
-  digitalWriteFast(in2, digitalValue2);
-}
+// (ピンの出力モードは out1 と out2 が設定)
+TB67H450::TB67H450(uint8_t in1, uint8_t in2)
+    : in1(in1), in2(in2), out1(in1), out2(in2) {}
 
 // 正転メソッド: モーターを前進させる
 void TB67H450::forward() {
-  setSpeed(1.0); // 最大出力で前進
+  setPwm(255); // 最大出力で前進
 }
 
 // 後転メソッド: モーターを後退させる
 void TB67H450::reverse() {
-  setSpeed(-1.0); // 最大出力で後退
+  setPwm(-255); // 最大出力で後退
 }
 
 // モーター停止メソッド: モーターを停止させる
 void TB67H450::stop() {
-  setSpeed(0); // 速度を 0 に設定
+  setPwm(0); // PWM値を 0 に設定
 }
 
-// モーターの速度を設定するメソッド
-void TB67H450::setSpeed(float rate) {
-  // スピードの範囲を -1.0 から 1.0 に制限
-  rate = constrain(rate, -1.0, 1.0);
-
-  if (abs(rate) == 1.0) {
-    // 最大出力で前進または後退
-    runDigital(rate > 0, rate < 0);
-  } else if (rate == 0) {
-    // 停止
-    runDigital(LOW, LOW);
+// モーターの速度をPWM値で設定するメソッド
+void TB67H450::setPwm(int16_t pwm) {
+  // PWM値の範囲を -255 から 255 に制限
+  pwm = constrain(pwm, -255, 255);
+
+  // 正転または後転の PWM 信号を出力
+  // (0 と 255 はデジタル出力になり、タイマーから切り離される)
+  uint8_t pwmValue = static_cast<uint8_t>(pwm > 0 ? pwm : -pwm);
+  out1.write(pwm > 0 ? pwmValue : 0);
+  out2.write(pwm < 0 ? pwmValue : 0);
+}
+
+// PWM値に対応するピンへの出力を取得するメソッド
+uint8_t TB67H450::getPinWrites(int16_t pwm, MotorPinWrite *writes) const {
+  // PWM値の範囲を -255 から 255 に制限
+  pwm = constrain(pwm, -255, 255);
+
+  if (pwm == 255 || pwm == -255 || pwm == 0) {
+    // 最大出力で前進または後退、または停止
+    writes[0] = MotorPinWrite::digital(in1, pwm > 0);
+    writes[1] = MotorPinWrite::digital(in2, pwm < 0);
   } else {
-    // 速度に応じた PWM 値を計算
-    uint8_t pwmValue = (uint8_t)(abs(rate) * 255);
+    // 速度に応じた PWM 値
+    uint8_t pwmValue = static_cast<uint8_t>(pwm > 0 ? pwm : -pwm);
     // 正転または後転の PWM 信号を出力
-    runAnalogue(rate > 0 ? pwmValue : 0, rate < 0 ? pwmValue : 0);
+    writes[0] = MotorPinWrite::analog(in1, pwm > 0 ? pwmValue : 0);
+    writes[1] = MotorPinWrite::analog(in2, pwm < 0 ? pwmValue : 0);
   }
+  return 2;
+}
+
+// PWMの周波数を設定するメソッド
+bool TB67H450::setPwmFrequency(PwmFrequency frequency) {
+  bool result1 = out1.setFrequency(frequency);
+  bool result2 = out2.setFrequency(frequency);
+  return result1 && result2;
 }
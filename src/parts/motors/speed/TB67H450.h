@@ -3,8 +3,10 @@
  * @brief TB67H450モータードライバのクラス定義
  *
  * このファイルには、TB67H450モータードライバを制御するための
- * `TB67H450` クラスが定義されています。このクラスは `ISpeedAdjustable` クラスを
- * 継承し、モーターの前進、後退、停止、速度設定の機能を提供します。
+ * `TB67H450` クラスと `StaticTB67H450` クラスが定義されています。`TB67H450` クラスは
+ * `ISpeedAdjustable` クラスを継承し、モーターの前進、後退、停止、速度設定の
+ * 機能を提供します。`StaticTB67H450` クラスはピン番号をコンパイル時に指定し、
+ * 仮想関数を使用せずに同じ機能を提供します。
  *
  * @note このクラスは、PWM信号を使用してモーターを制御します。
  */
@@ -12,6 +14,9 @@
 #pragma once
 
 #include "ISpeedAdjustable.h"
+#include "SpeedAdjustable.h"
+#include <digitalWriteFast.h>
+#include <fasts/FastPwm.h>
 
 /**
  * @class TB67H450
@@ -25,26 +30,8 @@ class TB67H450 : public ISpeedAdjustable {
 private:
   uint8_t in1; /**< PWM信号を出力するピンの番号1 */
   uint8_t in2; /**< PWM信号を出力するピンの番号2 */
-
-  /**
-   * @brief モーターを制御する内部メソッド
-   *
-   * このメソッドは、指定されたPWM値に基づいてモーターを制御します。
-   *
-   * @param analogueValue1 PWM信号の値1（0〜255）
-   * @param analogueValue2 PWM信信号の値2（0〜255）
-   */
-  void runAnalogue(uint8_t analogueValue1, uint8_t analogueValue2);
-
-  /**
-   * @brief モーターを制御する内部メソッド
-   *
-   * このメソッドは、指定されたデジタル値に基づいてモーターを制御します。
-   *
-   * @param digitalValue1 デジタル信号の値1（HIGH または LOW）
-   * @param digitalValue2 デジタル信号の値2（HIGH または LOW）
-   */
-  void runDigital(bool digitalValue1, bool digitalValue2);
+  FastPwm out1; /**< ピン1への出力 */
+  FastPwm out2; /**< ピン2への出力 */
 
 public:
   /**
@@ -79,12 +66,91 @@ public:
   void stop() override;
 
   /**
-   * @brief モーターの速度を設定するメソッド
+   * @brief モーターの速度をPWM値で設定するメソッド
+   *
+   * このメソッドは、モーターの速度を整数のPWM値で設定します。PWM値は
+   * -255（最大逆転速度）から255（最大速度）までの範囲で設定できます。
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   */
+  void setPwm(int16_t pwm) override;
+
+  /**
+   * @brief PWM値に対応するピンへの出力を取得するメソッド
+   *
+   * `setPwm()` が行う出力を、出力する順に `writes` に格納します。
+   * `MotorGroup` が使用します（`setPwm()` はピンに直接出力します）。
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   * @param writes 出力を格納する配列（`MAX_PIN_WRITES` 個以上）
+   * @return 格納した出力の数
+   */
+  uint8_t getPinWrites(int16_t pwm, MotorPinWrite *writes) const override;
+
+  /**
+   * @brief PWMの周波数を設定するメソッド
+   *
+   * 周波数を高くすると、PWMによるモーターの音が聞こえなくなります。
+   * 同じタイマーを使用する他のピンの周波数も変わります。
+   *
+   * @param frequency PWMの周波数
+   * @return 設定できた場合は true（Timer0のピン5、6、タイマーのないピン、
+   * MsTimer2が使用しているTimer2のピン3、11は false）
+   */
+  bool setPwmFrequency(PwmFrequency frequency);
+};
+
+/**
+ * @class StaticTB67H450
+ * @brief ピン番号をコンパイル時に指定するTB67H450モータードライバのクラス
+ *
+ * 仮想関数を持たないため、メソッドの呼び出しはインライン展開されます。
+ * PWM出力はコンパイル時に決まるコンペアレジスタに直接書き込みます（`StaticPwm`）。
+ * `ISpeedAdjustable` として扱う場合は `VirtualMotor` を使用してください。
+ *
+ * @tparam In1Pin PWM信号を出力するピンの番号1
+ * @tparam In2Pin PWM信号を出力するピンの番号2
+ */
+template <uint8_t In1Pin, uint8_t In2Pin>
+class StaticTB67H450
+    : public SpeedAdjustable<StaticTB67H450<In1Pin, In2Pin>> {
+public:
+  /**
+   * @brief コンストラクタ
+   *
+   * モーター制御用のピンを出力モードに設定します。
+   */
+  StaticTB67H450() {
+    pinModeFast(In1Pin, OUTPUT);
+    pinModeFast(In2Pin, OUTPUT);
+  }
+
+  /**
+   * @brief モーターの速度をPWM値で設定するメソッド
+   *
+   * @param pwm モーターのPWM値（-255〜255）
+   */
+  void setPwm(int16_t pwm) {
+    pwm = constrain(pwm, -255, 255);
+    // 正転または後転の PWM 信号を出力
+    // (0 と 255 はデジタル出力になり、タイマーから切り離される)
+    uint8_t pwmValue = static_cast<uint8_t>(pwm > 0 ? pwm : -pwm);
+    StaticPwm<In1Pin>::write(pwm > 0 ? pwmValue : 0);
+    StaticPwm<In2Pin>::write(pwm < 0 ? pwmValue : 0);
+  }
+
+  /**
+   * @brief PWMの周波数を設定するメソッド
    *
-   * このメソッドは、モーターの速度を指定した割合で設定します。速度は
-   * -1.0（最大逆転速度）から1.0（最大速度）までの範囲で設定できます。
+   * 同じタイマーを使用する他のピンの周波数も変わります。
    *
-   * @param rate モーターの速度割合（-1.0〜1.0）
+   * @param frequency PWMの周波数
+   * @return 設定できた場合は true（Timer0のピン5、6、タイマーのないピン、
+   * MsTimer2が使用しているTimer2のピン3、11は false）
    */
-  void setSpeed(float rate) override;
-};
\ No newline at end of file
+  bool setPwmFrequency(PwmFrequency frequency) {
+    bool result1 = StaticPwm<In1Pin>::setFrequency(frequency);
+    bool result2 = StaticPwm<In2Pin>::setFrequency(frequency);
+    return result1 && result2;
+  }
+};
@@ -0,0 +1,39 @@
+/**
+ * @file HasBulkWrite.h
+ * @brief 一括書き込みができるかどうかをチェックするテンプレートクラス
+ *
+ * このヘッダーファイルでは、シリアルポートクラスが
+ * `write(const uint8_t *buffer, size_t size)` を持っているかどうかを
+ * コンパイル時にチェックするテンプレートクラス `HasBulkWrite` を定義します。
+ * 一括書き込みができる場合とできない場合で、送信処理を切り替えるために使用します。
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 一括書き込みができるかどうかをチェックするクラス
+ *
+ * `SerialType` が `write(const uint8_t *, size_t)`
+ * を呼び出せる場合に `value` が `true` になります。
+ * 例えば、Arduinoの `HardwareSerial` は `Print` クラスから継承しているため
+ * `true` になります。
+ *
+ * @tparam SerialType チェック対象のシリアルポートクラスの型
+ */
+template <typename SerialType> struct HasBulkWrite {
+private:
+  /// `write(const uint8_t *, size_t)` を呼び出せる場合に選択される関数
+  template <typename U>
+  static char test(decltype(static_cast<U *>(nullptr)->write(
+      static_cast<const uint8_t *>(nullptr), static_cast<size_t>(0))) *);
+
+  /// それ以外の場合に選択される関数
+  template <typename U> static long test(...);
+
+public:
+  /// 一括書き込みができる場合は `true`、できない場合は `false`。
+  static const bool value = sizeof(test<SerialType>(nullptr)) == sizeof(char);
+};
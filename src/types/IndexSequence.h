@@ -0,0 +1,42 @@
+/**
+ * @file IndexSequence.h
+ * @brief 0から始まる連番を型として表すテンプレートクラス
+ *
+ * このヘッダーファイルでは、`std::index_sequence` に似た機能を提供する
+ * `IndexSequence` と、それを生成する `MakeIndexSequence` を定義します。
+ * コンパイル時に計算した値で配列を初期化するために使用します。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief 連番を保持するクラス
+ *
+ * @tparam indices 連番
+ */
+template <uint16_t... indices> struct IndexSequence {};
+
+/**
+ * @brief 0から `N - 1` までの連番を生成するクラス
+ *
+ * `MakeIndexSequence<3>::Type` は `IndexSequence<0, 1, 2>` になります。
+ *
+ * @tparam N 連番の長さ
+ * @tparam indices 生成済みの連番（内部で使用）
+ */
+template <uint16_t N, uint16_t... indices> struct MakeIndexSequence {
+  /// 末尾から1つずつ連番を追加する
+  using Type = typename MakeIndexSequence<N - 1, N - 1, indices...>::Type;
+};
+
+/**
+ * @brief 連番の生成が終わった場合の部分特殊化
+ *
+ * @tparam indices 生成した連番
+ */
+template <uint16_t... indices> struct MakeIndexSequence<0, indices...> {
+  /// 生成した連番
+  using Type = IndexSequence<indices...>;
+};
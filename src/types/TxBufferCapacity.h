@@ -0,0 +1,51 @@
+/**
+ * @file TxBufferCapacity.h
+ * @brief シリアルポートの送信バッファに格納できるバイト数を取得するテンプレートクラス
+ *
+ * このヘッダーファイルでは、シリアルポートクラスの `availableForWrite()` が
+ * 返すことのできる最大値を、コンパイル時に取得するテンプレートクラス
+ * `TxBufferCapacity` を定義します。送信バッファより大きいフレームを送信する際に、
+ * 空き容量が足りるまで待ち続けないようにするために使用します。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief 送信バッファに格納できるバイト数の既定値
+ *
+ * Arduinoの `HardwareSerial` の送信バッファは `SERIAL_TX_BUFFER_SIZE`
+ * バイトで、満杯と空を区別するため `SERIAL_TX_BUFFER_SIZE - 1` バイトまで格納できます。
+ */
+#if defined(SERIAL_TX_BUFFER_SIZE)
+#define TX_BUFFER_CAPACITY_DEFAULT (SERIAL_TX_BUFFER_SIZE - 1)
+#else
+#define TX_BUFFER_CAPACITY_DEFAULT 63
+#endif
+
+/**
+ * @brief 送信バッファに格納できるバイト数を取得するクラス
+ *
+ * `SerialType` が `static const uint8_t TX_BUFFER_CAPACITY` を持っている場合は
+ * その値、持っていない場合は `HardwareSerial` と同じ値が `value` になります。
+ *
+ * @tparam SerialType 対象のシリアルポートクラスの型
+ */
+template <typename SerialType> struct TxBufferCapacity {
+private:
+  /// `TX_BUFFER_CAPACITY` を持っている場合に選択される関数
+  template <typename U>
+  static constexpr uint8_t get(decltype(&U::TX_BUFFER_CAPACITY)) {
+    return U::TX_BUFFER_CAPACITY;
+  }
+
+  /// それ以外の場合に選択される関数
+  template <typename U> static constexpr uint8_t get(...) {
+    return TX_BUFFER_CAPACITY_DEFAULT;
+  }
+
+public:
+  /// `availableForWrite()` が返すことのできる最大値
+  static const uint8_t value = get<SerialType>(nullptr);
+};
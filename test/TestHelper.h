@@ -0,0 +1,55 @@
+/**
+ * @file TestHelper.h
+ * @brief ホストで実行するテストのための簡単なチェック用マクロ
+ *
+ * チェックに失敗した場合は、ファイル名と行番号を出力してテストを続けます。
+ * `main()` の最後で `testResult()` を返すと、失敗があった場合に ctest が失敗を報告します。
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+namespace testing {
+/// 失敗したチェックの数
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+
+inline void check(bool passed, const char *expression, const char *file,
+                  int line) {
+  if (!passed) {
+    failures()++;
+    fprintf(stderr, "%s:%d: チェックに失敗しました: %s\n", file, line,
+            expression);
+  }
+}
+
+template <typename A, typename B>
+void checkEqual(const A &actual, const B &expected, const char *expression,
+                const char *file, int line) {
+  if (!(actual == expected)) {
+    failures()++;
+    fprintf(stderr, "%s:%d: チェックに失敗しました: %s (%lld != %lld)\n", file,
+            line, expression, static_cast<long long>(actual),
+            static_cast<long long>(expected));
+  }
+}
+} // namespace testing
+
+#define EXPECT_TRUE(expression)                                                \
+  testing::check((expression), #expression, __FILE__, __LINE__)
+#define EXPECT_EQ(actual, expected)                                            \
+  testing::checkEqual((actual), (expected), #actual " == " #expected,         \
+                      __FILE__, __LINE__)
+
+/// テストの結果（失敗がない場合は0）
+inline int testResult() {
+  if (testing::failures() == 0) {
+    printf("OK\n");
+    return 0;
+  }
+  fprintf(stderr, "%d 件のチェックに失敗しました\n", testing::failures());
+  return 1;
+}
@@ -0,0 +1,238 @@
+// ButtonGestures のテスト
+//
+// 時刻付きの押した・離した瞬間の並びを与え、検出した操作を「時刻:種類ボタン」の
+// 並びとして確認します（P: 押した、R: 離した、L: 長押し、D: ダブルクリック、
+// +: 連続入力）。クリック、ダブルクリック、遅い2回目のクリック、連続入力、
+// 16ビットの時刻の一周、キューが一杯の場合と、ButtonGroup と組み合わせた場合を
+// 確認します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <parts/ButtonGestures.h>
+#include <stdio.h>
+#include <string>
+
+namespace {
+
+/// 操作を与え、検出した操作を文字列に記録する
+class Replay {
+public:
+  ButtonGestures gestures;
+  std::string log; ///< 検出した操作
+
+  void press(uint8_t button, uint16_t now) { edge(button, true, now); }
+  void release(uint8_t button, uint16_t now) { edge(button, false, now); }
+
+  void tick(uint16_t now) {
+    gestures.tick(now);
+    drain(now);
+  }
+
+  /// from から to まで step ミリ秒ごとに tick() を呼び出す
+  /// （時刻は32ビットで進め、16ビットに切り詰めて渡す）
+  void tickUntil(uint32_t from, uint32_t to, uint16_t step) {
+    for (uint32_t t = from; t <= to; t += step) {
+      tick(static_cast<uint16_t>(t));
+    }
+  }
+
+  /// キューから全ての操作を取り出して記録する
+  void drain(uint16_t now) {
+    ButtonEvent event;
+    while (gestures.poll(event)) {
+      char text[16];
+      snprintf(text, sizeof(text), "%s%u:%c%u", log.empty() ? "" : " ", now,
+               "PRLD+"[static_cast<uint8_t>(event.type)], event.button);
+      log += text;
+    }
+  }
+
+private:
+  void edge(uint8_t button, bool pressed, uint16_t now) {
+    gestures.handleEdge(button, pressed, now);
+    drain(now);
+  }
+};
+
+/// 記録した操作が期待通りか確認する
+void checkLog(const Replay &replay, const char *expected) {
+  EXPECT_TRUE(replay.log == expected);
+  if (replay.log != expected) {
+    printf("  期待 %s\n  結果 %s\n", expected, replay.log.c_str());
+  }
+}
+
+// 短く押して離す。待ち時間を過ぎた次のクリックはダブルクリックではない
+void testSingleClick() {
+  Replay r;
+  r.press(0, 1000);
+  r.tickUntil(1000, 1100, 10);
+  r.release(0, 1100);
+  r.tickUntil(1100, 1500, 10);
+  r.press(0, 1500);
+  r.release(0, 1550);
+  checkLog(r, "1000:P0 1100:R0 1500:P0 1550:R0");
+}
+
+// 離してから300ms以内に押すとダブルクリック。3回目は新しい1回目になる
+void testDoubleClick() {
+  Replay r;
+  r.press(0, 0);
+  r.release(0, 100);
+  r.tickUntil(100, 300, 10);
+  r.press(0, 300);
+  r.release(0, 400);
+  r.press(0, 500);
+  r.release(0, 550);
+  r.press(0, 600);
+  checkLog(r, "0:P0 100:R0 300:P0 300:D0 400:R0 500:P0 550:R0 600:P0 600:D0");
+
+  // ちょうど300msはダブルクリック
+  Replay boundary;
+  boundary.press(1, 0);
+  boundary.release(1, 100);
+  boundary.tickUntil(100, 400, 10);
+  boundary.press(1, 400);
+  checkLog(boundary, "0:P1 100:R1 400:P1 400:D1");
+}
+
+// 2回目のクリックが遅い場合は、tick() の有無に関わらずダブルクリックではない
+void testSlowSecondClick() {
+  Replay ticked;
+  ticked.press(1, 0);
+  ticked.release(1, 100);
+  ticked.tickUntil(100, 401, 1);
+  ticked.press(1, 401);
+  checkLog(ticked, "0:P1 100:R1 401:P1");
+
+  Replay untimed;
+  untimed.press(1, 0);
+  untimed.release(1, 100);
+  untimed.press(1, 401);
+  checkLog(untimed, "0:P1 100:R1 401:P1");
+}
+
+// 800msで長押し、その後200msごとに連続入力。長押しの後のクリックは1回目になる
+void testRepeat() {
+  Replay r;
+  r.press(0, 0);
+  r.tickUntil(0, 1500, 10);
+  r.release(0, 1500);
+  r.press(0, 1600);
+  checkLog(r, "0:P0 800:L0 1000:+0 1200:+0 1400:+0 1500:R0 1600:P0");
+
+  // 7msごとの呼び出しでも、連続入力の基準は遅れない
+  // （1000、1200、…、10000ms の46回）
+  Replay jitter;
+  jitter.press(2, 0);
+  uint32_t repeats = 0;
+  for (uint32_t t = 0; t <= 10003; t += 7) {
+    jitter.gestures.tick(t);
+    ButtonEvent event;
+    while (jitter.gestures.poll(event)) {
+      repeats += event.type == ButtonEventType::REPEAT ? 1 : 0;
+    }
+  }
+  EXPECT_EQ(repeats, 46u);
+
+  // 1周期以上遅れた場合は1回だけ送り、その時刻を基準にする
+  Replay late;
+  late.press(0, 0);
+  late.tick(800);
+  late.tick(1450);
+  late.tick(1649);
+  late.tick(1650);
+  checkLog(late, "0:P0 800:L0 1450:+0 1650:+0");
+}
+
+// 16ビットの時刻が一周しても、時間を正しく測る
+void testWrap() {
+  Replay r;
+  r.press(2, 65000);
+  r.tickUntil(65000, 66000, 10);
+  checkLog(r, "65000:P2 264:L2 464:+2");
+
+  Replay doubled;
+  doubled.press(0, 65400);
+  doubled.release(0, 65500);
+  doubled.press(0, static_cast<uint16_t>(65636));
+  checkLog(doubled, "65400:P0 65500:R0 100:P0 100:D0");
+
+  // 1回目のクリックの記録は tick() で消えるため、一周後の同じ時刻に押しても
+  // ダブルクリックにならない
+  Replay stale;
+  stale.press(0, 0);
+  stale.release(0, 100);
+  stale.tickUntil(100, 65100, 1000);
+  stale.press(0, static_cast<uint16_t>(65636));
+  checkLog(stale, "0:P0 100:R0 100:P0");
+}
+
+// キューが一杯のときの操作は捨て、取り出した順序は変わらない
+void testQueueOverflow() {
+  Replay r;
+  for (uint8_t i = 0; i < ButtonGestures::MAX_BUTTONS; i++) {
+    r.gestures.handleEdge(i, true, 0);
+  }
+  for (uint8_t i = 0; i < ButtonGestures::MAX_BUTTONS; i++) {
+    r.gestures.handleEdge(i, false, 50); // 捨てられる
+  }
+  EXPECT_EQ(r.gestures.available(), ButtonGestures::QUEUE_SIZE);
+
+  ButtonEvent event;
+  for (uint8_t i = 0; i < 3; i++) {
+    EXPECT_TRUE(r.gestures.poll(event));
+    EXPECT_EQ(event.button, i);
+    EXPECT_TRUE(event.type == ButtonEventType::PRESS);
+  }
+  // 空いた3つに入り、ダブルクリックのうち入らなかった1つは捨てられる
+  r.gestures.handleEdge(0, true, 100);
+  r.gestures.handleEdge(1, true, 100);
+  EXPECT_EQ(r.gestures.available(), ButtonGestures::QUEUE_SIZE);
+  r.drain(100);
+  checkLog(r, "100:P3 100:P4 100:P5 100:P6 100:P7 100:P0 100:D0 100:P1");
+  EXPECT_TRUE(!r.gestures.poll(event));
+  EXPECT_EQ(r.gestures.available(), 0);
+}
+
+// 0msを指定しても1msとして扱い、同じ時刻の tick() で連続入力を送らない
+void testZeroTimings() {
+  Replay r;
+  r.gestures.setTimings(0, 0, 300);
+  r.press(0, 0);
+  r.tick(0);
+  r.tick(1);
+  r.tick(1);
+  r.tick(2);
+  r.tick(2);
+  checkLog(r, "0:P0 1:L0 2:+0");
+}
+
+// ButtonGroup のチャタリングを取り除いた状態から検出する
+void testWithButtonGroup() {
+  sim::reset();
+  ButtonGroup buttons;
+  buttons.add(2);
+  Replay r;
+  for (uint16_t t = 0; t <= 1200; t += 5) {
+    // 100msから1100msまで押す（押した直後に2回跳ね返る）
+    bool pressed = t >= 100 && t < 1100 && t != 110 && t != 120;
+    buttons.update(pressed ? 0xFF & ~_BV(2) : 0xFF);
+    r.gestures.update(buttons, t);
+    r.drain(t);
+  }
+  checkLog(r, "140:P0 940:L0 1115:R0");
+}
+
+} // namespace
+
+int main() {
+  testSingleClick();
+  testDoubleClick();
+  testSlowSecondClick();
+  testRepeat();
+  testWrap();
+  testQueueOverflow();
+  testZeroTimings();
+  testWithButtonGroup();
+  return testResult();
+}
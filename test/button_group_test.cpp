@@ -0,0 +1,193 @@
+// ButtonGroup のテスト
+//
+// チャタリングを含むボタンの状態の並びを与え、押された瞬間と離された瞬間が
+// 同じ状態が4回続いた時に1回だけ検出されることを確認します。
+// 8個のボタンにランダムなチャタリングを与えた場合も、ボタンごとに数える簡単な
+// 実装と毎回同じ結果になることを確認し、update() の処理時間を表示します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <chrono>
+#include <parts/ButtonGroup.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+/// ポートDの8個のピン（ボタンの番号とポートのビットの順序を変えておく）
+const uint8_t PINS[ButtonGroup::MAX_BUTTONS] = {7, 0, 6, 1, 5, 2, 4, 3};
+
+/// ポートDの全てのピンを追加したボタン
+void addAll(ButtonGroup &buttons) {
+  for (uint8_t pin : PINS) {
+    buttons.add(pin);
+  }
+}
+
+/// ボタンの番号のビット（1が押されている）をポートの値（LOWが押されている）にする
+uint8_t toPort(uint8_t pressed) {
+  uint8_t port = 0xFF;
+  for (uint8_t i = 0; i < ButtonGroup::MAX_BUTTONS; i++) {
+    if (pressed & (1 << i)) {
+      port &= ~_BV(PINS[i]);
+    }
+  }
+  return port;
+}
+
+// チャタリングを含む並び（Lが押されている）を与え、検出した瞬間を
+// 押された瞬間はP、離された瞬間はRとして並べる
+void checkTrace(const char *samples, const char *expected) {
+  ButtonGroup buttons;
+  addAll(buttons);
+  char events[64] = {};
+  for (size_t i = 0; i < strlen(samples); i++) {
+    buttons.update(toPort(samples[i] == 'L' ? 0x01 : 0));
+    bool pressed = buttons.wasPressed(0);
+    bool released = buttons.wasReleased(0);
+    events[i] = pressed ? 'P' : (released ? 'R' : '.');
+    // 他のボタンは変化しない
+    EXPECT_EQ(buttons.pressedBits() & 0xFE, 0);
+    EXPECT_EQ(buttons.releasedBits() & 0xFE, 0);
+    EXPECT_EQ(buttons.isPressed(0), buttons.stateBits() == 0x01);
+  }
+  EXPECT_TRUE(strcmp(events, expected) == 0);
+  if (strcmp(events, expected) != 0) {
+    printf("  入力 %s\n  期待 %s\n  結果 %s\n", samples, expected, events);
+  }
+}
+
+// 同じ状態が4回続いた時に1回だけ検出する
+void testTraces() {
+  // チャタリングなし
+  checkTrace("HHLLLLLLHHHHHH", //
+             ".....P.....R..");
+  // 押した時と離した時のチャタリング
+  checkTrace("HLHLHLLLLLLHLHLHHHHH", //
+             "........P.........R.");
+  // 押している間の3回までのノイズは無視する
+  checkTrace("LLLLHLLHHLLHHHLLLL", //
+             "...P..............");
+  // 3回だけ押されたのは無視する
+  checkTrace("LLLHHLLLHLLLHHH", //
+             "...............");
+  // 4回押されて、すぐに離す
+  checkTrace("LLLLHHHH", //
+             "...P...R");
+}
+
+/// ボタンごとに、確定した状態と異なった回数を数える実装
+struct ReferenceButtons {
+  uint8_t state = 0;
+  uint8_t counts[ButtonGroup::MAX_BUTTONS] = {};
+  uint8_t pressed = 0;
+  uint8_t released = 0;
+
+  void update(uint8_t sample) {
+    pressed = released = 0;
+    for (uint8_t i = 0; i < ButtonGroup::MAX_BUTTONS; i++) {
+      uint8_t bit = 1 << i;
+      if ((sample & bit) == (state & bit)) {
+        counts[i] = 0;
+      } else if (++counts[i] == ButtonGroup::STABLE_SAMPLES) {
+        counts[i] = 0;
+        state ^= bit;
+        (state & bit ? pressed : released) |= bit;
+      }
+    }
+  }
+};
+
+// 8個のボタンにランダムなチャタリングを与えても、ボタンごとに数えた結果と同じ
+void testRandomBounce() {
+  srand(1);
+  ButtonGroup buttons;
+  addAll(buttons);
+  ReferenceButtons reference;
+  uint8_t contact = 0; // 接点の状態（押されているビットが1）
+  uint32_t mismatches = 0;
+  uint32_t events = 0;
+  for (uint32_t i = 0; i < 200000; i++) {
+    // 各ボタンは時々押したり離したりし、その後しばらくチャタリングする
+    for (uint8_t b = 0; b < ButtonGroup::MAX_BUTTONS; b++) {
+      if (rand() % 8 == 0) {
+        contact ^= 1 << b;
+      }
+    }
+    uint8_t sample = contact ^ (rand() & rand() & rand());
+    buttons.update(toPort(sample));
+    reference.update(sample);
+    mismatches += buttons.stateBits() == reference.state &&
+                          buttons.pressedBits() == reference.pressed &&
+                          buttons.releasedBits() == reference.released
+                      ? 0
+                      : 1;
+    events += reference.pressed != 0 || reference.released != 0 ? 1 : 0;
+  }
+  EXPECT_EQ(mismatches, 0u);
+  EXPECT_TRUE(events > 1000);
+}
+
+// update() はポートの入力レジスタを読み込み、別のポートと9個目は追加しない
+void testPortAndLimits() {
+  sim::reset();
+  PIND = 0xFF;
+  ButtonGroup buttons;
+  EXPECT_EQ(buttons.add(4), 0);
+  EXPECT_EQ(buttons.add(8), ButtonGroup::INVALID_INDEX); // ポートB
+  EXPECT_EQ(buttons.add(2), 1);
+  EXPECT_EQ(PORTD, _BV(4) | _BV(2)); // 内部プルアップ
+  const uint8_t others[] = {0, 1, 3, 5, 6, 7};
+  for (uint8_t pin : others) {
+    buttons.add(pin);
+  }
+  EXPECT_EQ(buttons.size(), 8);
+  EXPECT_EQ(buttons.add(0), ButtonGroup::INVALID_INDEX);
+
+  sim::setInput(2, false);
+  for (uint8_t i = 0; i < ButtonGroup::STABLE_SAMPLES; i++) {
+    EXPECT_TRUE(!buttons.isPressed(1));
+    buttons.update();
+  }
+  EXPECT_TRUE(buttons.wasPressed(1));
+  EXPECT_EQ(buttons.pressedBits(), 0x02);
+  EXPECT_TRUE(!buttons.wasPressed(ButtonGroup::INVALID_INDEX));
+}
+
+/// update() 1回あたりの処理時間（ナノ秒）を測る
+double measure(uint8_t numButtons, bool bouncing) {
+  ButtonGroup buttons;
+  for (uint8_t i = 0; i < numButtons; i++) {
+    buttons.add(PINS[i]);
+  }
+  const int updates = 1000000;
+  volatile uint8_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < updates; i++) {
+    buttons.update(bouncing ? static_cast<uint8_t>(i * 37) : 0xFF);
+    sink = sink + buttons.isPressed(0);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         updates;
+}
+
+// ボタンの数とチャタリングの有無による処理時間
+// （ボタンの数によらず一定であることを表示するだけで、チェックはしない）
+void benchmark() {
+  double one = measure(1, false);
+  double eight = measure(8, false);
+  double bouncing = measure(8, true);
+  printf("update() 1回: 1個 %.2f ns、8個 %.2f ns、8個（チャタリング中） %.2f ns\n",
+         one, eight, bouncing);
+}
+
+} // namespace
+
+int main() {
+  testTraces();
+  testRandomBounce();
+  testPortAndLimits();
+  benchmark();
+  return testResult();
+}
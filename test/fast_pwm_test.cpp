@@ -0,0 +1,245 @@
+// FastPwm と StaticPwm のテスト
+//
+// 模擬したATmega328Pのタイマーのレジスタ（TCCRnA/B、OCRnx）とポートを全て記録し、
+// PWM値の出力と周波数の設定で、ピンに対応するレジスタだけが書き換わることを確認します。
+// ピン番号をコンパイル時に指定するモータードライバも同じレジスタに書き込むことと、
+// analogWrite() と同じ出力になることも確認します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <fasts/FastPwm.h>
+#include <parts/motors/speed/BD62193.h>
+#include <parts/motors/speed/TB67H450.h>
+#include <string.h>
+
+namespace {
+
+/// レジスタの名前
+enum Register {
+  REG_TCCR0A,
+  REG_TCCR0B,
+  REG_OCR0A,
+  REG_OCR0B,
+  REG_TCCR1A,
+  REG_TCCR1B,
+  REG_OCR1A,
+  REG_OCR1B,
+  REG_TCCR2A,
+  REG_TCCR2B,
+  REG_OCR2A,
+  REG_OCR2B,
+  REG_PORTB,
+  REG_PORTC,
+  REG_PORTD,
+  NUM_REGISTERS
+};
+
+/// 全てのタイマーのレジスタとポートの値
+struct Registers {
+  uint16_t values[NUM_REGISTERS];
+
+  static Registers read() {
+    Registers r = {{TCCR0A, TCCR0B, OCR0A, OCR0B, TCCR1A, TCCR1B, OCR1A, OCR1B,
+                    TCCR2A, TCCR2B, OCR2A, OCR2B, PORTB, PORTC, PORTD}};
+    return r;
+  }
+
+  /// 値が変わったレジスタのビット
+  uint32_t changed(const Registers &before) const {
+    uint32_t bits = 0;
+    for (uint8_t i = 0; i < NUM_REGISTERS; i++) {
+      if (values[i] != before.values[i]) {
+        bits |= 1UL << i;
+      }
+    }
+    return bits;
+  }
+};
+
+/// タイマーのあるピンと、対応するレジスタ
+struct TimerPin {
+  uint8_t pin;
+  Register control; ///< TCCRnA
+  uint8_t connectBit;
+  Register compare; ///< OCRnx
+  Register prescaler; ///< TCCRnB
+  Register port;
+  uint8_t portBit;
+};
+
+const TimerPin timerPins[] = {
+    {3, REG_TCCR2A, _BV(COM2B1), REG_OCR2B, REG_TCCR2B, REG_PORTD, _BV(3)},
+    {5, REG_TCCR0A, _BV(COM0B1), REG_OCR0B, REG_TCCR0B, REG_PORTD, _BV(5)},
+    {6, REG_TCCR0A, _BV(COM0A1), REG_OCR0A, REG_TCCR0B, REG_PORTD, _BV(6)},
+    {9, REG_TCCR1A, _BV(COM1A1), REG_OCR1A, REG_TCCR1B, REG_PORTB, _BV(1)},
+    {10, REG_TCCR1A, _BV(COM1B1), REG_OCR1B, REG_TCCR1B, REG_PORTB, _BV(2)},
+    {11, REG_TCCR2A, _BV(COM2A1), REG_OCR2A, REG_TCCR2B, REG_PORTB, _BV(3)},
+};
+
+/// PWM値を出力し、書き換わったレジスタが期待通りか確認する
+template <typename Write>
+void checkWrite(const TimerPin &timerPin, Write write) {
+  sim::reset();
+  Registers before = Registers::read();
+  write(100);
+  Registers after = Registers::read();
+  // コンペアレジスタとピンの接続だけが書き換わる
+  EXPECT_EQ(after.changed(before),
+            (1UL << timerPin.compare) | (1UL << timerPin.control));
+  EXPECT_EQ(after.values[timerPin.compare], 100);
+  EXPECT_EQ(after.values[timerPin.control], timerPin.connectBit);
+
+  // 255はピンを切り離し、ポートをHIGHにする
+  before = after;
+  write(255);
+  after = Registers::read();
+  EXPECT_EQ(after.changed(before),
+            (1UL << timerPin.control) | (1UL << timerPin.port));
+  EXPECT_EQ(after.values[timerPin.control], 0);
+  EXPECT_EQ(after.values[timerPin.port], timerPin.portBit);
+
+  // 0はポートをLOWにする（切り離し済み）
+  before = after;
+  write(0);
+  after = Registers::read();
+  EXPECT_EQ(after.changed(before), 1UL << timerPin.port);
+}
+
+/// ピン番号ごとに StaticPwm<Pin>::write を呼び出す
+void staticWrite(uint8_t pin, uint8_t value) {
+  switch (pin) {
+  case 3:
+    StaticPwm<3>::write(value);
+    break;
+  case 5:
+    StaticPwm<5>::write(value);
+    break;
+  case 6:
+    StaticPwm<6>::write(value);
+    break;
+  case 9:
+    StaticPwm<9>::write(value);
+    break;
+  case 10:
+    StaticPwm<10>::write(value);
+    break;
+  case 11:
+    StaticPwm<11>::write(value);
+    break;
+  }
+}
+
+// 各ピンは自分のコンペアレジスタとピンの接続ビットだけを書き換える
+void testWriteRegisters() {
+  for (const TimerPin &timerPin : timerPins) {
+    FastPwm pwm(timerPin.pin);
+    checkWrite(timerPin, [&](uint8_t value) { pwm.write(value); });
+    checkWrite(timerPin,
+               [&](uint8_t value) { staticWrite(timerPin.pin, value); });
+    EXPECT_EQ(FastPwm::pinTimer(timerPin.pin),
+              digitalPinToTimer(timerPin.pin));
+  }
+}
+
+// 全てのピンとPWM値の変化で、analogWrite() と同じ出力になる
+void testMatchesAnalogWrite() {
+  const uint8_t values[] = {0, 1, 100, 127, 128, 200, 254, 255};
+  uint32_t mismatches = 0;
+  for (uint8_t pin = 0; pin < 20; pin++) {
+    EXPECT_EQ(FastPwm::pinTimer(pin), digitalPinToTimer(pin));
+    for (uint8_t from : values) {
+      for (uint8_t to : values) {
+        sim::reset();
+        analogWrite(pin, from);
+        analogWrite(pin, to);
+        Registers expected = Registers::read();
+
+        sim::reset();
+        FastPwm pwm(pin);
+        pwm.write(from);
+        pwm.write(to);
+        mismatches += Registers::read().changed(expected) == 0 ? 0 : 1;
+      }
+    }
+  }
+  EXPECT_EQ(mismatches, 0u);
+}
+
+// 周波数の設定は、ピンのタイマーのクロック選択ビットだけを書き換える
+void testFrequencyRegisters() {
+  sim::reset();
+  TCCR1B = 0x18; // WGMビットは残す
+  Registers before = Registers::read();
+  EXPECT_TRUE(StaticPwm<9>::setFrequency(PwmFrequency::HZ_31372));
+  Registers after = Registers::read();
+  EXPECT_EQ(after.changed(before), 1UL << REG_TCCR1B);
+  EXPECT_EQ(TCCR1B, 0x19);
+  EXPECT_TRUE(FastPwm(10).setFrequency(PwmFrequency::HZ_31));
+  EXPECT_EQ(TCCR1B, 0x1D);
+
+  before = Registers::read();
+  EXPECT_TRUE(StaticPwm<11>::setFrequency(PwmFrequency::HZ_3922));
+  after = Registers::read();
+  EXPECT_EQ(after.changed(before), 1UL << REG_TCCR2B);
+  EXPECT_EQ(TCCR2B, 2);
+
+  // Timer0 とタイマーのないピンは変更しない
+  before = Registers::read();
+  EXPECT_TRUE(!StaticPwm<5>::setFrequency(PwmFrequency::HZ_31372));
+  EXPECT_TRUE(!StaticPwm<4>::setFrequency(PwmFrequency::HZ_31372));
+  EXPECT_EQ(Registers::read().changed(before), 0u);
+
+  // MsTimer2 が Timer2 を使用している場合は変更しない
+  TIMSK2 = _BV(TOIE2);
+  before = Registers::read();
+  EXPECT_TRUE(!StaticPwm<3>::setFrequency(PwmFrequency::HZ_31372));
+  EXPECT_EQ(Registers::read().changed(before), 0u);
+}
+
+// ピン番号をコンパイル時に指定するモータードライバも StaticPwm で書き込む
+void testStaticDrivers() {
+  sim::reset();
+  StaticBD62193<2, 4, 10> bd;
+  Registers before = Registers::read();
+  bd.setPwm(-150);
+  Registers after = Registers::read();
+  EXPECT_EQ(after.changed(before), (1UL << REG_OCR1B) |
+                                       (1UL << REG_TCCR1A) |
+                                       (1UL << REG_PORTD));
+  EXPECT_EQ(OCR1B, 150);
+  EXPECT_EQ(TCCR1A, _BV(COM1B1));
+  EXPECT_EQ(PORTD, _BV(4));
+  EXPECT_TRUE(bd.setPwmFrequency(PwmFrequency::HZ_31372));
+  EXPECT_EQ(TCCR1B & 0x07, 1);
+
+  sim::reset();
+  StaticTB67H450<9, 3> tb;
+  tb.setPwm(60);
+  EXPECT_EQ(OCR1A, 60);
+  EXPECT_EQ(TCCR1A, _BV(COM1A1));
+  EXPECT_EQ(TCCR2A, 0);
+  tb.setPwm(-255);
+  EXPECT_EQ(TCCR1A, 0);
+  EXPECT_EQ(sim::pinOutput(9), sim::LOW_LEVEL);
+  EXPECT_EQ(sim::pinOutput(3), sim::HIGH_LEVEL);
+  // 両方のタイマーを設定し、両方とも設定できた場合だけ true
+  EXPECT_TRUE(tb.setPwmFrequency(PwmFrequency::HZ_3922));
+  EXPECT_EQ(TCCR1B & 0x07, 2);
+  EXPECT_EQ(TCCR2B & 0x07, 2);
+  StaticTB67H450<9, 5> tbTimer0;
+  EXPECT_TRUE(!tbTimer0.setPwmFrequency(PwmFrequency::HZ_490));
+  EXPECT_EQ(TCCR1B & 0x07, 3);
+}
+
+// StaticPwm と、それだけを使うモータードライバはRAMを使用しない
+static_assert(sizeof(StaticBD62193<2, 4, 3>) == 1, "");
+static_assert(sizeof(StaticTB67H450<9, 10>) == 1, "");
+
+} // namespace
+
+int main() {
+  testWriteRegisters();
+  testMatchesAnalogWrite();
+  testFrequencyRegisters();
+  testStaticDrivers();
+  return testResult();
+}
@@ -0,0 +1,184 @@
+// FastwareSerial と IM920SL::send() を組み合わせたテスト
+//
+// FastwareSerial.cpp を ATmega328P 向けにビルドし、UDR0 に書き込まれた
+// バイトを記録する模擬のUSARTで、IM920SL<FastwareSerial>::send() の送信フレームが
+// 以前の実装（print と println で送信する）と1バイトも違わないことを確認します。
+// USE_FASTWARE_SERIAL を定義したもの（割り込み駆動）と定義しないもの
+// （送信データレジスタを1バイトずつ待つ）の2つをビルドして実行します。
+#include "TestHelper.h"
+#include <fasts/FastwareSerial.h>
+#include <parts/IM920SL.h>
+#include <stdlib.h>
+#include <string>
+
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+extern "C" void USART_RX_vect();
+extern "C" void USART_UDRE_vect();
+#endif
+
+namespace {
+
+/// 送信データレジスタ空き割り込みの代わり（割り込みが有効な場合だけ呼び出す）
+void serviceUdre() {
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  if (UCSR0B & _BV(UDRIE0)) {
+    USART_UDRE_vect();
+  }
+#endif
+}
+
+/// 送信バッファに残っているデータを全て送信する
+void drain() {
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  while (UCSR0B & _BV(UDRIE0)) {
+    USART_UDRE_vect();
+  }
+#endif
+}
+
+/// 模擬のUSARTを初期状態に戻す（送信データレジスタは常に空いている）
+void resetUsart() {
+  sim::reset();
+  UDR0.numWritten = 0;
+  UCSR0A = _BV(UDRE0);
+  UCSR0B = 0;
+  FastSerial.begin(115200);
+  SREG.interruptHandler = serviceUdre;
+}
+
+std::string written() {
+  return std::string(reinterpret_cast<const char *>(UDR0.written),
+                     UDR0.numWritten);
+}
+
+/// 以前の send() の送信フレーム（比較用）
+template <typename T> std::string referenceFrame(const T &data) {
+  HardwareSerial serial;
+  serial.print("TXDA ");
+  char hex[sizeof(T) * 2 + 1];
+  Converter::toHex(reinterpret_cast<const uint8_t *>(&data), sizeof(T), hex);
+  hex[sizeof(T) * 2] = '\0';
+  serial.println(hex);
+  return std::string(serial.output, serial.outputSize);
+}
+
+template <size_t N> struct Blob {
+  uint8_t bytes[N];
+};
+
+template <size_t N> void checkFrame(ImSendMode mode, bool interruptsEnabled) {
+  for (int trial = 0; trial < 10; trial++) {
+    Blob<N> data;
+    for (size_t i = 0; i < N; i++) {
+      data.bytes[i] = static_cast<uint8_t>(rand());
+    }
+    resetUsart();
+    if (!interruptsEnabled) {
+      cli();
+    }
+    IM920SL<FastwareSerial> im(FastSerial);
+    im.send(data, mode);
+    drain();
+    EXPECT_TRUE(written() == referenceFrame(data));
+  }
+}
+
+// 4バイトと32バイト（送信バッファより大きい）のフレームを、両方の送信モードで送信する
+void testSendFrames() {
+  for (bool interruptsEnabled : {true, false}) {
+    checkFrame<4>(ImSendMode::WAIT_FOR_BUFFER_AVAILABLE, interruptsEnabled);
+    checkFrame<4>(ImSendMode::EXIT_WHEN_BUFFER_FULL, interruptsEnabled);
+    checkFrame<32>(ImSendMode::WAIT_FOR_BUFFER_AVAILABLE, interruptsEnabled);
+    checkFrame<32>(ImSendMode::EXIT_WHEN_BUFFER_FULL, interruptsEnabled);
+  }
+}
+
+// 初期化でボーレートと送受信を設定する
+void testBegin() {
+  resetUsart();
+  EXPECT_EQ(UBRR0, 16000000UL / 16 / 115200 - 1);
+  EXPECT_TRUE(UCSR0B & _BV(RXEN0));
+  EXPECT_TRUE(UCSR0B & _BV(TXEN0));
+  EXPECT_EQ(UCSR0C, _BV(UCSZ01) | _BV(UCSZ00));
+  EXPECT_TRUE(SREG & _BV(SREG_I));
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  EXPECT_TRUE(UCSR0B & _BV(RXCIE0));
+#else
+  EXPECT_TRUE(!(UCSR0B & _BV(RXCIE0)));
+#endif
+}
+
+// availableForWrite() は TX_BUFFER_CAPACITY を超えない
+void testAvailableForWrite() {
+  resetUsart();
+  EXPECT_EQ(FastSerial.availableForWrite(), FastwareSerial::TX_BUFFER_CAPACITY);
+  EXPECT_EQ(TxBufferCapacity<FastwareSerial>::value,
+            FastwareSerial::TX_BUFFER_CAPACITY);
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  EXPECT_EQ(FastwareSerial::TX_BUFFER_CAPACITY,
+            FASTWARE_SERIAL_TX_BUFFER_SIZE - 1);
+  // 割り込みが発生しない間は、送信バッファに格納したまま待機せずに戻る
+  SREG.interruptHandler = nullptr;
+  const uint8_t bytes[10] = {0};
+  EXPECT_EQ(FastSerial.write(bytes, sizeof(bytes)), sizeof(bytes));
+  EXPECT_EQ(UDR0.numWritten, 0);
+  EXPECT_EQ(FastSerial.availableForWrite(),
+            FastwareSerial::TX_BUFFER_CAPACITY - 10);
+  drain();
+  EXPECT_EQ(UDR0.numWritten, 10);
+#else
+  EXPECT_EQ(FastwareSerial::TX_BUFFER_CAPACITY, 1);
+  // 送信データレジスタが空いていない場合は 0
+  UCSR0A = 0;
+  EXPECT_EQ(FastSerial.availableForWrite(), 0);
+#endif
+  // 待機しないモードでは、空きが足りない場合は送信しない
+  UCSR0A = 0;
+  UDR0.numWritten = 0;
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  FastSerial.write(bytes, sizeof(bytes) - 1);
+  // 空きは54バイトなので、32バイトのデータ（上限の63バイトを待つ）は送信しない
+  IM920SL<FastwareSerial> im(FastSerial);
+  im.send(Blob<32>(), ImSendMode::EXIT_WHEN_BUFFER_FULL);
+  UCSR0A = _BV(UDRE0);
+  drain();
+  EXPECT_EQ(UDR0.numWritten, 9);
+#else
+  IM920SL<FastwareSerial> im(FastSerial);
+  im.send(Blob<4>(), ImSendMode::EXIT_WHEN_BUFFER_FULL);
+  EXPECT_EQ(UDR0.numWritten, 0);
+#endif
+}
+
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+// 受信割り込みで受信バッファに格納したデータを読み出す
+void testReceive() {
+  resetUsart();
+  const char *text = "00,0001,DA:12\r\n";
+  for (const char *p = text; *p; p++) {
+    UDR0.received = *p;
+    USART_RX_vect();
+  }
+  EXPECT_EQ(FastSerial.available(), strlen(text));
+  IM920SL<FastwareSerial> im(FastSerial);
+  uint8_t data = 0;
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::FRAME_READY);
+  EXPECT_EQ(data, 0x12);
+  // 残りの改行（\n）は次の呼び出しで読み捨てる
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::NEED_MORE);
+  EXPECT_EQ(FastSerial.available(), 0);
+}
+#endif
+
+} // namespace
+
+int main() {
+  srand(5);
+  testBegin();
+  testSendFrames();
+  testAvailableForWrite();
+#if defined(FASTWARE_SERIAL_USE_INTERRUPT)
+  testReceive();
+#endif
+  return testResult();
+}
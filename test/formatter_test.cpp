@@ -0,0 +1,133 @@
+// Formatter のテスト
+//
+// 整形した文字列と文字数が snprintf と同じになることを、整数の最小値と最大値
+// （64ビットの long を含む）、幅とゼロ埋め、%c %s %% で確認します。
+// フラッシュメモリ上のフォーマット文字列と、バッファに収まらない場合も確認します。
+// 1回あたりの処理時間を vsnprintf と比べて表示します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <chrono>
+#include <fasts/Formatter.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+/// Formatter と vsnprintf で整形した結果を比べる
+void checkFormat(const char *format, ...) {
+  char actual[64];
+  char expected[64];
+  va_list args;
+  va_start(args, format);
+  va_list copy;
+  va_copy(copy, args);
+  size_t length = Formatter::vformat(actual, sizeof(actual), format, args);
+  int expectedLength = vsnprintf(expected, sizeof(expected), format, copy);
+  va_end(copy);
+  va_end(args);
+  if (strcmp(actual, expected) != 0) {
+    printf("%s: \"%s\" != \"%s\"\n", format, actual, expected);
+  }
+  EXPECT_TRUE(strcmp(actual, expected) == 0);
+  EXPECT_EQ(length, static_cast<size_t>(expectedLength));
+}
+
+void testIntegers() {
+  checkFormat("Available data: %d", 42);
+  checkFormat("%d %i %u", -1, INT_MIN, UINT_MAX);
+  checkFormat("%d %u %x %X", INT_MAX, 0u, 0xBEEFu, 0xbeefu);
+  checkFormat("%hhu %hd", 200, -3);
+}
+
+// long の最小値と最大値（PC上では20桁）も正しく変換する
+void testLongLimits() {
+  checkFormat("%ld %ld", LONG_MIN, LONG_MAX);
+  checkFormat("%lu %lx %lX", ULONG_MAX, ULONG_MAX, ULONG_MAX);
+  checkFormat("%ld|%lu|%lx", 0L, 123456789UL, 0xDEADBEEFUL);
+  checkFormat("%025ld|%25lu", LONG_MIN, ULONG_MAX);
+}
+
+void testWidth() {
+  checkFormat("%02X:%04x", 0xA, 0x1F);
+  checkFormat("%5d|%05d|%3u|%1d", -42, -42, 7u, 12345);
+  checkFormat("%08lX", 0xABCUL);
+}
+
+void testCharactersAndStrings() {
+  checkFormat("%c%s%%%s", 'x', "abc", "");
+  checkFormat("no conversion");
+}
+
+// フラッシュメモリ上のフォーマット文字列も同じ結果になる
+void testFlashFormat() {
+  char ram[64];
+  char flash[64];
+  size_t ramLength = Formatter::format(ram, sizeof(ram), "%s=%ld (%04X)",
+                                       "id", LONG_MIN, 0x2Au);
+  size_t flashLength = Formatter::format(flash, sizeof(flash),
+                                         F("%s=%ld (%04X)"), "id", LONG_MIN,
+                                         0x2Au);
+  EXPECT_TRUE(strcmp(ram, flash) == 0);
+  EXPECT_EQ(ramLength, flashLength);
+}
+
+// バッファに収まらない分は切り詰める
+void testTruncation() {
+  char buffer[8];
+  EXPECT_EQ(Formatter::format(buffer, sizeof(buffer), "%s", "0123456789"), 7u);
+  EXPECT_TRUE(strcmp(buffer, "0123456") == 0);
+  EXPECT_EQ(Formatter::format(buffer, sizeof(buffer), "%lu", ULONG_MAX), 7u);
+  EXPECT_EQ(Formatter::format(buffer, 0, "%d", 1), 0u);
+}
+
+/// vsnprintf を呼び出す（Formatter と同じく va_list を経由する）
+size_t callVsnprintf(char *buffer, size_t size, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, size, format, args);
+  va_end(args);
+  return static_cast<size_t>(length);
+}
+
+/// 1回あたりの処理時間（ナノ秒）を測る
+template <typename Function> double measure(Function function) {
+  const int calls = 200000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < calls; i++) {
+    function(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         calls;
+}
+
+// vsnprintf との処理時間の比較（結果は表示するだけで、チェックはしない）
+void benchmark() {
+  char buffer[64];
+  volatile size_t sink = 0;
+  double formatterTime = measure([&](int i) {
+    sink = sink + Formatter::format(buffer, sizeof(buffer),
+                                    "Available data: %d, id=%04X", i,
+                                    i & 0xFFFF);
+  });
+  double vsnprintfTime = measure([&](int i) {
+    sink = sink + callVsnprintf(buffer, sizeof(buffer),
+                                "Available data: %d, id=%04X", i, i & 0xFFFF);
+  });
+  printf("1回あたりの処理時間: Formatter %.1f ns、vsnprintf %.1f ns\n",
+         formatterTime, vsnprintfTime);
+}
+
+} // namespace
+
+int main() {
+  testIntegers();
+  testLongLimits();
+  testWidth();
+  testCharactersAndStrings();
+  testFlashFormat();
+  testTruncation();
+  benchmark();
+  return testResult();
+}
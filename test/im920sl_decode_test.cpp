@@ -0,0 +1,125 @@
+// IM920SL::receive() のデータの変換のテスト
+//
+// 受信しながらその場で変換する実装が、以前の実装（コロン以降を256バイトの
+// バッファに読み込んでから Converter::fromHex で変換する）と同じ結果になることを、
+// 1～32バイトの全てのサイズで確認します。
+#include "TestHelper.h"
+#include <parts/IM920SL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+namespace {
+
+/// 届いたデータを読み出すシリアルポート
+class FakeSerial {
+public:
+  explicit FakeSerial(const std::string &data) : data(data) {}
+  void begin(unsigned long) {}
+  int available() { return static_cast<int>(data.size() - position); }
+  int read() {
+    return position < data.size() ? static_cast<uint8_t>(data[position++])
+                                   : -1;
+  }
+  int availableForWrite() { return 63; }
+  size_t write(uint8_t) { return 1; }
+
+  /// 読み出したバイト数
+  size_t consumed() const { return position; }
+
+private:
+  std::string data;
+  size_t position = 0;
+};
+
+/**
+ * @brief 以前の receive() の変換処理（比較用）
+ *
+ * コロン以降を改行までバッファに読み込み、2文字ずつ16進数から変換します。
+ */
+void referenceReceive(FakeSerial &serial, uint8_t *data, size_t size) {
+  while (serial.available()) {
+    if (serial.read() == ':') {
+      break;
+    }
+  }
+  static char afterColon[256];
+  for (size_t index = 0; index < sizeof(afterColon); index++) {
+    while (!serial.available())
+      ;
+    char c = serial.read();
+    if (c == '\r') {
+      while (!serial.available())
+        ;
+      serial.read();
+      afterColon[index] = '\0';
+      break;
+    }
+    afterColon[index] = c;
+  }
+  char *pos = afterColon;
+  for (size_t i = 0; i < size; i++) {
+    Converter::fromHex(pos, 2, data + i);
+    pos += 2;
+    if (*pos == ',') {
+      pos++;
+    }
+  }
+}
+
+template <size_t N> struct Blob {
+  uint8_t bytes[N];
+};
+
+/// ランダムなデータの受信フレームを作る
+template <size_t N>
+std::string makeFrame(const Blob<N> &source, bool separated) {
+  std::string frame = "OK\r\n00,0001,C4:";
+  for (size_t i = 0; i < N; i++) {
+    char hex[3];
+    snprintf(hex, sizeof(hex), "%02X", source.bytes[i]);
+    frame += hex;
+    if (separated && i + 1 < N) {
+      frame += ',';
+    }
+  }
+  return frame + "\r\n00,0002,C4:";
+}
+
+template <size_t N> void checkSize() {
+  for (int trial = 0; trial < 50; trial++) {
+    Blob<N> source;
+    for (size_t i = 0; i < N; i++) {
+      source.bytes[i] = static_cast<uint8_t>(rand());
+    }
+    for (bool separated : {true, false}) {
+      std::string frame = makeFrame(source, separated);
+      FakeSerial current(frame);
+      FakeSerial reference(frame);
+      Blob<N> actual;
+      Blob<N> expected;
+      memset(&actual, 0, sizeof(actual));
+      memset(&expected, 0, sizeof(expected));
+
+      IM920SL<FakeSerial> im(current);
+      im.receive(&actual, ImReceiveMode::NO_WAIT_FOR_SERIAL_DATA);
+      referenceReceive(reference, expected.bytes, N);
+
+      EXPECT_TRUE(memcmp(&actual, &expected, N) == 0);
+      EXPECT_TRUE(memcmp(&actual, &source, N) == 0);
+      // 次のフレームの直前（\nの後ろ）まで読み込む
+      EXPECT_EQ(current.consumed(), reference.consumed());
+    }
+  }
+  checkSize<N - 1>();
+}
+
+template <> void checkSize<0>() {}
+
+} // namespace
+
+int main() {
+  srand(2);
+  checkSize<32>();
+  return testResult();
+}
@@ -0,0 +1,261 @@
+// IM920SL::poll() と IM920SL::receive() の受信のテスト
+//
+// 受信したフレームを1バイトずつ、ランダムな長さずつ、フレームごとに
+// シリアルバッファへ届けても、同じ結果になることを確認します。
+#include "TestHelper.h"
+#include <parts/IM920SL.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// 届いたデータだけを読み出せるシリアルポート
+class FakeSerial {
+public:
+  void begin(unsigned long) {}
+  int available() { return static_cast<int>(arrived.size() - position); }
+  int read() {
+    return position < arrived.size()
+               ? static_cast<uint8_t>(arrived[position++])
+               : -1;
+  }
+  int availableForWrite() { return 63; }
+  size_t write(uint8_t) { return 1; }
+
+  /// データをシリアルバッファに届ける
+  void deliver(const std::string &data) { arrived += data; }
+
+private:
+  std::string arrived;
+  size_t position = 0;
+};
+
+struct Payload {
+  uint8_t bytes[3];
+};
+
+/// 受信データの後ろに、書き込まれてはいけない領域を置いたもの
+struct Guarded {
+  Payload data;
+  uint8_t guard;
+};
+
+/// poll() の結果と、その時点の受信データ
+struct Received {
+  ImPollResult result;
+  Payload data;
+  uint8_t guard;
+};
+
+// 受信するフレーム（モジュールからの応答や不正なフレームを含む）
+const char *const frames[] = {
+    "OK\r\n",                     // コマンドの応答（コロンがないため読み捨てる）
+    "00,0001,DA:12,34,56\r\n",    // 正しいフレーム
+    "NG\r\n",                     // エラーの応答（読み捨てる）
+    "00,0002,C8:AB,CD,EF,01\r\n", // データが長すぎる
+    "00,0003,C0:01,02\r\n",       // データが短すぎる
+    "00,0004,B0:0G,02,03\r\n",    // 16進数以外の文字
+    "00,0005,A0:\r\n",            // データがない
+    "00,0006,D0:FE,DC,BA\r\n",    // 正しいフレーム
+};
+
+int colonCount = 0;
+void onColon() { colonCount++; }
+
+/// 分割したデータを順に届けながら poll() を呼び出し、結果を記録する
+std::vector<Received> pollAll(const std::vector<std::string> &chunks) {
+  FakeSerial serial;
+  IM920SL<FakeSerial> im(serial);
+  im.onDataReceived(onColon);
+  std::vector<Received> results;
+  Guarded buffer;
+  memset(&buffer, 0xEE, sizeof(buffer));
+  for (const std::string &chunk : chunks) {
+    serial.deliver(chunk);
+    while (true) {
+      ImPollResult result = im.poll(&buffer.data);
+      if (result == ImPollResult::NEED_MORE) {
+        // NEED_MORE はバッファを全て読み込んだ場合だけ返る
+        EXPECT_EQ(serial.available(), 0);
+        break;
+      }
+      results.push_back({result, buffer.data, buffer.guard});
+    }
+  }
+  return results;
+}
+
+std::string allFrames() {
+  std::string stream;
+  for (const char *frame : frames) {
+    stream += frame;
+  }
+  return stream;
+}
+
+void checkResults(const std::vector<Received> &results) {
+  // 読み捨てる応答を除いた6フレームの結果
+  EXPECT_EQ(results.size(), 6u);
+  if (results.size() != 6) {
+    return;
+  }
+  EXPECT_TRUE(results[0].result == ImPollResult::FRAME_READY);
+  EXPECT_EQ(results[0].data.bytes[0], 0x12);
+  EXPECT_EQ(results[0].data.bytes[1], 0x34);
+  EXPECT_EQ(results[0].data.bytes[2], 0x56);
+
+  // 長すぎる場合は、4バイト目を受信した時点で改行まで読み捨てる
+  // （データの後ろには書き込まない）
+  EXPECT_TRUE(results[1].result == ImPollResult::ERROR);
+  EXPECT_EQ(results[1].data.bytes[2], 0xEF);
+  for (const Received &received : results) {
+    EXPECT_EQ(received.guard, 0xEE);
+  }
+
+  EXPECT_TRUE(results[2].result == ImPollResult::ERROR);
+
+  // 16進数以外の文字以降のデータは書き込まない
+  EXPECT_TRUE(results[3].result == ImPollResult::ERROR);
+  EXPECT_EQ(results[3].data.bytes[1], 0x02);
+
+  EXPECT_TRUE(results[4].result == ImPollResult::ERROR);
+
+  // 不正なフレームの後も、次のコロンから受信できる
+  EXPECT_TRUE(results[5].result == ImPollResult::FRAME_READY);
+  EXPECT_EQ(results[5].data.bytes[0], 0xFE);
+  EXPECT_EQ(results[5].data.bytes[1], 0xDC);
+  EXPECT_EQ(results[5].data.bytes[2], 0xBA);
+}
+
+// 1バイトずつ届く場合
+void testByteByByte() {
+  std::vector<std::string> chunks;
+  for (char c : allFrames()) {
+    chunks.push_back(std::string(1, c));
+  }
+  colonCount = 0;
+  checkResults(pollAll(chunks));
+  EXPECT_EQ(colonCount, 6);
+}
+
+// ランダムな長さずつ届く場合（フレームの途中で区切られる）
+void testRandomChunks() {
+  srand(1);
+  for (int trial = 0; trial < 100; trial++) {
+    std::string stream = allFrames();
+    std::vector<std::string> chunks;
+    size_t position = 0;
+    while (position < stream.size()) {
+      size_t length = 1 + rand() % 16;
+      chunks.push_back(stream.substr(position, length));
+      position += length;
+    }
+    colonCount = 0;
+    checkResults(pollAll(chunks));
+    EXPECT_EQ(colonCount, 6);
+  }
+}
+
+// フレームごとに届く場合と、全てのフレームが一度に届く場合
+void testWholeFrames() {
+  std::vector<std::string> chunks;
+  for (const char *frame : frames) {
+    chunks.push_back(frame);
+  }
+  checkResults(pollAll(chunks));
+  checkResults(pollAll({allFrames()}));
+}
+
+// コロン（:）を探している間は、データを書き換えない
+void testSeekColon() {
+  FakeSerial serial;
+  IM920SL<FakeSerial> im(serial);
+  Payload data;
+  memset(&data, 0xEE, sizeof(data));
+  serial.deliver("OK\r\n12,34,56\r\n00,0001,DA");
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::NEED_MORE);
+  EXPECT_EQ(data.bytes[0], 0xEE);
+  EXPECT_EQ(data.bytes[1], 0xEE);
+  EXPECT_EQ(data.bytes[2], 0xEE);
+}
+
+// データを受信している間は、次の呼び出しで続きから読み込む
+void testPayloadResumes() {
+  FakeSerial serial;
+  IM920SL<FakeSerial> im(serial);
+  Payload data;
+  serial.deliver("00,0001,DA:12,3");
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::NEED_MORE);
+  EXPECT_EQ(data.bytes[0], 0x12);
+  serial.deliver("4,56");
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::NEED_MORE);
+  serial.deliver("\r\n");
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::FRAME_READY);
+  EXPECT_EQ(data.bytes[1], 0x34);
+  EXPECT_EQ(data.bytes[2], 0x56);
+}
+
+// 不正なデータの後は、改行まで読み捨ててからエラーを返す
+void testInvalidPayload() {
+  FakeSerial serial;
+  IM920SL<FakeSerial> im(serial);
+  Payload data;
+  memset(&data, 0xEE, sizeof(data));
+  serial.deliver("00,0001,DA:1X,34");
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::NEED_MORE);
+  EXPECT_EQ(data.bytes[1], 0xEE);
+  // 読み捨てている間のコロンは、フレームの始まりとして扱わない
+  serial.deliver(",:56,78,9A");
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::NEED_MORE);
+  EXPECT_EQ(data.bytes[1], 0xEE);
+  serial.deliver("\r\n");
+  EXPECT_TRUE(im.poll(&data) == ImPollResult::ERROR);
+}
+
+// nullptr の場合は読み捨てる
+void testNullData() {
+  FakeSerial serial;
+  IM920SL<FakeSerial> im(serial);
+  serial.deliver("00,0001,DA:12,34,56\r\n");
+  EXPECT_TRUE(im.poll<Payload>(nullptr) == ImPollResult::FRAME_READY);
+}
+
+// receive() も poll() と同じ規則で受信する
+void testReceive() {
+  FakeSerial serial;
+  IM920SL<FakeSerial> im(serial);
+  Payload data;
+  serial.deliver("OK\r\n00,0001,DA:12,34,56\r\n");
+  im.receive(&data, ImReceiveMode::NO_WAIT_FOR_SERIAL_DATA);
+  EXPECT_EQ(data.bytes[0], 0x12);
+  EXPECT_EQ(data.bytes[1], 0x34);
+  EXPECT_EQ(data.bytes[2], 0x56);
+  EXPECT_EQ(serial.available(), 0);
+
+  // データがない場合は待たずに戻る
+  im.receive(&data, ImReceiveMode::NO_WAIT_FOR_SERIAL_DATA);
+
+  // 不正なフレームの後の改行（\n）も読み捨てる
+  serial.deliver("00,0002,DA:12,34\r\n00,0003,DA:AB,CD,EF\r\n");
+  im.receive(&data, ImReceiveMode::WAIT_FOR_SERIAL_DATA);
+  im.receive(&data, ImReceiveMode::WAIT_FOR_SERIAL_DATA);
+  EXPECT_EQ(data.bytes[0], 0xAB);
+  EXPECT_EQ(data.bytes[1], 0xCD);
+  EXPECT_EQ(data.bytes[2], 0xEF);
+  EXPECT_EQ(serial.available(), 0);
+}
+
+} // namespace
+
+int main() {
+  testByteByByte();
+  testRandomChunks();
+  testWholeFrames();
+  testSeekColon();
+  testPayloadResumes();
+  testInvalidPayload();
+  testNullData();
+  testReceive();
+  return testResult();
+}
@@ -0,0 +1,210 @@
+// IM920SL::send() の送信フレームのテスト
+//
+// 送信フレームが以前の実装（16進数の文字列を作ってから print と println で
+// 送信する）と1バイトも違わないことを、一括書き込みできるシリアルポートと
+// 1文字ずつ書き込むシリアルポートの両方で確認します。
+// 1フレームあたりの書き込みの呼び出し回数と処理時間も表示します。
+#include "TestHelper.h"
+#include <chrono>
+#include <parts/IM920SL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+namespace {
+
+/// `Print` を継承したシリアルポート（HardwareSerial と同じく一括書き込みできる）
+class BulkSerial : public Print {
+public:
+  std::string output;
+  uint32_t writeCalls = 0;
+
+  using Print::write;
+  void begin(unsigned long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  int availableForWrite() { return 63; }
+  size_t write(uint8_t c) override {
+    writeCalls++;
+    output += static_cast<char>(c);
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    writeCalls++;
+    output.append(reinterpret_cast<const char *>(buffer), size);
+    return size;
+  }
+};
+
+/// 1文字ずつしか書き込めないシリアルポート
+class ByteSerial {
+public:
+  std::string output;
+
+  void begin(unsigned long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  int availableForWrite() { return 63; }
+  size_t write(uint8_t c) {
+    output += static_cast<char>(c);
+    return 1;
+  }
+};
+
+/// HardwareSerial と同じく、送信バッファ（63バイト）に入りきらない分は write() が待つ
+class DrainingSerial {
+public:
+  std::string output;
+  int queued = 0;
+
+  void begin(unsigned long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  // 呼び出されるたびに1バイトずつ送信が進む
+  int availableForWrite() {
+    if (queued > 0) {
+      queued--;
+    }
+    return 63 - queued;
+  }
+  size_t write(uint8_t c) {
+    while (queued >= 63) {
+      queued--;
+    }
+    queued++;
+    output += static_cast<char>(c);
+    return 1;
+  }
+};
+
+static_assert(HasBulkWrite<BulkSerial>::value, "");
+static_assert(!HasBulkWrite<ByteSerial>::value, "");
+
+/// 以前の send() の送信処理（比較用）
+template <typename T> void referenceSend(BulkSerial &serial, const T &data) {
+  serial.print("TXDA ");
+  char hex[sizeof(T) * 2 + 1];
+  Converter::toHex(reinterpret_cast<const uint8_t *>(&data), sizeof(T), hex);
+  hex[sizeof(T) * 2] = '\0';
+  serial.println(hex);
+}
+
+template <size_t N> struct Blob {
+  uint8_t bytes[N];
+};
+
+template <size_t N> void checkSize() {
+  for (int trial = 0; trial < 20; trial++) {
+    Blob<N> data;
+    for (size_t i = 0; i < N; i++) {
+      data.bytes[i] = static_cast<uint8_t>(rand());
+    }
+    BulkSerial expected;
+    referenceSend(expected, data);
+
+    BulkSerial bulk;
+    IM920SL<BulkSerial>(bulk).send(data, ImSendMode::EXIT_WHEN_BUFFER_FULL);
+    EXPECT_TRUE(bulk.output == expected.output);
+    // フレーム全体を1回で書き込む
+    EXPECT_EQ(bulk.writeCalls, 1u);
+
+    ByteSerial byte;
+    IM920SL<ByteSerial>(byte).send(data, ImSendMode::EXIT_WHEN_BUFFER_FULL);
+    EXPECT_TRUE(byte.output == expected.output);
+  }
+  checkSize<N - 1>();
+}
+
+template <> void checkSize<0>() {}
+
+// 送信バッファより大きいフレームも、待機せずに終了するモードで捨てずに送信する
+template <size_t N> void checkLargeFrame(ImSendMode mode) {
+  DrainingSerial serial;
+  Blob<N> data;
+  memset(&data, 0xA5, sizeof(data));
+  IM920SL<DrainingSerial>(serial).send(data, mode);
+  EXPECT_EQ(serial.output.size(), 5 + N * 2 + 2);
+  EXPECT_TRUE(serial.output.compare(0, 5, "TXDA ") == 0);
+  EXPECT_TRUE(serial.output.compare(serial.output.size() - 2, 2, "\r\n") == 0);
+}
+
+void testLargeFrames() {
+  checkLargeFrame<29>(ImSendMode::WAIT_FOR_BUFFER_AVAILABLE);
+  checkLargeFrame<29>(ImSendMode::EXIT_WHEN_BUFFER_FULL);
+  checkLargeFrame<32>(ImSendMode::WAIT_FOR_BUFFER_AVAILABLE);
+  checkLargeFrame<32>(ImSendMode::EXIT_WHEN_BUFFER_FULL);
+}
+
+// 送信バッファの空きが足りない場合は、待機せずに終了する
+void testExitWhenBufferFull() {
+  DrainingSerial serial;
+  serial.queued = 60;
+  uint16_t data = 0x1234;
+  IM920SL<DrainingSerial>(serial).send(data, ImSendMode::EXIT_WHEN_BUFFER_FULL);
+  EXPECT_TRUE(serial.output.empty());
+}
+
+// キャリアセンスを考慮する場合は、60ms待ってから送信する
+void testCarrierSense() {
+  sim::reset();
+  ByteSerial serial;
+  uint8_t data = 0x5A;
+  IM920SL<ByteSerial>(serial).send(data, ImSendMode::USE_CARRIER_SENSE);
+  EXPECT_EQ(millis(), 60u);
+  EXPECT_TRUE(serial.output == "TXDA 5A\r\n");
+}
+
+/// 1フレームあたりの処理時間（ナノ秒）を測る
+template <typename Function> double measure(Function send) {
+  const int frames = 200000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) {
+    send();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         frames;
+}
+
+// 以前の実装との処理時間の比較（結果は表示するだけで、チェックはしない）
+void benchmark() {
+  Blob<16> data;
+  memset(&data, 0x3C, sizeof(data));
+
+  BulkSerial reference;
+  double referenceTime = measure([&] {
+    reference.output.clear();
+    referenceSend(reference, data);
+  });
+  BulkSerial bulk;
+  IM920SL<BulkSerial> bulkIm(bulk);
+  double bulkTime = measure([&] {
+    bulk.output.clear();
+    bulkIm.send(data, ImSendMode::EXIT_WHEN_BUFFER_FULL);
+  });
+  ByteSerial byte;
+  IM920SL<ByteSerial> byteIm(byte);
+  double byteTime = measure([&] {
+    byte.output.clear();
+    byteIm.send(data, ImSendMode::EXIT_WHEN_BUFFER_FULL);
+  });
+
+  BulkSerial calls;
+  referenceSend(calls, data);
+  printf("16バイトのフレーム: 以前の実装 %.1f ns（write %u 回）、"
+         "一括書き込み %.1f ns（write 1 回）、1文字ずつ %.1f ns（write %u 回）\n",
+         referenceTime, static_cast<unsigned>(calls.writeCalls), bulkTime,
+         byteTime, static_cast<unsigned>(byte.output.size()));
+}
+
+} // namespace
+
+int main() {
+  srand(3);
+  checkSize<32>();
+  testLargeFrames();
+  testExitWhenBufferFull();
+  testCarrierSense();
+  benchmark();
+  return testResult();
+}
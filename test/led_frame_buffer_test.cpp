@@ -0,0 +1,169 @@
+// LedFrameBuffer のテスト
+//
+// 出力を記録する LedOutput を使い、変更がない場合は出力しないこと、
+// 出力する範囲が先頭から変更された最後のLEDまでになること、
+// リフレッシュレートの上限で出力を保留すること、出力の回数の数え方を確認します。
+#include "TestHelper.h"
+#include <parts/ledtapes/LedFrameBuffer.h>
+#include <parts/ledtapes/LedTapeEffects.h>
+#include <vector>
+
+namespace {
+
+/// 出力したLEDの数を記録する LedOutput
+class RecordingOutput : public LedOutput {
+public:
+  std::vector<uint16_t> shownLeds; ///< 出力ごとのLEDの数
+  CRGB last[30];                   ///< 最後に出力した色
+
+  void show(const CRGB *leds, uint16_t numLeds) override {
+    shownLeds.push_back(numLeds);
+    for (uint16_t i = 0; i < numLeds; i++) {
+      last[i] = leds[i];
+    }
+  }
+};
+
+const uint16_t NUM_LEDS = 30;
+
+// 最初は全てのLEDを出力し、変更がなければ出力しない
+void testNoChange() {
+  CRGB leds[NUM_LEDS];
+  RecordingOutput output;
+  LedFrameBuffer frameBuffer(leds, NUM_LEDS, &output);
+  EXPECT_TRUE(frameBuffer.isDirty());
+  EXPECT_TRUE(frameBuffer.show(0));
+  EXPECT_EQ(output.shownLeds.size(), 1u);
+  EXPECT_EQ(output.shownLeds[0], NUM_LEDS);
+
+  EXPECT_TRUE(!frameBuffer.isDirty());
+  EXPECT_TRUE(!frameBuffer.show(10));
+  EXPECT_TRUE(!frameBuffer.show(20, true));
+  EXPECT_EQ(output.shownLeds.size(), 1u);
+
+  // 同じ色を設定しても変更にならない
+  frameBuffer.fill(leds[0]);
+  frameBuffer.set(3, leds[3]);
+  EXPECT_TRUE(!frameBuffer.isDirty());
+  EXPECT_TRUE(!frameBuffer.show(30));
+  EXPECT_EQ(output.shownLeds.size(), 1u);
+}
+
+// 1つのLEDを変更した場合は、そのLEDまでを1回だけ出力する
+void testSinglePixel() {
+  CRGB leds[NUM_LEDS];
+  fill_solid(leds, NUM_LEDS, CRGB(CRGB::Black));
+  RecordingOutput output;
+  LedFrameBuffer frameBuffer(leds, NUM_LEDS, &output);
+  frameBuffer.show(0);
+
+  frameBuffer.set(5, CRGB::Red);
+  EXPECT_TRUE(frameBuffer.isDirty());
+  EXPECT_EQ(frameBuffer.dirtyBegin(), 5);
+  EXPECT_EQ(frameBuffer.dirtyEnd(), 5);
+  EXPECT_TRUE(frameBuffer.show(10));
+  EXPECT_EQ(output.shownLeds.size(), 2u);
+  EXPECT_EQ(output.shownLeds[1], 6);
+  EXPECT_TRUE(output.last[5] == CRGB(CRGB::Red));
+  EXPECT_TRUE(!frameBuffer.show(20));
+
+  // 離れた2つのLEDの変更は1つの範囲にまとめる
+  frameBuffer.set(20, CRGB::Blue);
+  frameBuffer.set(2, CRGB::Green);
+  EXPECT_EQ(frameBuffer.dirtyBegin(), 2);
+  EXPECT_EQ(frameBuffer.dirtyEnd(), 20);
+  frameBuffer.show(30);
+  EXPECT_EQ(output.shownLeds.size(), 3u);
+  EXPECT_EQ(output.shownLeds[2], 21);
+
+  // 範囲外の番号は無視する
+  frameBuffer.set(NUM_LEDS, CRGB::White);
+  EXPECT_TRUE(!frameBuffer.isDirty());
+}
+
+// リフレッシュレートの上限を超える出力は保留し、flush() で出力する
+void testMaxRefreshRate() {
+  CRGB leds[NUM_LEDS];
+  fill_solid(leds, NUM_LEDS, CRGB(CRGB::Black));
+  RecordingOutput output;
+  LedFrameBuffer frameBuffer(leds, NUM_LEDS, &output);
+  frameBuffer.setMaxRefreshRate(50); // 20msごと
+  EXPECT_TRUE(frameBuffer.show(100));
+
+  frameBuffer.set(0, CRGB::Red);
+  EXPECT_TRUE(!frameBuffer.show(110)); // 前回から10ms
+  EXPECT_TRUE(frameBuffer.isDirty());
+  EXPECT_TRUE(!frameBuffer.flush(119));
+  EXPECT_EQ(output.shownLeds.size(), 1u);
+  EXPECT_TRUE(frameBuffer.flush(120));
+  EXPECT_EQ(output.shownLeds.size(), 2u);
+  EXPECT_EQ(output.shownLeds[1], 1);
+
+  // force の場合は上限を無視する
+  frameBuffer.set(1, CRGB::Red);
+  EXPECT_TRUE(frameBuffer.show(121, true));
+  EXPECT_EQ(output.shownLeds.size(), 3u);
+
+  // 上限をなくすと、すぐに出力する
+  frameBuffer.setMaxRefreshRate(0);
+  frameBuffer.set(2, CRGB::Red);
+  EXPECT_TRUE(frameBuffer.show(122));
+}
+
+// 出力を要求された回数と、実際に出力した回数
+void testCounters() {
+  CRGB leds[NUM_LEDS];
+  RecordingOutput output;
+  LedFrameBuffer frameBuffer(leds, NUM_LEDS, &output);
+  frameBuffer.setMaxRefreshRate(50);
+
+  // 1msごとに描画するエフェクトを1000ms動かす
+  ChaseEffect chase(0x123456, 1);
+  for (unsigned long now = 0; now < 1000; now++) {
+    if (chase.update(leds, NUM_LEDS, now)) {
+      frameBuffer.markDirty();
+      frameBuffer.show(now);
+    } else {
+      frameBuffer.flush(now);
+    }
+  }
+  EXPECT_EQ(frameBuffer.requestedFrames(), 1000u);
+  EXPECT_EQ(frameBuffer.pushedFrames(), 50u);
+  EXPECT_EQ(output.shownLeds.size(), 50u);
+
+  // flush() は要求された回数に数えない
+  frameBuffer.set(0, CRGB::White);
+  frameBuffer.flush(2000);
+  EXPECT_EQ(frameBuffer.requestedFrames(), 1000u);
+  EXPECT_EQ(frameBuffer.pushedFrames(), 51u);
+
+  frameBuffer.resetCounters();
+  EXPECT_EQ(frameBuffer.requestedFrames(), 0u);
+  EXPECT_EQ(frameBuffer.pushedFrames(), 0u);
+}
+
+// 出力先がない場合も、変更は出力したものとして扱う
+void testNoOutput() {
+  CRGB leds[NUM_LEDS];
+  LedFrameBuffer frameBuffer(leds, NUM_LEDS, nullptr);
+  EXPECT_TRUE(frameBuffer.show(0));
+  EXPECT_TRUE(!frameBuffer.isDirty());
+
+  // 出力先を設定すると、次の show() で全てのLEDを出力する
+  RecordingOutput output;
+  frameBuffer.setOutput(&output);
+  EXPECT_TRUE(frameBuffer.show(1));
+  EXPECT_EQ(output.shownLeds.size(), 1u);
+  EXPECT_EQ(output.shownLeds[0], NUM_LEDS);
+}
+
+} // namespace
+
+int main() {
+  testNoChange();
+  testSinglePixel();
+  testMaxRefreshRate();
+  testCounters();
+  testNoOutput();
+  return testResult();
+}
@@ -0,0 +1,138 @@
+// LedGamma と FastLedOutput のガンマ補正のテスト
+//
+// コンパイル時に計算したテーブルが pow() で計算した値と一致することと、
+// FastLedOutput が呼び出し元の作業用のLED配列でチャンネルごとに補正し、
+// 作業用のLED配列がない場合は明るさだけを補正することを確認します。
+#include "TestHelper.h"
+#include <math.h>
+#include <parts/ledtapes/LedOutput.h>
+#include <type_traits>
+
+// テーブルはコンパイル時に計算される
+static_assert(LedGammaCurve::compute(28, 0) == 0, "");
+static_assert(LedGammaCurve::compute(28, 255) == 255, "");
+static_assert(LedGammaCurve::compute(28, 128) == 37, "");
+static_assert(std::has_virtual_destructor<LedOutput>::value, "");
+
+namespace {
+
+/// pow() で計算したガンマ補正の値
+uint8_t expected(double gamma, uint8_t value) {
+  return static_cast<uint8_t>(255.0 * pow(value / 255.0, gamma) + 0.5);
+}
+
+template <uint8_t gamma10> void checkTable() {
+  int mismatches = 0;
+  for (int value = 0; value < 256; value++) {
+    if (LedGamma<gamma10>::apply(static_cast<uint8_t>(value)) !=
+        expected(gamma10 / 10.0, static_cast<uint8_t>(value))) {
+      mismatches++;
+    }
+  }
+  EXPECT_EQ(mismatches, 0);
+}
+
+void testTables() {
+  checkTable<10>();
+  checkTable<22>();
+  checkTable<28>();
+  // 色はチャンネルごとに補正する
+  CRGB color = LedGamma<>::apply(CRGB(0x80FF00));
+  EXPECT_EQ(color.r, expected(2.8, 0x80));
+  EXPECT_EQ(color.g, 255);
+  EXPECT_EQ(color.b, 0);
+}
+
+const uint16_t NUM_LEDS = 4;
+
+// 作業用のLED配列がある場合は、補正した色を出力し、元のLED配列は変更しない
+void testGammaBuffer() {
+  CLEDController controller;
+  FastLedOutput output;
+  output.setController(&controller);
+  CRGB leds[NUM_LEDS] = {CRGB(0x000000), CRGB(0x404040), CRGB(0x80C0FF),
+                         CRGB(0x102030)};
+  CRGB gammaBuffer[NUM_LEDS];
+  output.setGammaBuffer(gammaBuffer, NUM_LEDS);
+  output.setGammaCorrection(true);
+  output.setBrightness(128);
+  output.show(leds, NUM_LEDS);
+
+  EXPECT_EQ(controller.shownLeds, NUM_LEDS);
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    EXPECT_TRUE(controller.shown[i] == LedGamma<>::apply(leds[i]));
+  }
+  EXPECT_TRUE(leds[2] == CRGB(0x80C0FF));
+  // 明るさも補正してからFastLEDに渡す
+  EXPECT_EQ(controller.shownBrightness, LedGamma<>::apply(128));
+}
+
+// 作業用のLED配列がない場合や足りない場合は、明るさだけを補正する
+void testBrightnessOnly() {
+  CLEDController controller;
+  FastLedOutput output;
+  output.setController(&controller);
+  CRGB leds[NUM_LEDS] = {CRGB(0x000000), CRGB(0x404040), CRGB(0x80C0FF),
+                         CRGB(0x102030)};
+  output.setGammaCorrection(true);
+  output.setBrightness(200);
+  output.show(leds, NUM_LEDS);
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    EXPECT_TRUE(controller.shown[i] == leds[i]);
+  }
+  EXPECT_EQ(controller.shownBrightness, LedGamma<>::apply(200));
+
+  CRGB smallBuffer[NUM_LEDS - 1];
+  output.setGammaBuffer(smallBuffer, NUM_LEDS - 1);
+  output.show(leds, NUM_LEDS);
+  EXPECT_TRUE(controller.shown[1] == leds[1]);
+  // 出力するLEDの数が作業用のLED配列に収まれば補正する
+  output.show(leds, NUM_LEDS - 1);
+  EXPECT_TRUE(controller.shown[1] == LedGamma<>::apply(leds[1]));
+
+  // nullptr を設定すると、明るさだけの補正に戻る
+  output.setGammaBuffer(nullptr, NUM_LEDS);
+  output.show(leds, NUM_LEDS);
+  EXPECT_TRUE(controller.shown[1] == leds[1]);
+}
+
+// ガンマ補正が無効な場合は、作業用のLED配列を使用しない
+void testGammaDisabled() {
+  CLEDController controller;
+  FastLedOutput output;
+  output.setController(&controller);
+  CRGB leds[NUM_LEDS] = {CRGB(0x000000), CRGB(0x404040), CRGB(0x80C0FF),
+                         CRGB(0x102030)};
+  CRGB gammaBuffer[NUM_LEDS];
+  fill_solid(gammaBuffer, NUM_LEDS, CRGB(CRGB::White));
+  output.setGammaBuffer(gammaBuffer, NUM_LEDS);
+  output.setBrightness(100);
+  output.show(leds, NUM_LEDS);
+  EXPECT_TRUE(controller.shown[2] == leds[2]);
+  EXPECT_TRUE(gammaBuffer[2] == CRGB(CRGB::White));
+  EXPECT_EQ(controller.shownBrightness, 100);
+}
+
+// LedOutput のポインタで派生クラスを破棄できる
+int destroyed = 0;
+class CountingOutput : public FastLedOutput {
+public:
+  ~CountingOutput() { destroyed++; }
+};
+
+void testVirtualDestructor() {
+  LedOutput *output = new CountingOutput();
+  delete output;
+  EXPECT_EQ(destroyed, 1);
+}
+
+} // namespace
+
+int main() {
+  testTables();
+  testGammaBuffer();
+  testBrightnessOnly();
+  testGammaDisabled();
+  testVirtualDestructor();
+  return testResult();
+}
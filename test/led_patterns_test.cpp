@@ -0,0 +1,106 @@
+// LedPatterns のテスト
+//
+// 1ステップの長さ（stepShift）が0〜12の全てで、パターンを上位ビットから
+// 1ステップずつ表示し、16ビットの時刻が一周しても位相がずれないことを、
+// 32ビットの時刻で計算した表示と比べて確認します。
+// 12より大きい値を12にすることと、tick() が同じポートの他のピンを
+// 変えずにLEDのピンだけを出力することも確認します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <parts/LedPatterns.h>
+
+namespace {
+
+const uint16_t PATTERNS[] = {LedPatterns::HEARTBEAT, LedPatterns::FAST_BLINK,
+                             LedPatterns::BLINK, 0x8001, 0x1234, 0xC0DE};
+
+/// 32ビットの時刻 t（ミリ秒）で表示するパターンのビット
+bool expectedLevel(uint16_t pattern, uint8_t stepShift, uint32_t t) {
+  uint32_t step = (t >> stepShift) % 16; // 何ステップ目か
+  return (pattern & (0x8000 >> step)) != 0;
+}
+
+// 16ビットの時刻の2周分、1ミリ秒ごとに比べる
+void testLevelAllShifts() {
+  for (uint8_t stepShift = 0; stepShift <= LedPatterns::MAX_STEP_SHIFT;
+       stepShift++) {
+    uint32_t mismatches = 0;
+    for (uint16_t pattern : PATTERNS) {
+      for (uint32_t t = 0; t < 2 * 65536UL; t++) {
+        bool level =
+            LedPatterns::level(pattern, stepShift, static_cast<uint16_t>(t));
+        mismatches += level == expectedLevel(pattern, stepShift, t) ? 0 : 1;
+      }
+    }
+    EXPECT_EQ(mismatches, 0u);
+  }
+
+  // 1ステップ目の最後と2ステップ目の最初
+  EXPECT_TRUE(LedPatterns::level(0x8000, 0, 0));
+  EXPECT_TRUE(!LedPatterns::level(0x8000, 0, 1));
+  EXPECT_TRUE(LedPatterns::level(0x8000, 12, 4095));
+  EXPECT_TRUE(!LedPatterns::level(0x8000, 12, 4096));
+  // 最後のステップの後、時刻の一周で最初のステップに戻る
+  EXPECT_TRUE(LedPatterns::level(0x0001, 12, 65535));
+  EXPECT_TRUE(LedPatterns::level(0x8000, 12, 0));
+}
+
+// 12より大きい値は12として扱う
+void testShiftClamp() {
+  sim::reset();
+  LedPatterns leds;
+  uint8_t a = leds.add(2, 0x8000, 13);
+  uint8_t b = leds.add(3, 0x8000, 0xFF);
+  uint8_t c = leds.add(4);
+  leds.setPattern(c, 0x8000, 200);
+  const uint16_t times[] = {0, 4095, 4096, 8191, 65535};
+  for (uint16_t now : times) {
+    leds.tick(now);
+    int expected =
+        LedPatterns::level(0x8000, 12, now) ? sim::HIGH_LEVEL : sim::LOW_LEVEL;
+    EXPECT_EQ(sim::pinOutput(2), expected);
+    EXPECT_EQ(sim::pinOutput(3), expected);
+    EXPECT_EQ(sim::pinOutput(4), expected);
+  }
+  EXPECT_EQ(a, 0);
+  EXPECT_EQ(b, 1);
+}
+
+// 別のポートのLEDを、ステップの長さを変えて出力する
+void testTickPorts() {
+  sim::reset();
+  PORTD = _BV(7); // LEDではないピン
+  LedPatterns leds;
+  const uint8_t pins[] = {2, 5, 8, 13, 14};
+  const uint8_t shifts[] = {0, 3, 6, 12, 9};
+  for (uint8_t i = 0; i < 5; i++) {
+    EXPECT_EQ(leds.add(pins[i], PATTERNS[i], shifts[i]), i);
+  }
+  EXPECT_EQ(DDRD, _BV(2) | _BV(5));
+
+  uint32_t mismatches = 0;
+  for (uint32_t t = 0; t < 70000; t += 3) {
+    uint16_t now = static_cast<uint16_t>(t);
+    leds.tick(now);
+    for (uint8_t i = 0; i < 5; i++) {
+      int expected = expectedLevel(PATTERNS[i], shifts[i], t) ? sim::HIGH_LEVEL
+                                                              : sim::LOW_LEVEL;
+      mismatches += sim::pinOutput(pins[i]) == expected ? 0 : 1;
+    }
+    mismatches += (PORTD & _BV(7)) != 0 ? 0 : 1;
+  }
+  EXPECT_EQ(mismatches, 0u);
+
+  // 登録していない番号は無視する
+  leds.setPattern(5, LedPatterns::ON, 0);
+  EXPECT_EQ(leds.size(), 5);
+}
+
+} // namespace
+
+int main() {
+  testLevelAllShifts();
+  testShiftClamp();
+  testTickPorts();
+  return testResult();
+}
@@ -0,0 +1,192 @@
+// LedTapeEffects と LedTape の待機する光り方のテスト
+//
+// 以前の実装（delay() で待ちながら LED配列を書き換えて FastLED.show() を呼び出す）
+// が出力したフレームの列を作り、エフェクトを update() で進めたフレームと、
+// StaticLedTape の待機する光り方が出力したフレームが同じになることを確認します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <parts/LedTape.h>
+#include <vector>
+
+namespace {
+
+const uint16_t NUM_LEDS = 30;
+
+typedef std::vector<CRGB> Frame;
+
+/// 以前の実装が FastLED.show() で出力したフレームと、出力した時刻
+struct Recorded {
+  std::vector<Frame> frames;
+  std::vector<unsigned long> times;
+
+  void show(const CRGB *leds, uint16_t numLeds) {
+    frames.push_back(Frame(leds, leds + numLeds));
+    times.push_back(millis());
+  }
+};
+
+// 以前の blinkColor()
+Recorded referenceBlink(uint32_t color, unsigned long delayTime) {
+  Recorded recorded;
+  CRGB leds[NUM_LEDS];
+  sim::reset();
+  fill_solid(leds, NUM_LEDS, CRGB(color));
+  recorded.show(leds, NUM_LEDS);
+  delay(delayTime);
+  fill_solid(leds, NUM_LEDS, CRGB(CRGB::Black));
+  recorded.show(leds, NUM_LEDS);
+  delay(delayTime);
+  return recorded;
+}
+
+// 以前の rainbow()
+// （以前はuint8_tのカウンターを256と比べていたため終わらなかった。1周で終える）
+Recorded referenceRainbow(unsigned long delayTime) {
+  Recorded recorded;
+  CRGB leds[NUM_LEDS];
+  sim::reset();
+  for (int j = 0; j < 256; j++) {
+    for (uint16_t i = 0; i < NUM_LEDS; i++) {
+      leds[i] = CHSV((i + j) % 256, 255, 255);
+    }
+    recorded.show(leds, NUM_LEDS);
+    delay(delayTime);
+  }
+  return recorded;
+}
+
+// 以前の chase()
+Recorded referenceChase(uint32_t color, unsigned long delayTime) {
+  Recorded recorded;
+  CRGB leds[NUM_LEDS];
+  fill_solid(leds, NUM_LEDS, CRGB(CRGB::Black));
+  sim::reset();
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    leds[i] = color;
+    recorded.show(leds, NUM_LEDS);
+    delay(delayTime);
+    leds[i] = CRGB::Black;
+  }
+  return recorded;
+}
+
+// 以前の gradient()
+// （以前は同じ色を繰り返し暗くしていたため、ほぼ全てが黒になっていた。
+// LEDごとにベースカラーを fadeToBlackBy() で暗くする、意図した結果と比べる。
+// (1.0f - i / numLeds) * 255 は、浮動小数点数の丸め誤差のない整数で計算する）
+Recorded referenceGradient(uint32_t baseColor, unsigned long delayTime) {
+  Recorded recorded;
+  CRGB leds[NUM_LEDS];
+  sim::reset();
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    uint8_t fade = 255 * (NUM_LEDS - i) / NUM_LEDS;
+    leds[i] = CRGB(baseColor);
+    leds[i].nscale8(255 - fade); // fadeToBlackBy(fade) と同じ
+  }
+  recorded.show(leds, NUM_LEDS);
+  delay(delayTime);
+  return recorded;
+}
+
+/// エフェクトを interval ごとに進め、描画したフレームを記録する
+std::vector<Frame> renderEffect(LedTapeEffect &effect, unsigned long interval,
+                                uint16_t frames) {
+  std::vector<Frame> rendered;
+  CRGB leds[NUM_LEDS];
+  fill_solid(leds, NUM_LEDS, CRGB(CRGB::Black));
+  for (uint16_t i = 0; i < frames; i++) {
+    unsigned long now = i * interval;
+    if (effect.update(leds, NUM_LEDS, now)) {
+      rendered.push_back(Frame(leds, leds + NUM_LEDS));
+    }
+    // 次のフレームの時刻までは描画しない
+    if (interval > 1) {
+      EXPECT_TRUE(!effect.update(leds, NUM_LEDS, now + interval - 1));
+    }
+  }
+  return rendered;
+}
+
+void testEffectFrames() {
+  BlinkEffect blink(0xFF0000, 500);
+  EXPECT_TRUE(renderEffect(blink, 500, 2) ==
+              referenceBlink(0xFF0000, 500).frames);
+
+  RainbowEffect rainbow(20);
+  EXPECT_TRUE(renderEffect(rainbow, 20, 256) == referenceRainbow(20).frames);
+
+  ChaseEffect chase(0x123456, 100);
+  EXPECT_TRUE(renderEffect(chase, 100, NUM_LEDS) ==
+              referenceChase(0x123456, 100).frames);
+
+  GradientEffect gradient(0x800080);
+  EXPECT_TRUE(renderEffect(gradient, 1000, 3) ==
+              referenceGradient(0x800080, 1000).frames);
+}
+
+/// StaticLedTape が出力したフレーム
+Recorded shown;
+void recordShown(const CLEDController &controller) {
+  shown.frames.push_back(
+      Frame(controller.shown, controller.shown + controller.shownLeds));
+  shown.times.push_back(millis());
+}
+
+/// 待機する光り方を実行し、出力したフレームと時刻が以前の実装と同じか確認する
+template <typename Function>
+void checkBlocking(const Recorded &expected, unsigned long delayTime,
+                   Function function) {
+  StaticLedTape<6, NUM_LEDS> ledTape;
+  CLEDController &controller = FastLED.addLeds<WS2812B, 6>(nullptr, 0);
+  controller.onShow = recordShown;
+  ledTape.solidColor(CRGB::Black);
+  sim::reset();
+  shown = Recorded();
+  function(ledTape);
+  controller.onShow = nullptr;
+  EXPECT_TRUE(shown.frames == expected.frames);
+  EXPECT_TRUE(shown.times == expected.times);
+  // 最後のフレームの後も同じ時間だけ待機する
+  EXPECT_EQ(millis(), expected.times.back() + delayTime);
+}
+
+void testBlockingFrames() {
+  checkBlocking(referenceBlink(0x00FF00, 300), 300,
+                [](LedTapeBase &tape) { tape.blinkColor(0x00FF00, 300); });
+  checkBlocking(referenceRainbow(20), 20,
+                [](LedTapeBase &tape) { tape.rainbow(20); });
+  checkBlocking(referenceChase(0xABCDEF, 50), 50,
+                [](LedTapeBase &tape) { tape.chase(0xABCDEF, 50); });
+  checkBlocking(referenceGradient(0x336699, 1000), 1000,
+                [](LedTapeBase &tape) { tape.gradient(0x336699, 1000); });
+}
+
+// 1度だけ描画するエフェクトは、フレームの番号が0に戻っても描画し直さない
+void testDrawOnce() {
+  CRGB leds[NUM_LEDS];
+  SolidColorEffect solid(0x00FF00);
+  GradientEffect gradient(0x0000FF);
+  EXPECT_TRUE(solid.update(leds, NUM_LEDS, 0));
+  EXPECT_TRUE(gradient.update(leds, NUM_LEDS, 0));
+  uint32_t redrawn = 0;
+  for (uint32_t i = 1; i <= 70000; i++) {
+    redrawn += solid.update(leds, NUM_LEDS, i) ? 1 : 0;
+    redrawn += gradient.update(leds, NUM_LEDS, i) ? 1 : 0;
+  }
+  EXPECT_EQ(redrawn, 0u);
+
+  // reset() の後は描画し直す
+  solid.reset();
+  gradient.reset();
+  EXPECT_TRUE(solid.update(leds, NUM_LEDS, 70001));
+  EXPECT_TRUE(gradient.update(leds, NUM_LEDS, 70001));
+}
+
+} // namespace
+
+int main() {
+  testEffectFrames();
+  testBlockingFrames();
+  testDrawOnce();
+  return testResult();
+}
@@ -0,0 +1,167 @@
+// RainbowEffect と GradientEffect の描画処理のテスト
+//
+// 前のフレームをずらして最後のLEDだけを色変換するレインボーが、毎フレーム全ての
+// LEDを色変換する以前の実装と同じになること、除算と浮動小数点数を使わない
+// グラデーションが 255 * i / numLeds の切り上げと同じになることを確認します。
+// 1フレームあたりの処理時間を以前の実装と比べて表示します。
+#include "TestHelper.h"
+#include <chrono>
+#include <parts/ledtapes/LedTapeEffects.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+const uint16_t MAX_LEDS = 1000;
+
+/// 2つのLED配列の、色のチャンネルごとの差の最大値
+int maxError(const CRGB *a, const CRGB *b, uint16_t numLeds) {
+  int error = 0;
+  for (uint16_t i = 0; i < numLeds; i++) {
+    for (uint8_t c = 0; c < 3; c++) {
+      int difference = abs(a[i].raw[c] - b[i].raw[c]);
+      if (difference > error) {
+        error = difference;
+      }
+    }
+  }
+  return error;
+}
+
+// 以前のレインボー（全てのLEDを色変換する）
+void referenceRainbow(CRGB *leds, uint16_t numLeds, uint16_t frame) {
+  for (uint16_t i = 0; i < numLeds; i++) {
+    leds[i] = CHSV((i + frame) % 256, 255, 255);
+  }
+}
+
+// 以前のグラデーション（浮動小数点数で明るさを求める）
+void referenceGradient(CRGB *leds, uint16_t numLeds, uint32_t baseColor) {
+  for (uint16_t i = 0; i < numLeds; i++) {
+    float factor = (float)i / numLeds;
+    uint8_t fade = (1.0f - factor) * 255;
+    leds[i] = CRGB(baseColor);
+    leds[i].nscale8(255 - fade); // fadeToBlackBy(fade) と同じ
+  }
+}
+
+// 明るさを 255 * i / numLeds の切り上げで求めたグラデーション
+void exactGradient(CRGB *leds, uint16_t numLeds, uint32_t baseColor) {
+  for (uint16_t i = 0; i < numLeds; i++) {
+    uint8_t scale = (255UL * i + numLeds - 1) / numLeds;
+    leds[i] = CRGB(baseColor);
+    leds[i].nscale8(scale);
+  }
+}
+
+// 色相が何周しても、全てのLEDを色変換した場合と同じになる
+void testRainbow() {
+  static CRGB expected[300];
+  static CRGB actual[300];
+  RainbowEffect rainbow(0);
+  int error = 0;
+  for (uint16_t frame = 0; frame < 600; frame++) {
+    referenceRainbow(expected, 300, frame);
+    EXPECT_TRUE(rainbow.update(actual, 300, frame));
+    int e = maxError(expected, actual, 300);
+    error = e > error ? e : error;
+  }
+  EXPECT_EQ(error, 0);
+}
+
+// LED配列かLEDの数が変わった場合と、reset() の後は全てのLEDを色変換し直す
+void testRainbowRedraw() {
+  static CRGB expected[300];
+  static CRGB first[300];
+  static CRGB second[300];
+  RainbowEffect rainbow(0);
+  for (uint16_t frame = 0; frame < 10; frame++) {
+    rainbow.update(first, 300, frame);
+  }
+  // 別の配列（前のフレームが描画されていない）
+  rainbow.update(second, 300, 10);
+  referenceRainbow(expected, 300, 10);
+  EXPECT_EQ(maxError(expected, second, 300), 0);
+  // LEDの数が変わった
+  rainbow.update(second, 100, 11);
+  referenceRainbow(expected, 100, 11);
+  EXPECT_EQ(maxError(expected, second, 100), 0);
+  // 他の処理がLED配列を書き換えた後に reset() を呼び出した
+  fill_solid(second, 100, CRGB(CRGB::White));
+  rainbow.reset();
+  rainbow.update(second, 100, 0);
+  referenceRainbow(expected, 100, 0);
+  EXPECT_EQ(maxError(expected, second, 100), 0);
+}
+
+// 切り上げた値とは一致し、以前の実装とは浮動小数点数の丸め誤差（1）しか違わない
+void testGradient() {
+  static CRGB expected[MAX_LEDS];
+  static CRGB reference[MAX_LEDS];
+  static CRGB actual[MAX_LEDS];
+  const uint32_t baseColors[] = {0x800080, 0xFFFFFF, 0x123456, 0xFF7F50};
+  const uint16_t lengths[] = {1, 2, 7, 30, 255, 256, 300, MAX_LEDS};
+  int referenceError = 0;
+  for (uint16_t numLeds : lengths) {
+    for (uint32_t baseColor : baseColors) {
+      GradientEffect gradient(baseColor);
+      EXPECT_TRUE(gradient.update(actual, numLeds, 0));
+      exactGradient(expected, numLeds, baseColor);
+      EXPECT_EQ(maxError(expected, actual, numLeds), 0);
+      referenceGradient(reference, numLeds, baseColor);
+      int e = maxError(reference, actual, numLeds);
+      referenceError = e > referenceError ? e : referenceError;
+    }
+  }
+  EXPECT_TRUE(referenceError <= 1);
+}
+
+/// 1フレームあたりの処理時間（マイクロ秒）を測る
+template <typename Function> double measure(Function function) {
+  const int frames = 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    function(frame);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         frames;
+}
+
+// 以前の実装との処理時間の比較（結果は表示するだけで、チェックはしない）
+void benchmark() {
+  static CRGB leds[300];
+  volatile uint8_t sink = 0;
+  double referenceRainbowTime = measure([&](int frame) {
+    referenceRainbow(leds, 300, frame);
+    sink = sink + leds[frame % 300].r;
+  });
+  RainbowEffect rainbow(0);
+  double rainbowTime = measure([&](int frame) {
+    rainbow.update(leds, 300, frame);
+    sink = sink + leds[frame % 300].r;
+  });
+  double referenceGradientTime = measure([&](int frame) {
+    referenceGradient(leds, 300, 0x800080 + frame);
+    sink = sink + leds[frame % 300].r;
+  });
+  double gradientTime = measure([&](int frame) {
+    GradientEffect gradient(0x800080 + frame);
+    gradient.update(leds, 300, 0);
+    sink = sink + leds[frame % 300].r;
+  });
+  printf("300個のLEDの1フレーム: レインボー 以前 %.2f us、現在 %.2f us、"
+         "グラデーション 以前 %.2f us、現在 %.2f us\n",
+         referenceRainbowTime, rainbowTime, referenceGradientTime,
+         gradientTime);
+}
+
+} // namespace
+
+int main() {
+  testRainbow();
+  testRainbowRedraw();
+  testGradient();
+  benchmark();
+  return testResult();
+}
@@ -0,0 +1,229 @@
+// LedTapePlayer のテスト
+//
+// scripts/encode_led_rle.py と同じ方法でランダムな光り方を符号化し、再生したフレームと
+// 表示時間が元のフレームと同じになることを確認します。
+// フレームの番号が0に戻る65536フレームを超えても、繰り返し再生は元のフレームの順序を
+// 保ち、繰り返さない再生は1度しか描画しないことを確認します。
+#include "TestHelper.h"
+#include <parts/ledtapes/LedTapePlayer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+typedef std::vector<CRGB> Frame;
+
+/// 符号化する前のフレーム
+struct Show {
+  std::vector<Frame> frames;
+  std::vector<uint16_t> durations;
+};
+
+const uint8_t MAX_COUNT = 128;
+
+void appendWord(std::vector<uint8_t> &out, uint16_t value) {
+  out.push_back(value & 0xFF);
+  out.push_back(value >> 8);
+}
+
+// encode_led_rle.py の encode_frame()
+void encodeFrame(std::vector<uint8_t> &out, const Frame &pixels,
+                 const Frame *previous) {
+  size_t position = 0;
+  while (position < pixels.size()) {
+    size_t count = 1;
+    if (previous && pixels[position] == (*previous)[position]) {
+      while (position + count < pixels.size() && count < MAX_COUNT &&
+             pixels[position + count] == (*previous)[position + count]) {
+        count++;
+      }
+      out.push_back(count - 1);
+    } else {
+      const CRGB &color = pixels[position];
+      while (position + count < pixels.size() && count < MAX_COUNT &&
+             pixels[position + count] == color) {
+        count++;
+      }
+      out.push_back(0x80 | (count - 1));
+      out.push_back(color.r);
+      out.push_back(color.g);
+      out.push_back(color.b);
+    }
+    position += count;
+  }
+}
+
+// encode_led_rle.py の encode()
+std::vector<uint8_t> encode(const Show &show) {
+  std::vector<uint8_t> out;
+  appendWord(out, show.frames[0].size());
+  appendWord(out, show.frames.size());
+  for (size_t i = 0; i < show.frames.size(); i++) {
+    appendWord(out, show.durations[i]);
+    encodeFrame(out, show.frames[i], i == 0 ? nullptr : &show.frames[i - 1]);
+  }
+  return out;
+}
+
+/// 前のフレームの一部を少ない色で塗り替えていく、ランダムな光り方
+Show randomShow(uint16_t numLeds, uint16_t numFrames) {
+  const uint32_t colors[] = {0x000000, 0xFF0000, 0x00FF00,
+                             0x0000FF, 0xFFFFFF, 0x123456};
+  Show show;
+  srand(1);
+  Frame pixels(numLeds, CRGB(0, 0, 0));
+  for (uint16_t i = 0; i < numFrames; i++) {
+    uint16_t begin = rand() % numLeds;
+    uint16_t end = begin + rand() % (numLeds - begin) + 1;
+    for (uint16_t led = begin; led < end; led++) {
+      if (rand() % 4 == 0) {
+        pixels[led] = CRGB(colors[rand() % 6]);
+      }
+    }
+    show.frames.push_back(pixels);
+    show.durations.push_back(1 + rand() % 50);
+  }
+  return show;
+}
+
+const uint16_t NUM_LEDS = 40;
+const uint16_t NUM_FRAMES = 60;
+
+// ヘッダーの記述例（3個のLED、2フレーム）が期待するバイト列になる
+void testFormat() {
+  Show show;
+  show.frames.push_back(
+      Frame{CRGB(0xFF0000), CRGB(0xFF0000), CRGB(0x000000)});
+  show.frames.push_back(
+      Frame{CRGB(0x000000), CRGB(0xFF0000), CRGB(0xFF0000)});
+  show.durations = {500, 500};
+  const std::vector<uint8_t> expected = {
+      0x03, 0x00, 0x02, 0x00,                         // LEDの数、フレームの数
+      0xF4, 0x01, 0x81, 0xFF, 0x00, 0x00, 0x80, 0x00, // 2個を赤、1個を黒
+      0x00, 0x00,                                     //
+      0xF4, 0x01, 0x80, 0x00, 0x00, 0x00, 0x00, 0x80, // 黒、そのまま、赤
+      0xFF, 0x00, 0x00,                               //
+  };
+  std::vector<uint8_t> data = encode(show);
+  EXPECT_TRUE(data == expected);
+
+  LedTapePlayer player(data.data(), false);
+  CRGB leds[3];
+  EXPECT_TRUE(player.update(leds, 3, 0));
+  EXPECT_TRUE(Frame(leds, leds + 3) == show.frames[0]);
+  EXPECT_TRUE(!player.update(leds, 3, 499));
+  EXPECT_TRUE(player.update(leds, 3, 500));
+  EXPECT_TRUE(Frame(leds, leds + 3) == show.frames[1]);
+  EXPECT_TRUE(player.finished());
+}
+
+/// 各フレームの表示時間だけ進めながら再生し、元のフレームと違うフレームの数を返す
+uint32_t play(LedTapePlayer &player, const Show &show, uint32_t frames,
+              uint32_t *rendered) {
+  static CRGB leds[NUM_LEDS];
+  uint32_t mismatches = 0;
+  unsigned long now = 0;
+  *rendered = 0;
+  for (uint32_t i = 0; i < frames; i++) {
+    uint32_t index = i % show.frames.size();
+    if (!player.update(leds, NUM_LEDS, now)) {
+      now += show.durations[index];
+      continue;
+    }
+    (*rendered)++;
+    if (Frame(leds, leds + NUM_LEDS) != show.frames[index]) {
+      mismatches++;
+    }
+    // 表示時間が経つまでは次のフレームを描画しない
+    if (player.update(leds, NUM_LEDS, now + show.durations[index] - 1)) {
+      mismatches++;
+    }
+    now += show.durations[index];
+  }
+  return mismatches;
+}
+
+// 繰り返し再生は、65536フレームを超えても元のフレームの順序を保つ
+void testLoop() {
+  Show show = randomShow(NUM_LEDS, NUM_FRAMES);
+  std::vector<uint8_t> data = encode(show);
+  printf("%d個のLED、%dフレーム: %u バイト（圧縮前 %u バイト）\n", NUM_LEDS,
+         NUM_FRAMES, static_cast<unsigned>(data.size()),
+         static_cast<unsigned>(NUM_LEDS * NUM_FRAMES * 3));
+  EXPECT_TRUE(data.size() < NUM_LEDS * NUM_FRAMES * 3u);
+
+  LedTapePlayer player(data.data());
+  uint32_t rendered;
+  EXPECT_EQ(play(player, show, 70000, &rendered), 0u);
+  EXPECT_EQ(rendered, 70000u);
+  EXPECT_TRUE(!player.finished());
+}
+
+// 繰り返さない再生は全てのフレームを1度だけ描画し、その後は描画しない
+void testOneShot() {
+  Show show = randomShow(NUM_LEDS, NUM_FRAMES);
+  std::vector<uint8_t> data = encode(show);
+  LedTapePlayer player(data.data(), false);
+  uint32_t rendered;
+  EXPECT_EQ(play(player, show, NUM_FRAMES, &rendered), 0u);
+  EXPECT_EQ(rendered, NUM_FRAMES);
+  EXPECT_TRUE(player.finished());
+
+  CRGB leds[NUM_LEDS];
+  fill_solid(leds, NUM_LEDS, CRGB(CRGB::White));
+  uint32_t redrawn = 0;
+  for (uint32_t i = 0; i < 70000; i++) {
+    redrawn += player.update(leds, NUM_LEDS, 100000UL + i * 50) ? 1 : 0;
+  }
+  EXPECT_EQ(redrawn, 0u);
+  EXPECT_TRUE(leds[0] == CRGB(CRGB::White));
+  EXPECT_TRUE(player.finished());
+
+  // reset() の後は最初から再生し直す
+  player.reset();
+  EXPECT_TRUE(!player.finished());
+  EXPECT_EQ(play(player, show, NUM_FRAMES, &rendered), 0u);
+  EXPECT_EQ(rendered, NUM_FRAMES);
+  EXPECT_TRUE(player.finished());
+}
+
+// 途中で reset() した場合も最初のフレームから再生する
+void testResetMidway() {
+  Show show = randomShow(NUM_LEDS, NUM_FRAMES);
+  std::vector<uint8_t> data = encode(show);
+  LedTapePlayer player(data.data());
+  uint32_t rendered;
+  play(player, show, 25, &rendered);
+  player.reset();
+  EXPECT_EQ(play(player, show, NUM_FRAMES * 2, &rendered), 0u);
+}
+
+// LEDテープのLEDがデータより少ない場合は、範囲外のLEDに書き込まない
+void testFewerLeds() {
+  Show show = randomShow(NUM_LEDS, NUM_FRAMES);
+  std::vector<uint8_t> data = encode(show);
+  LedTapePlayer player(data.data(), false);
+  CRGB leds[NUM_LEDS];
+  fill_solid(leds, NUM_LEDS, CRGB(CRGB::White));
+  unsigned long now = 0;
+  for (uint16_t i = 0; i < NUM_FRAMES; i++) {
+    EXPECT_TRUE(player.update(leds, 10, now));
+    EXPECT_TRUE(Frame(leds, leds + 10) ==
+                Frame(show.frames[i].begin(), show.frames[i].begin() + 10));
+    now += show.durations[i];
+  }
+  EXPECT_TRUE(leds[10] == CRGB(CRGB::White));
+  EXPECT_TRUE(leds[NUM_LEDS - 1] == CRGB(CRGB::White));
+}
+
+} // namespace
+
+int main() {
+  testFormat();
+  testLoop();
+  testOneShot();
+  testResetMidway();
+  testFewerLeds();
+  return testResult();
+}
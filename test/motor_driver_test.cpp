@@ -0,0 +1,192 @@
+// BD62193 と TB67H450 の setPwm() と setSpeed() のテスト
+//
+// 浮動小数点数で速度を計算していた以前の setSpeed() をテストの中に残し、
+// 整数のPWM値を経由する現在の setSpeed() がピンに同じ出力をすることを、
+// -1.2〜1.2の多数の速度で確認します。setPwm() は範囲外を含む全ての整数で確認し、
+// ピン番号をコンパイル時に指定するクラスも同じ出力になることを確認します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <digitalWriteFast.h>
+#include <parts/motors/speed/BD62193.h>
+#include <parts/motors/speed/TB67H450.h>
+
+namespace {
+
+const uint8_t IN_A = 2;
+const uint8_t IN_B = 4;
+const uint8_t PWM = 3;
+const uint8_t IN1 = 9;
+const uint8_t IN2 = 10;
+
+/// 3つのピンの出力（`sim::pinOutput()` の値）
+struct Outputs {
+  int pins[3];
+
+  bool operator==(const Outputs &other) const {
+    return pins[0] == other.pins[0] && pins[1] == other.pins[1] &&
+           pins[2] == other.pins[2];
+  }
+};
+
+Outputs outputs(uint8_t pin1, uint8_t pin2, uint8_t pin3) {
+  return {{sim::pinOutput(pin1), sim::pinOutput(pin2), sim::pinOutput(pin3)}};
+}
+
+Outputs bdOutputs() { return outputs(PWM, IN_A, IN_B); }
+Outputs tbOutputs() { return outputs(IN1, IN2, IN1); }
+
+// 以前の BD62193::setSpeed()（run() に渡すピンの順序を修正したもの）
+void referenceBdSpeed(float rate) {
+  rate = constrain(rate, -1.0, 1.0);
+  if (rate == 0) {
+    digitalWriteFast(IN_A, LOW);
+    digitalWriteFast(IN_B, LOW);
+  } else {
+    uint8_t pwmValue = (uint8_t)(fabsf(rate) * 255);
+    analogWrite(PWM, pwmValue);
+    digitalWriteFast(IN_A, rate > 0);
+    digitalWriteFast(IN_B, rate < 0);
+  }
+}
+
+// 以前の TB67H450::setSpeed()
+void referenceTbSpeed(float rate) {
+  rate = constrain(rate, -1.0, 1.0);
+  if (fabsf(rate) == 1.0) {
+    digitalWriteFast(IN1, rate > 0);
+    digitalWriteFast(IN2, rate < 0);
+  } else if (rate == 0) {
+    digitalWriteFast(IN1, LOW);
+    digitalWriteFast(IN2, LOW);
+  } else {
+    uint8_t pwmValue = (uint8_t)(fabsf(rate) * 255);
+    analogWrite(IN1, rate > 0 ? pwmValue : 0);
+    analogWrite(IN2, rate < 0 ? pwmValue : 0);
+  }
+}
+
+/// PWM値に対応するピンの出力の電圧（0と255はデジタル出力）
+int level(int16_t pwm) {
+  if (pwm <= 0) {
+    return sim::LOW_LEVEL;
+  }
+  return pwm >= 255 ? sim::HIGH_LEVEL : pwm;
+}
+
+/// 速度を以前の実装と現在の実装で設定し、ピンの出力が違う速度の数を返す
+uint32_t compareSpeed(ISpeedAdjustable &motor, void (*reference)(float),
+                      Outputs (*read)(), float rate) {
+  sim::reset();
+  reference(rate);
+  Outputs expected = read();
+  // 1/255 未満の速度はPWM値0に切り捨てられ、方向を出力せずに停止する
+  if (rate != 0 && fabsf(rate) < 1.0f / 255 && reference == referenceBdSpeed) {
+    expected.pins[1] = sim::LOW_LEVEL;
+    expected.pins[2] = sim::LOW_LEVEL;
+  }
+  sim::reset();
+  motor.setSpeed(rate);
+  return read() == expected ? 0 : 1;
+}
+
+// 以前の setSpeed() と同じ出力になる
+void testSetSpeed() {
+  BD62193 bd(IN_A, IN_B, PWM);
+  TB67H450 tb(IN1, IN2);
+  uint32_t bdMismatches = 0;
+  uint32_t tbMismatches = 0;
+  const int32_t steps = 300000;
+  for (int32_t i = -steps; i <= steps; i++) {
+    float rate = 1.2f * i / steps;
+    bdMismatches += compareSpeed(bd, referenceBdSpeed, bdOutputs, rate);
+    tbMismatches += compareSpeed(tb, referenceTbSpeed, tbOutputs, rate);
+  }
+  for (int16_t k = -255; k <= 255; k++) {
+    float rate = k / 255.0f;
+    bdMismatches += compareSpeed(bd, referenceBdSpeed, bdOutputs, rate);
+    tbMismatches += compareSpeed(tb, referenceTbSpeed, tbOutputs, rate);
+  }
+  EXPECT_EQ(bdMismatches, 0u);
+  EXPECT_EQ(tbMismatches, 0u);
+}
+
+// setPwm() は範囲外の値を制限し、PWM値0では両方のピンをLOWにして停止する
+void testSetPwm() {
+  BD62193 bd(IN_A, IN_B, PWM);
+  TB67H450 tb(IN1, IN2);
+  StaticBD62193<IN_A, IN_B, PWM> staticBd;
+  StaticTB67H450<IN1, IN2> staticTb;
+  uint32_t mismatches = 0;
+  for (int16_t pwm = -400; pwm <= 400; pwm++) {
+    int16_t clamped = constrain(pwm, -255, 255);
+    int16_t magnitude = clamped > 0 ? clamped : -clamped;
+
+    Outputs bdExpected = {{clamped == 0 ? sim::LOW_LEVEL : level(magnitude),
+                           clamped > 0 ? sim::HIGH_LEVEL : sim::LOW_LEVEL,
+                           clamped < 0 ? sim::HIGH_LEVEL : sim::LOW_LEVEL}};
+    sim::reset();
+    bd.setPwm(pwm);
+    mismatches += bdOutputs() == bdExpected ? 0 : 1;
+    sim::reset();
+    staticBd.setPwm(pwm);
+    mismatches += bdOutputs() == bdExpected ? 0 : 1;
+
+    Outputs tbExpected = {{level(clamped), level(-clamped), level(clamped)}};
+    sim::reset();
+    tb.setPwm(pwm);
+    mismatches += tbOutputs() == tbExpected ? 0 : 1;
+    sim::reset();
+    staticTb.setPwm(pwm);
+    mismatches += tbOutputs() == tbExpected ? 0 : 1;
+  }
+  EXPECT_EQ(mismatches, 0u);
+}
+
+// PWM出力の後の停止と最大出力は、ピンをタイマーから切り離す
+void testDetach() {
+  sim::reset();
+  TB67H450 tb(IN1, IN2);
+  tb.setPwm(100);
+  EXPECT_EQ(sim::pinOutput(IN1), 100);
+  tb.stop();
+  EXPECT_EQ(sim::pinOutput(IN1), sim::LOW_LEVEL);
+  EXPECT_EQ(sim::pinOutput(IN2), sim::LOW_LEVEL);
+  tb.setPwm(-100);
+  tb.reverse();
+  EXPECT_EQ(sim::pinOutput(IN1), sim::LOW_LEVEL);
+  EXPECT_EQ(sim::pinOutput(IN2), sim::HIGH_LEVEL);
+
+  BD62193 bd(IN_A, IN_B, PWM);
+  bd.setPwm(100);
+  bd.forward();
+  EXPECT_TRUE(bdOutputs() ==
+              (Outputs{{sim::HIGH_LEVEL, sim::HIGH_LEVEL, sim::LOW_LEVEL}}));
+  bd.reverse();
+  EXPECT_TRUE(bdOutputs() ==
+              (Outputs{{sim::HIGH_LEVEL, sim::LOW_LEVEL, sim::HIGH_LEVEL}}));
+  bd.stop();
+  EXPECT_EQ(sim::pinOutput(IN_A), sim::LOW_LEVEL);
+  EXPECT_EQ(sim::pinOutput(IN_B), sim::LOW_LEVEL);
+}
+
+// PWMピンを使用しない BD62193 は、方向だけを出力する
+void testWithoutPwmPin() {
+  sim::reset();
+  BD62193 bd(IN_A, IN_B);
+  bd.setPwm(100);
+  EXPECT_TRUE(bdOutputs() ==
+              (Outputs{{sim::LOW_LEVEL, sim::HIGH_LEVEL, sim::LOW_LEVEL}}));
+  bd.setSpeed(-0.5);
+  EXPECT_TRUE(bdOutputs() ==
+              (Outputs{{sim::LOW_LEVEL, sim::LOW_LEVEL, sim::HIGH_LEVEL}}));
+}
+
+} // namespace
+
+int main() {
+  testSetSpeed();
+  testSetPwm();
+  testDetach();
+  testWithoutPwmPin();
+  return testResult();
+}
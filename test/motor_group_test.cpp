@@ -0,0 +1,175 @@
+// MotorGroup のテスト
+//
+// 模擬したATmega328Pのレジスタで、6つのモーターのPWM値をランダムに設定し、
+// MotorGroup でまとめて出力した場合と、各モーターの setPwm() で出力した場合の
+// ピンの出力が、毎回同じになることを確認します。
+// コンストラクタがモーターの仮想関数を呼び出さないことも確認します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <parts/motors/speed/BD62193.h>
+#include <parts/motors/speed/MotorGroup.h>
+#include <parts/motors/speed/TB67H450.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+/// 出力を調べるピン（2〜17）
+const uint8_t FIRST_PIN = 2;
+const uint8_t LAST_PIN = 17;
+
+typedef std::vector<int> PinOutputs;
+
+PinOutputs readPins() {
+  PinOutputs outputs;
+  for (uint8_t pin = FIRST_PIN; pin <= LAST_PIN; pin++) {
+    outputs.push_back(sim::pinOutput(pin));
+  }
+  return outputs;
+}
+
+/// テストに使う6つのモーター
+struct Motors {
+  BD62193 bd1{2, 4, 3};
+  BD62193 bd2{7, 8, 5};
+  BD62193 bd3{12, 13, 6};
+  TB67H450 tb1{9, 10};
+  TB67H450 tb2{11, 14};                           // ピン14はタイマーなし
+  VirtualMotor<StaticBD62193<15, 16, 17>> other; // getPinWrites() なし
+  ISpeedAdjustable *all[MotorGroup::MAX_MOTORS] = {&bd1, &bd2, &bd3,
+                                                   &tb1, &tb2, &other};
+};
+
+const uint32_t STEPS = 200000;
+
+/// ランダムなPWM値（0と±255、範囲外の値を多めに含める）
+int16_t randomPwm() {
+  switch (rand() % 8) {
+  case 0:
+    return 0;
+  case 1:
+    return 255;
+  case 2:
+    return -255;
+  case 3:
+    return rand() % 801 - 400;
+  default:
+    return rand() % 511 - 255;
+  }
+}
+
+/// ランダムな設定を順に出力し、毎回のピンの出力を記録する
+std::vector<PinOutputs> run(bool grouped) {
+  sim::reset();
+  Motors motors;
+  MotorGroup group(motors.all, MotorGroup::MAX_MOTORS);
+  std::vector<PinOutputs> recorded;
+  srand(1);
+  for (uint32_t step = 0; step < STEPS; step++) {
+    for (uint8_t i = 0; i < MotorGroup::MAX_MOTORS; i++) {
+      int16_t pwm = randomPwm();
+      if (grouped) {
+        group.setPwm(i, pwm);
+      } else {
+        motors.all[i]->setPwm(pwm);
+      }
+    }
+    if (grouped) {
+      group.update();
+    }
+    recorded.push_back(readPins());
+  }
+  return recorded;
+}
+
+// まとめて出力した場合と、1つずつ出力した場合が同じになる
+void testMatchesIndividual() {
+  std::vector<PinOutputs> individual = run(false);
+  std::vector<PinOutputs> grouped = run(true);
+  uint32_t mismatches = 0;
+  for (uint32_t step = 0; step < STEPS; step++) {
+    mismatches += individual[step] == grouped[step] ? 0 : 1;
+  }
+  EXPECT_EQ(mismatches, 0u);
+}
+
+/// getPinWrites() を呼び出した回数を数えるモーター
+class CountingMotor : public BD62193 {
+public:
+  mutable uint32_t pinWriteCalls = 0;
+
+  CountingMotor() : BD62193(2, 4, 3) {}
+
+  uint8_t getPinWrites(int16_t pwm, MotorPinWrite *writes) const override {
+    pinWriteCalls++;
+    return BD62193::getPinWrites(pwm, writes);
+  }
+};
+
+// コンストラクタはモーターの仮想関数を呼び出さない
+// （グローバル変数のモーターより先に構築されても問題ない）
+void testConstructorDoesNotCallMotors() {
+  sim::reset();
+  CountingMotor motor;
+  ISpeedAdjustable *motors[] = {&motor};
+  MotorGroup group(motors, 1);
+  EXPECT_EQ(motor.pinWriteCalls, 0u);
+
+  // 最初の update() でピンを調べる（128、-128、出力するPWM値の3回）
+  group.setPwm(0, 100);
+  group.update();
+  EXPECT_EQ(motor.pinWriteCalls, 3u);
+  EXPECT_EQ(sim::pinOutput(3), 100);
+  EXPECT_EQ(sim::pinOutput(2), sim::HIGH_LEVEL);
+  // 以降は出力するPWM値の1回だけ
+  group.update();
+  EXPECT_EQ(motor.pinWriteCalls, 4u);
+}
+
+// 範囲外の番号とモーターの数は無視し、stop() はすぐに全てを停止する
+void testLimits() {
+  sim::reset();
+  Motors motors;
+  ISpeedAdjustable *many[] = {&motors.bd1, &motors.bd2, &motors.bd3,
+                              &motors.tb1, &motors.tb2, &motors.other,
+                              &motors.bd1};
+  MotorGroup group(many, 7);
+  group.setPwm(6, 200);
+  group.setPwm(0, -200);
+  group.update();
+  EXPECT_EQ(sim::pinOutput(3), 200);
+  EXPECT_EQ(sim::pinOutput(2), sim::LOW_LEVEL);
+  EXPECT_EQ(sim::pinOutput(4), sim::HIGH_LEVEL);
+
+  group.setPwm(3, 150);
+  group.update();
+  EXPECT_EQ(sim::pinOutput(9), 150);
+  group.stop();
+  EXPECT_EQ(sim::pinOutput(4), sim::LOW_LEVEL);
+  EXPECT_EQ(sim::pinOutput(9), sim::LOW_LEVEL);
+  EXPECT_EQ(sim::pinOutput(10), sim::LOW_LEVEL);
+}
+
+// update() は割り込みの許可を元に戻す
+void testInterruptsRestored() {
+  sim::reset();
+  Motors motors;
+  MotorGroup group(motors.all, MotorGroup::MAX_MOTORS);
+  sei();
+  group.setPwm(0, 100);
+  group.update();
+  EXPECT_TRUE(SREG & _BV(SREG_I));
+  cli();
+  group.update();
+  EXPECT_TRUE(!(SREG & _BV(SREG_I)));
+}
+
+} // namespace
+
+int main() {
+  testMatchesIndividual();
+  testConstructorDoesNotCallMotors();
+  testLimits();
+  testInterruptsRestored();
+  return testResult();
+}
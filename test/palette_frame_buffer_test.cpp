@@ -0,0 +1,148 @@
+// PaletteFrameBuffer のテスト
+//
+// Ws2812Output と同じく show() と stream() で1つずつ色を変換して送信する出力を使い、
+// パレットのフレームバッファから送信したデータが、同じ色の CRGB の配列から
+// 送信したデータと1バイトも違わないことを確認します。
+// 4ビットと8ビット、ガンマ補正の有無、明るさの違いを組み合わせて確認します。
+#include "TestHelper.h"
+#include <parts/LedTape.h>
+#include <parts/ledtapes/PaletteFrameBuffer.h>
+#include <vector>
+
+namespace {
+
+/// Ws2812Output と同じ順序（G、R、B）で、送信するバイトを記録する出力
+class WireOutput : public LedOutput {
+public:
+  std::vector<uint8_t> wire; ///< 送信したバイト
+  uint16_t streams = 0;      ///< 出力した回数
+
+  void show(const CRGB *leds, uint16_t numLeds) override {
+    stream(ArraySource{leds}, numLeds);
+  }
+
+  template <typename Source>
+  void stream(const Source &source, uint16_t numLeds) {
+    uint8_t scale = outputScale();
+    wire.clear();
+    for (uint16_t i = 0; i < numLeds; i++) {
+      CRGB color = source(i);
+      wire.push_back(correct(color.g, scale));
+      wire.push_back(correct(color.r, scale));
+      wire.push_back(correct(color.b, scale));
+    }
+    streams++;
+  }
+
+private:
+  struct ArraySource {
+    const CRGB *leds;
+    CRGB operator()(uint16_t index) const { return leds[index]; }
+  };
+};
+
+const uint16_t NUM_LEDS = 301;
+
+const uint32_t colors[] = {
+    LedTape::Black,   LedTape::Red,    LedTape::Lime,       LedTape::Blue,
+    LedTape::White,   LedTape::Purple, LedTape::Orange,     LedTape::Teal,
+    LedTape::Navy,    LedTape::Gold,   LedTape::DeepPink,   LedTape::Olive,
+    LedTape::Maroon,  LedTape::Silver, LedTape::FairyLight, LedTape::Coral,
+};
+
+/// 同じ色のパレットのフレームバッファと CRGB の配列から送信したデータを比べる
+template <uint8_t bitsPerLed, uint16_t paletteSize> void checkWire() {
+  static PaletteFrameBuffer<NUM_LEDS, bitsPerLed, paletteSize> frameBuffer;
+  static CRGB leds[NUM_LEDS];
+  for (uint16_t i = 0; i < paletteSize; i++) {
+    frameBuffer.setPaletteColor(i, colors[i % 16]);
+  }
+  for (uint16_t led = 0; led < NUM_LEDS; led++) {
+    uint8_t index = (led * 7 + led / 16) % paletteSize;
+    frameBuffer.set(led, index);
+    leds[led] = colors[index % 16];
+  }
+
+  for (bool gamma : {false, true}) {
+    for (uint8_t brightness : {255, 64}) {
+      WireOutput fromPalette;
+      WireOutput fromArray;
+      fromPalette.setGammaCorrection(gamma);
+      fromArray.setGammaCorrection(gamma);
+      fromPalette.setBrightness(brightness);
+      fromArray.setBrightness(brightness);
+      frameBuffer.show(fromPalette, true);
+      fromArray.show(leds, NUM_LEDS);
+      EXPECT_EQ(fromPalette.wire.size(), NUM_LEDS * 3u);
+      EXPECT_TRUE(fromPalette.wire == fromArray.wire);
+    }
+  }
+}
+
+void testWire() {
+  checkWire<4, 16>();
+  checkWire<8, 16>();
+  checkWire<8, 40>();
+}
+
+// 4ビットの場合は2つのLEDで1バイトを使い、隣のLEDを書き換えない
+void testPacking() {
+  PaletteFrameBuffer<5> frameBuffer;
+  frameBuffer.set(0, 3);
+  frameBuffer.set(1, 12);
+  frameBuffer.set(4, 15);
+  EXPECT_EQ(frameBuffer.get(0), 3);
+  EXPECT_EQ(frameBuffer.get(1), 12);
+  EXPECT_EQ(frameBuffer.get(2), 0);
+  EXPECT_EQ(frameBuffer.get(4), 15);
+  frameBuffer.set(0, 9);
+  EXPECT_EQ(frameBuffer.get(1), 12);
+  frameBuffer.fill(6);
+  for (uint16_t led = 0; led < 5; led++) {
+    EXPECT_EQ(frameBuffer.get(led), 6);
+  }
+  // 範囲外のLEDとパレットの番号は無視する
+  frameBuffer.set(5, 1);
+  frameBuffer.set(0, 16);
+  frameBuffer.fill(16);
+  EXPECT_EQ(frameBuffer.get(0), 6);
+  EXPECT_TRUE(frameBuffer.getPaletteColor(16) == CRGB(0, 0, 0));
+}
+
+// 変更がない場合は出力しない
+void testDirty() {
+  PaletteFrameBuffer<10> frameBuffer;
+  WireOutput output;
+  EXPECT_TRUE(frameBuffer.show(output)); // 最初は必ず出力する
+  EXPECT_TRUE(!frameBuffer.show(output));
+
+  frameBuffer.set(3, 0); // 同じ番号
+  frameBuffer.setPaletteColor(2, CRGB(0, 0, 0)); // 同じ色
+  EXPECT_TRUE(!frameBuffer.show(output));
+
+  frameBuffer.setPaletteColor(1, LedTape::Red);
+  EXPECT_TRUE(frameBuffer.show(output));
+  frameBuffer.set(3, 1);
+  EXPECT_TRUE(frameBuffer.show(output));
+  EXPECT_EQ(output.wire[3 * 3 + 1], 255); // 赤（G、R、Bの順）
+  EXPECT_TRUE(frameBuffer.show(output, true));
+  EXPECT_EQ(output.streams, 4);
+}
+
+// SRAMの使用量（LEDごとの番号とパレット）
+void testSize() {
+  EXPECT_EQ(sizeof(PaletteFrameBuffer<NUM_LEDS>), 151u + 16 * 3 + 1);
+  EXPECT_EQ(sizeof(PaletteFrameBuffer<NUM_LEDS, 8>), 301u + 16 * 3 + 1);
+  EXPECT_TRUE(sizeof(PaletteFrameBuffer<NUM_LEDS>) <
+              sizeof(CRGB[NUM_LEDS]) / 4);
+}
+
+} // namespace
+
+int main() {
+  testWire();
+  testPacking();
+  testDirty();
+  testSize();
+  return testResult();
+}
@@ -0,0 +1,155 @@
+// QuadratureEncoder のテスト
+//
+// 16通りの状態の変化を引く表が、正転、逆転、チャタリング、2つの相が同時に変わる
+// 読み飛ばしを正しく数えることと、同じポートの複数のエンコーダーを1回のポートの
+// 読み込みで数えることを確認します。begin() が設定するピン変化割り込みの
+// レジスタ（PCMSKn、PCICR）も確認します。
+// ATmega328P向けのビルドと、ピンごとにPCMSKnを設定する他のマイコン向けのビルドの
+// 2つで実行します。
+#include "TestHelper.h"
+#include <Arduino.h>
+#include <parts/QuadratureEncoder.h>
+
+namespace {
+
+/// 正転の順序（A相を1ビット目、B相を0ビット目とする）
+const uint8_t FORWARD[4] = {0b00, 0b10, 0b11, 0b01};
+
+// 表の16通り全て
+void testDecodeTable() {
+  for (uint8_t i = 0; i < 4; i++) {
+    uint8_t state = FORWARD[i];
+    uint8_t next = FORWARD[(i + 1) % 4];
+    uint8_t opposite = FORWARD[(i + 2) % 4];
+    // 正転は1、逆転は-1
+    EXPECT_EQ(QuadratureEncoder::decode(state, next), 1);
+    EXPECT_EQ(QuadratureEncoder::decode(next, state), -1);
+    // 変化なしと、2つの相が同時に変わった場合（読み飛ばし）は0
+    EXPECT_EQ(QuadratureEncoder::decode(state, state), 0);
+    EXPECT_EQ(QuadratureEncoder::decode(state, opposite), 0);
+  }
+}
+
+/// エンコーダーの状態をポートの値にする
+uint8_t portState(uint8_t pinA, uint8_t pinB, uint8_t state) {
+  return ((state & 2) ? _BV(pinA) : 0) | ((state & 1) ? _BV(pinB) : 0);
+}
+
+// 同じポートの3つのエンコーダーを、正転、逆転、停止させる
+void testCounting() {
+  sim::reset();
+  QuadratureEncoder encoders;
+  EXPECT_EQ(encoders.add(2, 3), 0);
+  EXPECT_EQ(encoders.add(4, 5), 1);
+  EXPECT_EQ(encoders.add(6, 7), 2);
+  encoders.begin();
+
+  // 100周期（400カウント）正転、50周期逆転、停止
+  for (int i = 1; i <= 400; i++) {
+    uint8_t forward = FORWARD[i % 4];
+    uint8_t backward = FORWARD[(4 - (i % 4)) % 4];
+    uint8_t port = portState(2, 3, forward);
+    if (i <= 200) {
+      port |= portState(4, 5, backward);
+    }
+    encoders.update(port);
+  }
+  int32_t counts[3];
+  encoders.readAll(counts);
+  EXPECT_EQ(counts[0], 400);
+  EXPECT_EQ(counts[1], -200);
+  EXPECT_EQ(counts[2], 0);
+}
+
+// チャタリング（A相が行き来する）は打ち消し合い、読み飛ばしは数えない
+void testBounceAndJump() {
+  sim::reset();
+  QuadratureEncoder encoders;
+  encoders.add(2, 3);
+  encoders.begin();
+
+  // 00 -> 10 -> 00 -> 10 -> 00 -> 10 （チャタリングの後に1つ進む）
+  const uint8_t bounce[] = {0b10, 0b00, 0b10, 0b00, 0b10};
+  for (uint8_t state : bounce) {
+    encoders.update(portState(2, 3, state));
+  }
+  EXPECT_EQ(encoders.read(0), 1);
+
+  // 10 -> 01 は2つの相が同時に変わるため数えず、その後は01から数える
+  encoders.update(portState(2, 3, 0b01));
+  EXPECT_EQ(encoders.read(0), 1);
+  encoders.update(portState(2, 3, 0b00));
+  EXPECT_EQ(encoders.read(0), 2);
+
+  // 11 -> 00 も数えない
+  encoders.update(portState(2, 3, 0b11));
+  EXPECT_EQ(encoders.read(0), 2);
+  encoders.update(portState(2, 3, 0b01));
+  EXPECT_EQ(encoders.read(0), 3);
+}
+
+// begin() は現在の状態を記録し、ピン変化割り込みを有効にする
+void testBegin() {
+  sim::reset();
+  QuadratureEncoder encoders;
+  encoders.add(9, 8);
+  encoders.add(12, 13);
+  // 開始時にA相がHIGHでも、数えない
+  sim::setInput(9, true);
+  encoders.begin();
+  EXPECT_EQ(PCMSK0, _BV(1) | _BV(0) | _BV(4) | _BV(5));
+  EXPECT_EQ(PCMSK1, 0);
+  EXPECT_EQ(PCMSK2, 0);
+  EXPECT_EQ(PCICR, _BV(PCIE0));
+  EXPECT_EQ(PCIFR, _BV(PCIE0));
+
+  // 割り込みハンドラから呼び出すと、入力レジスタ（PINB）を読み込む
+  encoders.handleInterrupt();
+  EXPECT_EQ(encoders.read(0), 0);
+  sim::setInput(8, true); // 10 -> 11
+  encoders.handleInterrupt();
+  EXPECT_EQ(encoders.read(0), 1);
+  sim::setInput(12, true); // 00 -> 10
+  encoders.handleInterrupt();
+  EXPECT_EQ(encoders.read(1), 1);
+
+  // アナログピン（ポートC）は PCMSK1
+  sim::reset();
+  QuadratureEncoder analog;
+  analog.add(14, 15);
+  analog.begin();
+  EXPECT_EQ(PCMSK1, _BV(0) | _BV(1));
+  EXPECT_EQ(PCICR, _BV(PCIE1));
+}
+
+// 追加できないピンと、範囲外の番号
+void testLimits() {
+  sim::reset();
+  QuadratureEncoder encoders;
+  EXPECT_EQ(encoders.add(2, 9), QuadratureEncoder::INVALID_INDEX); // 別のポート
+  EXPECT_EQ(encoders.add(2, 3), 0);
+  EXPECT_EQ(encoders.add(8, 9), QuadratureEncoder::INVALID_INDEX);
+  encoders.add(4, 5);
+  encoders.add(6, 7);
+  encoders.add(0, 1);
+  EXPECT_EQ(encoders.add(2, 3), QuadratureEncoder::INVALID_INDEX); // 5つ目
+  EXPECT_EQ(encoders.size(), 4);
+
+  encoders.write(1, 1234);
+  EXPECT_EQ(encoders.read(1), 1234);
+  encoders.write(4, 99);
+  EXPECT_EQ(encoders.read(4), 0);
+  encoders.write(1);
+  EXPECT_EQ(encoders.read(1), 0);
+}
+
+} // namespace
+
+int main() {
+  testDecodeTable();
+  testCounting();
+  testBounceAndJump();
+  testBegin();
+  testLimits();
+  return testResult();
+}
@@ -0,0 +1,147 @@
+// RingBuffer のテスト
+//
+// 満杯と空の境界、位置の折り返しを確認した後、書き込み側のスレッド
+// （受信割り込みの代わり）と読み出し側（メインループの代わり）で
+// 同時に読み書きしても、全ての要素が順番通りに届くことを確認します。
+// PC上では位置を std::atomic で読み書きするため、x86以外でも順序が保証されます。
+#include "TestHelper.h"
+#include <fasts/RingBuffer.h>
+#include <thread>
+
+namespace {
+
+// 格納できる要素数は capacity - 1
+void testFullAndEmpty() {
+  RingBuffer<uint8_t, 4> buffer;
+  uint8_t value = 0;
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_TRUE(!buffer.pop(value));
+  EXPECT_EQ(buffer.space(), 3);
+
+  EXPECT_TRUE(buffer.push(1));
+  EXPECT_TRUE(buffer.push(2));
+  EXPECT_TRUE(buffer.push(3));
+  EXPECT_TRUE(!buffer.push(4)); // 満杯
+  EXPECT_EQ(buffer.size(), 3);
+  EXPECT_EQ(buffer.space(), 0);
+
+  EXPECT_TRUE(buffer.pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(buffer.push(4)); // 1つ読み出すと1つ書き込める
+  EXPECT_TRUE(!buffer.push(5));
+
+  for (uint8_t expected = 2; expected <= 4; expected++) {
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_TRUE(!buffer.pop(value));
+}
+
+// 位置が何度も折り返しても、要素数と順番が変わらない
+void testWrapAround() {
+  RingBuffer<uint16_t, 8> buffer;
+  uint16_t next = 0;
+  uint16_t expected = 0;
+  for (int round = 0; round < 1000; round++) {
+    // 1～7個書き込んで、同じ数だけ読み出す
+    uint8_t count = 1 + round % 7;
+    for (uint8_t i = 0; i < count; i++) {
+      EXPECT_TRUE(buffer.push(next++));
+    }
+    EXPECT_EQ(buffer.size(), count);
+    EXPECT_EQ(buffer.space(), 7 - count);
+    uint16_t value = 0;
+    while (buffer.pop(value)) {
+      EXPECT_EQ(value, expected++);
+    }
+    EXPECT_TRUE(buffer.empty());
+  }
+  EXPECT_EQ(expected, next);
+}
+
+// まとめて書き込む場合は、空きがある分だけ書き込む
+void testBulkPush() {
+  RingBuffer<uint8_t, 8> buffer;
+  const uint8_t values[] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+  uint8_t value = 0;
+  // 折り返す位置まで進めておく
+  for (int i = 0; i < 5; i++) {
+    buffer.push(0);
+    buffer.pop(value);
+  }
+  EXPECT_EQ(buffer.push(values, 10), 7);
+  EXPECT_EQ(buffer.space(), 0);
+  EXPECT_EQ(buffer.push(values, 1), 0);
+  for (uint8_t i = 0; i < 7; i++) {
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(value, values[i]);
+  }
+  EXPECT_TRUE(buffer.empty());
+}
+
+// 書き込み側のスレッドと読み出し側で同時に読み書きする
+void testProducerConsumer() {
+  static RingBuffer<uint32_t, 16> buffer;
+  const uint32_t total = 200000;
+
+  std::thread producer([&] {
+    uint32_t next = 0;
+    uint32_t chunk[5];
+    while (next < total) {
+      if (next % 3 == 0) {
+        // まとめて書き込む（書き込めた分だけ進める）
+        uint8_t count = 0;
+        while (count < 5 && next + count < total) {
+          chunk[count] = next + count;
+          count++;
+        }
+        uint8_t pushed = buffer.push(chunk, count);
+        if (pushed == 0) {
+          // 満杯（CPUが1つの場合も読み出し側を進める）
+          std::this_thread::yield();
+        }
+        next += pushed;
+      } else if (buffer.push(next)) {
+        next++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t expected = 0;
+  uint32_t outOfOrder = 0;
+  uint32_t fullObserved = 0;
+  while (expected < total) {
+    uint8_t size = buffer.size();
+    if (size == 15) {
+      fullObserved++;
+    }
+    uint32_t value = 0;
+    if (buffer.pop(value)) {
+      if (value != expected) {
+        outOfOrder++;
+      }
+      expected = value + 1;
+    } else {
+      std::this_thread::yield(); // 空
+    }
+  }
+  producer.join();
+
+  EXPECT_EQ(outOfOrder, 0u);
+  EXPECT_EQ(expected, total);
+  EXPECT_TRUE(buffer.empty());
+  printf("満杯の状態を観測した回数: %u\n", static_cast<unsigned>(fullObserved));
+}
+
+} // namespace
+
+int main() {
+  testFullAndEmpty();
+  testWrapAround();
+  testBulkPush();
+  testProducerConsumer();
+  return testResult();
+}
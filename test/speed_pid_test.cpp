@@ -0,0 +1,208 @@
+// SpeedPid のテスト
+//
+// 1次遅れのモーター（時定数80ms）を模擬し、10msごとの制御で目標の回転速度に
+// 追従すること、電池の電圧の低下と負荷の増加を打ち消すこと、出力が飽和し続けた後も
+// 積分項が大きくなりすぎないこと（アンチワインドアップ）を確認します。
+// 計算式、微分項、桁あふれの確認と、update() の処理時間の表示も行います。
+#include "TestHelper.h"
+#include <chrono>
+#include <math.h>
+#include <parts/motors/speed/SpeedPid.h>
+#include <stdio.h>
+
+namespace {
+
+/// 出力されたPWM値を保持するモーター
+class PwmMotor : public ISpeedAdjustable {
+public:
+  int16_t pwm = 0;
+  uint32_t writes = 0;
+
+  void setPwm(int16_t value) override {
+    pwm = value;
+    writes++;
+  }
+  void forward() override { setPwm(255); }
+  void reverse() override { setPwm(-255); }
+  void stop() override { setPwm(0); }
+};
+
+/// 1次遅れのモーター（回転速度はカウント/秒）
+struct SimulatedMotor {
+  double gain = 6000; ///< PWM値255での回転速度（電池の電圧に比例）
+  double load = 0;    ///< 負荷による回転速度の低下
+  double speed = 0;   ///< 回転速度
+  double position = 0;
+
+  /// 1msごとに10ms進める
+  void step(int16_t pwm) {
+    const double dt = 0.001;
+    const double tau = 0.08;
+    for (int i = 0; i < 10; i++) {
+      speed += dt / tau * (gain * pwm / 255.0 - speed - load);
+      position += speed * dt;
+    }
+  }
+};
+
+// 目標に追従し、電圧の低下と負荷の増加を打ち消す
+void testStepResponse() {
+  PwmMotor motor;
+  SpeedPid pid(motor, 512, 96, 64); // Kp = 2.0、Ki = 0.375、Kd = 0.25
+  SimulatedMotor sim;
+  const double target = 4000; // カウント/秒
+  pid.update(0);
+  pid.setTarget(static_cast<int16_t>(target * 0.01));
+
+  double maxSpeed = 0;
+  double riseTime = -1;
+  double errorSum = 0;
+  int errorCount = 0;
+  for (int k = 0; k < 300; k++) {
+    double t = k * 0.01;
+    if (k == 150) {
+      sim.gain = 4500; // 1.5秒で電池の電圧が25%下がる
+    }
+    if (k == 220) {
+      sim.load = 300; // 2.2秒で負荷が増える
+    }
+    sim.step(motor.pwm);
+    pid.update(static_cast<int32_t>(sim.position));
+    if (t < 1.5) {
+      maxSpeed = sim.speed > maxSpeed ? sim.speed : maxSpeed;
+      if (riseTime < 0 && sim.speed >= 0.9 * target) {
+        riseTime = t;
+      }
+    }
+    // 変化の後、落ち着いた区間の誤差
+    if ((t > 1.2 && t < 1.5) || (t > 2.0 && t < 2.2) || t > 2.8) {
+      errorSum += fabs(sim.speed - target);
+      errorCount++;
+    }
+  }
+  double overshoot = maxSpeed / target - 1;
+  double meanError = errorSum / errorCount / target;
+  printf("90%%までの時間 %.2f 秒、オーバーシュート %.1f%%、平均誤差 %.2f%%\n",
+         riseTime, overshoot * 100, meanError * 100);
+  EXPECT_TRUE(riseTime > 0 && riseTime < 0.3);
+  EXPECT_TRUE(overshoot < 0.05);
+  EXPECT_TRUE(meanError < 0.01);
+}
+
+// 2秒間出力が飽和した後、目標を下げるとすぐに飽和から抜ける
+void testAntiWindup() {
+  PwmMotor motor;
+  SpeedPid pid(motor, 512, 96, 64);
+  int32_t count = 0;
+  pid.update(count);
+  pid.setTarget(200);
+  for (int i = 0; i < 200; i++) {
+    count += 30; // モーターが30カウントしか回らない
+    pid.update(count);
+  }
+  EXPECT_EQ(motor.pwm, 255);
+
+  pid.setTarget(30);
+  int updates = 0;
+  for (int i = 1; i <= 20 && updates == 0; i++) {
+    count += 30;
+    pid.update(count);
+    if (motor.pwm < 255) {
+      updates = i;
+    }
+  }
+  EXPECT_EQ(updates, 1);
+}
+
+// PWM値 = (Kp × 偏差 + Ki × 偏差の積算 - Kd × 速度の変化) / 256
+void testControlLaw() {
+  PwmMotor motor;
+  SpeedPid pid(motor, 256, 128, 512);
+  // 最初の呼び出しは記録するだけで、出力しない
+  EXPECT_EQ(pid.update(1000), 0);
+  EXPECT_EQ(motor.writes, 0u);
+
+  pid.setTarget(10);
+  // 速度4、偏差6、積算6、速度の変化4: (256 * 6 + 128 * 6 - 512 * 4) / 256 = 1
+  EXPECT_EQ(pid.update(1004), 1);
+  EXPECT_EQ(pid.getSpeed(), 4);
+  // 速度6、偏差4、積算10、速度の変化2: (256 * 4 + 128 * 10 - 512 * 2) / 256 = 5
+  EXPECT_EQ(pid.update(1010), 5);
+  EXPECT_EQ(motor.pwm, 5);
+  EXPECT_EQ(motor.writes, 2u);
+
+  // reset() は停止させ、次の呼び出しは記録するだけ
+  pid.reset();
+  EXPECT_EQ(motor.pwm, 0);
+  EXPECT_EQ(pid.update(5000), 0);
+  EXPECT_EQ(motor.writes, 3u);
+}
+
+// 微分項は測った速度の変化だけを使い、目標の変化では出力が跳ねない
+void testDerivativeOnMeasurement() {
+  PwmMotor motor;
+  SpeedPid pid(motor, 0, 0, 256);
+  int32_t count = 0;
+  pid.update(count);
+  for (int i = 0; i < 5; i++) {
+    pid.setTarget(i * 100);
+    count += 7;
+    pid.update(count);
+  }
+  // 速度が一定なら、目標を変えても出力は0（最初の1回だけ速度0からの変化）
+  EXPECT_EQ(motor.pwm, 0);
+  count += 17;
+  EXPECT_EQ(pid.update(count), -10);
+}
+
+// ゲインと速度が最大でも桁あふれせず、符号が正しい
+void testOverflow() {
+  PwmMotor motor;
+  SpeedPid pid(motor, 65535, 65535, 65535);
+  int32_t count = 0;
+  pid.update(count);
+  pid.setTarget(32767);
+  bool signOk = true;
+  for (int i = 0; i < 100; i++) {
+    count -= 1000000; // 目標と逆向きに大きく回る
+    signOk = signOk && pid.update(count) == 255;
+  }
+  EXPECT_TRUE(signOk);
+  pid.setTarget(-32768);
+  for (int i = 0; i < 100; i++) {
+    count += 1000000;
+    signOk = signOk && pid.update(count) == -255;
+  }
+  EXPECT_TRUE(signOk);
+}
+
+// update() 1回あたりの処理時間（結果は表示するだけで、チェックはしない）
+void benchmark() {
+  PwmMotor motor;
+  SpeedPid pid(motor, 512, 96, 64);
+  pid.update(0);
+  pid.setTarget(40);
+  const long updates = 1000000;
+  int32_t count = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < updates; i++) {
+    count += (i * 7) & 63;
+    pid.update(count);
+  }
+  auto end = std::chrono::steady_clock::now();
+  printf("update() 1回: %.2f ns\n",
+         std::chrono::duration<double, std::nano>(end - start).count() /
+             updates);
+}
+
+} // namespace
+
+int main() {
+  testStepResponse();
+  testAntiWindup();
+  testControlLaw();
+  testDerivativeOnMeasurement();
+  testOverflow();
+  benchmark();
+  return testResult();
+}
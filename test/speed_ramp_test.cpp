@@ -0,0 +1,184 @@
+// SpeedRamp のテスト
+//
+// 0.2〜3.2msのランダムな間隔で tick() を呼び出し、0 → -255 → 255 と目標を変えた時の
+// 出力が、一定の速さで変化する理想の速度から離れないことを確認します。
+// 全範囲の変化にかかる時間、PWM値が変化した時だけ出力すること、
+// micros() の桁あふれと長い間隔の後の動作も確認し、tick() の処理時間を表示します。
+#include "TestHelper.h"
+#include <chrono>
+#include <math.h>
+#include <parts/motors/speed/SpeedRamp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+/// setPwm() で出力されたPWM値を記録するモーター
+class RecordingMotor : public ISpeedAdjustable {
+public:
+  std::vector<int16_t> written; ///< 出力されたPWM値
+
+  void setPwm(int16_t pwm) override { written.push_back(pwm); }
+  void forward() override { setPwm(255); }
+  void reverse() override { setPwm(-255); }
+  void stop() override { setPwm(0); }
+};
+
+/// 理想の速度を目標に向けて、経過時間 × 変化量だけ近づける
+double moveIdeal(double ideal, double target, double slope,
+                 unsigned long elapsed) {
+  double delta = slope * elapsed / 1e6;
+  if (ideal < target) {
+    return ideal + delta < target ? ideal + delta : target;
+  }
+  return ideal - delta > target ? ideal - delta : target;
+}
+
+/// 目標に達するまで tick() を呼び出し、理想の速度との差の最大値を返す
+double rampTo(SpeedRamp &ramp, double &ideal, int16_t target, double slope,
+              unsigned long &now) {
+  double error = 0;
+  ramp.setPwm(target);
+  while (!ramp.isSettled()) {
+    unsigned long elapsed = 200 + rand() % 3001;
+    now += elapsed;
+    ramp.tick(now);
+    ideal = moveIdeal(ideal, target, slope, elapsed);
+    double e = fabs(ramp.getPwm() - ideal);
+    error = e > error ? e : error;
+  }
+  return error;
+}
+
+// 出力は、理想の速度から2未満しか離れない
+void testTracking() {
+  const uint16_t slopes[] = {37, 100, 510, 1000, 10000, 65535};
+  srand(1);
+  for (uint16_t slope : slopes) {
+    RecordingMotor motor;
+    SpeedRamp ramp(motor, slope);
+    unsigned long now = 0;
+    ramp.tick(now);
+    double ideal = 0;
+    double error = rampTo(ramp, ideal, -255, slope, now);
+    double e = rampTo(ramp, ideal, 255, slope, now);
+    error = e > error ? e : error;
+    EXPECT_TRUE(error < 2.0);
+    EXPECT_EQ(ramp.getPwm(), 255);
+    EXPECT_EQ(motor.written.back(), 255);
+  }
+}
+
+// 510/秒の場合、-255から255まで約1秒で変化する
+void testFullSwing() {
+  RecordingMotor motor;
+  SpeedRamp ramp(motor, 510);
+  ramp.reverse();
+  unsigned long now = 0;
+  ramp.tick(now);
+  ramp.tick(now += 2000000);
+  EXPECT_EQ(ramp.getPwm(), -255);
+
+  ramp.forward();
+  unsigned long start = now;
+  while (!ramp.isSettled()) {
+    ramp.tick(now += 1000);
+  }
+  unsigned long duration = now - start;
+  EXPECT_TRUE(duration >= 999000 && duration <= 1004000);
+
+  // PWM値が変化した時だけ、1つずつ出力する
+  EXPECT_EQ(motor.written.size(), 1u + 510u);
+  for (size_t i = 2; i < motor.written.size(); i++) {
+    EXPECT_EQ(motor.written[i], motor.written[i - 1] + 1);
+  }
+}
+
+// 最初の tick() は時刻を記録するだけで、stopNow() はすぐに停止する
+void testFirstTickAndStopNow() {
+  RecordingMotor motor;
+  SpeedRamp ramp(motor, 255);
+  ramp.setPwm(400); // 範囲外の値は制限する
+  EXPECT_EQ(ramp.getTargetPwm(), 255);
+  ramp.tick(123456);
+  EXPECT_EQ(ramp.getPwm(), 0);
+  EXPECT_TRUE(motor.written.empty());
+  ramp.tick(123456 + 500000);
+  EXPECT_EQ(ramp.getPwm(), 127);
+
+  ramp.stopNow();
+  EXPECT_EQ(ramp.getPwm(), 0);
+  EXPECT_EQ(motor.written.back(), 0);
+  EXPECT_TRUE(ramp.isSettled());
+}
+
+// micros() が桁あふれしても経過時間は正しく、長い間隔の後は目標に達する
+void testWrapAndLongGap() {
+  RecordingMotor motor;
+  SpeedRamp ramp(motor, 1000);
+  ramp.setPwm(-255);
+  // micros() と同じ32ビットの時刻
+  uint32_t now = 0xFFFFFFFFUL - 50000;
+  ramp.tick(now);
+  ramp.tick(now + 100000); // 桁あふれして約50000になる
+  // 0.1秒で100（1マイクロ秒あたりの変化量の切り捨てで、僅かに足りない）
+  EXPECT_EQ(ramp.getPwm(), -99);
+
+  // 経過時間 × 1マイクロ秒あたりの変化量が32ビットを僅かに超える間隔
+  // （2^32 / 4194 を切り上げた値。桁あふれすると変化量がほぼ0になる）
+  now += 100000 + 1024075;
+  ramp.setPwm(255);
+  ramp.tick(now);
+  EXPECT_EQ(ramp.getPwm(), 255);
+  EXPECT_TRUE(ramp.isSettled());
+
+  // 変化量0は1として扱う
+  ramp.setMaxSlope(0);
+  ramp.setPwm(0);
+  ramp.tick(now + 1000000); // 1秒後
+  EXPECT_EQ(ramp.getPwm(), 254);
+}
+
+/// tick() 1回あたりの処理時間（ナノ秒）を測る
+double measure(SpeedRamp &ramp, unsigned long &now, unsigned long interval,
+               int16_t target) {
+  const int ticks = 100000;
+  volatile int16_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ticks; i++) {
+    if (target != 0) {
+      ramp.setPwm(i & 1 ? target : -target);
+    }
+    now += interval;
+    ramp.tick(now);
+    sink = sink + ramp.getPwm();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         ticks;
+}
+
+// 速度が一定、変化中、長い間隔の後の処理時間（結果は表示するだけで、チェックはしない）
+void benchmark() {
+  RecordingMotor motor;
+  SpeedRamp ramp(motor, 510);
+  unsigned long now = 0;
+  ramp.tick(now);
+  double settled = measure(ramp, now, 1000, 0);
+  double ramping = measure(ramp, now, 1000, 255);
+  double longGap = measure(ramp, now, 2000000, 255);
+  printf("tick() 1回: 一定 %.1f ns、変化中 %.1f ns、2秒後 %.1f ns\n", settled,
+         ramping, longGap);
+}
+
+} // namespace
+
+int main() {
+  testTracking();
+  testFullSwing();
+  testFirstTickAndStopNow();
+  testWrapAndLongGap();
+  benchmark();
+  return testResult();
+}
@@ -0,0 +1,341 @@
+#include <Arduino.h>
+#include <FastLED.h>
+#include <MsTimer2.h>
+#include <stdio.h>
+
+// 模擬レジスタ
+volatile uint8_t PINB, PINC, PIND;
+volatile uint8_t DDRB, DDRC, DDRD;
+volatile uint8_t PORTB, PORTC, PORTD;
+FakeSreg SREG;
+volatile uint8_t TCCR0A, TCCR0B, OCR0A, OCR0B;
+volatile uint8_t TCCR1A, TCCR1B;
+volatile uint16_t OCR1A, OCR1B;
+volatile uint8_t TCCR2A, TCCR2B, OCR2A, OCR2B, TIMSK2;
+volatile uint8_t PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2;
+FakeUdr UDR0;
+volatile uint8_t UCSR0A, UCSR0B, UCSR0C;
+volatile uint16_t UBRR0;
+
+HardwareSerial Serial;
+CFastLED FastLED;
+
+namespace {
+
+// Arduinoの unsigned long と同じく32ビットで桁あふれさせる
+uint32_t currentMillis = 0;
+uint32_t currentMicros = 0;
+
+// タイマーの出力を接続するビットと、比較レジスタの値
+struct TimerOutput {
+  volatile uint8_t *tccr;
+  uint8_t bit;
+  uint16_t value;
+};
+
+bool timerOutput(uint8_t timer, TimerOutput &output) {
+  switch (timer) {
+  case TIMER0A:
+    output = {&TCCR0A, _BV(COM0A1), OCR0A};
+    return true;
+  case TIMER0B:
+    output = {&TCCR0A, _BV(COM0B1), OCR0B};
+    return true;
+  case TIMER1A:
+    output = {&TCCR1A, _BV(COM1A1), OCR1A};
+    return true;
+  case TIMER1B:
+    output = {&TCCR1A, _BV(COM1B1), OCR1B};
+    return true;
+  case TIMER2A:
+    output = {&TCCR2A, _BV(COM2A1), OCR2A};
+    return true;
+  case TIMER2B:
+    output = {&TCCR2A, _BV(COM2B1), OCR2B};
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Arduinoのコアの turnOffPWM() と同じく、タイマーの出力を切断する
+void turnOffPwm(uint8_t timer) {
+  TimerOutput output;
+  if (timerOutput(timer, output)) {
+    *output.tccr &= ~output.bit;
+  }
+}
+
+void (*msTimer2Callback)() = nullptr;
+
+} // namespace
+
+uint8_t digitalPinToPort(uint8_t pin) {
+  if (pin < 8) {
+    return PD;
+  }
+  if (pin < 14) {
+    return PB;
+  }
+  if (pin < 20) {
+    return PC;
+  }
+  return NOT_A_PIN;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin) {
+  if (pin < 8) {
+    return _BV(pin);
+  }
+  if (pin < 14) {
+    return _BV(pin - 8);
+  }
+  if (pin < 20) {
+    return _BV(pin - 14);
+  }
+  return 0;
+}
+
+uint8_t digitalPinToTimer(uint8_t pin) {
+  switch (pin) {
+  case 3:
+    return TIMER2B;
+  case 5:
+    return TIMER0B;
+  case 6:
+    return TIMER0A;
+  case 9:
+    return TIMER1A;
+  case 10:
+    return TIMER1B;
+  case 11:
+    return TIMER2A;
+  default:
+    return NOT_ON_TIMER;
+  }
+}
+
+volatile uint8_t *portOutputRegister(uint8_t port) {
+  switch (port) {
+  case PB:
+    return &PORTB;
+  case PC:
+    return &PORTC;
+  case PD:
+    return &PORTD;
+  default:
+    return nullptr;
+  }
+}
+
+volatile uint8_t *portInputRegister(uint8_t port) {
+  switch (port) {
+  case PB:
+    return &PINB;
+  case PC:
+    return &PINC;
+  case PD:
+    return &PIND;
+  default:
+    return nullptr;
+  }
+}
+
+volatile uint8_t *portModeRegister(uint8_t port) {
+  switch (port) {
+  case PB:
+    return &DDRB;
+  case PC:
+    return &DDRC;
+  case PD:
+    return &DDRD;
+  default:
+    return nullptr;
+  }
+}
+
+uint8_t digitalPinToPCICRbit(uint8_t pin) {
+  return pin < 8 ? PCIE2 : (pin < 14 ? PCIE0 : PCIE1);
+}
+
+volatile uint8_t *digitalPinToPCMSK(uint8_t pin) {
+  return pin < 8 ? &PCMSK2 : (pin < 14 ? &PCMSK0 : &PCMSK1);
+}
+
+uint8_t digitalPinToPCMSKbit(uint8_t pin) {
+  return pin < 8 ? pin : (pin < 14 ? pin - 8 : pin - 14);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  volatile uint8_t *ddr = portModeRegister(digitalPinToPort(pin));
+  if (ddr == nullptr) {
+    return;
+  }
+  if (mode == OUTPUT) {
+    *ddr |= digitalPinToBitMask(pin);
+  } else {
+    *ddr &= ~digitalPinToBitMask(pin);
+    if (mode == INPUT_PULLUP) {
+      *portOutputRegister(digitalPinToPort(pin)) |= digitalPinToBitMask(pin);
+    }
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  volatile uint8_t *out = portOutputRegister(digitalPinToPort(pin));
+  if (out == nullptr) {
+    return;
+  }
+  turnOffPwm(digitalPinToTimer(pin));
+  if (value == LOW) {
+    *out &= ~digitalPinToBitMask(pin);
+  } else {
+    *out |= digitalPinToBitMask(pin);
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  volatile uint8_t *in = portInputRegister(digitalPinToPort(pin));
+  if (in == nullptr) {
+    return LOW;
+  }
+  turnOffPwm(digitalPinToTimer(pin));
+  return (*in & digitalPinToBitMask(pin)) ? HIGH : LOW;
+}
+
+// Arduinoのコアの analogWrite() と同じ動作
+void analogWrite(uint8_t pin, int value) {
+  pinMode(pin, OUTPUT);
+  if (value == 0) {
+    digitalWrite(pin, LOW);
+    return;
+  }
+  if (value == 255) {
+    digitalWrite(pin, HIGH);
+    return;
+  }
+  switch (digitalPinToTimer(pin)) {
+  case TIMER0A:
+    TCCR0A |= _BV(COM0A1);
+    OCR0A = value;
+    break;
+  case TIMER0B:
+    TCCR0A |= _BV(COM0B1);
+    OCR0B = value;
+    break;
+  case TIMER1A:
+    TCCR1A |= _BV(COM1A1);
+    OCR1A = value;
+    break;
+  case TIMER1B:
+    TCCR1A |= _BV(COM1B1);
+    OCR1B = value;
+    break;
+  case TIMER2A:
+    TCCR2A |= _BV(COM2A1);
+    OCR2A = value;
+    break;
+  case TIMER2B:
+    TCCR2A |= _BV(COM2B1);
+    OCR2B = value;
+    break;
+  default:
+    digitalWrite(pin, value < 128 ? LOW : HIGH);
+    break;
+  }
+}
+
+unsigned long millis() { return currentMillis; }
+unsigned long micros() { return currentMicros; }
+
+void delay(unsigned long ms) {
+  currentMillis += ms;
+  currentMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+  currentMicros += us;
+  currentMillis = currentMicros / 1000;
+}
+
+size_t Print::print(long value) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), "%ld", value);
+  return print(buffer);
+}
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb) {
+  rgb.r = scale8(hsv.h, hsv.v);
+  rgb.g = scale8(static_cast<uint8_t>(hsv.h * 3), hsv.v);
+  rgb.b = scale8(static_cast<uint8_t>(255 - hsv.h), hsv.s);
+}
+
+void fill_solid(CRGB *leds, int numLeds, const CRGB &color) {
+  for (int i = 0; i < numLeds; i++) {
+    leds[i] = color;
+  }
+}
+
+namespace MsTimer2 {
+void set(unsigned long, void (*callback)()) { msTimer2Callback = callback; }
+void start() { TIMSK2 |= _BV(TOIE2); }
+void stop() { TIMSK2 &= ~_BV(TOIE2); }
+void fire() {
+  if (msTimer2Callback) {
+    msTimer2Callback();
+  }
+}
+} // namespace MsTimer2
+
+namespace sim {
+
+void reset() {
+  PINB = PINC = PIND = 0;
+  DDRB = DDRC = DDRD = 0;
+  PORTB = PORTC = PORTD = 0;
+  SREG = 0;
+  SREG.interruptHandler = nullptr;
+  TCCR0A = TCCR0B = OCR0A = OCR0B = 0;
+  TCCR1A = TCCR1B = 0;
+  OCR1A = OCR1B = 0;
+  TCCR2A = TCCR2B = OCR2A = OCR2B = TIMSK2 = 0;
+  PCICR = PCIFR = PCMSK0 = PCMSK1 = PCMSK2 = 0;
+  UDR0.numWritten = 0;
+  UDR0.received = 0;
+  UCSR0A = UCSR0B = UCSR0C = 0;
+  UBRR0 = 0;
+  currentMillis = 0;
+  currentMicros = 0;
+  msTimer2Callback = nullptr;
+}
+
+void setMillis(unsigned long ms) {
+  currentMillis = ms;
+  currentMicros = ms * 1000;
+}
+
+void setMicros(unsigned long us) {
+  currentMicros = us;
+  currentMillis = currentMicros / 1000;
+}
+
+int pinOutput(uint8_t pin) {
+  TimerOutput output;
+  if (timerOutput(digitalPinToTimer(pin), output) &&
+      (*output.tccr & output.bit)) {
+    return output.value;
+  }
+  volatile uint8_t *out = portOutputRegister(digitalPinToPort(pin));
+  return (*out & digitalPinToBitMask(pin)) ? HIGH_LEVEL : LOW_LEVEL;
+}
+
+void setInput(uint8_t pin, bool high) {
+  volatile uint8_t *in = portInputRegister(digitalPinToPort(pin));
+  if (high) {
+    *in |= digitalPinToBitMask(pin);
+  } else {
+    *in &= ~digitalPinToBitMask(pin);
+  }
+}
+
+} // namespace sim
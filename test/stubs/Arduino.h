@@ -0,0 +1,157 @@
+/**
+ * @file Arduino.h
+ * @brief ホストでテストするための Arduino (ATmega328P) の模擬
+ *
+ * Arduino Uno と同じピン配置で、ピンの操作を `<avr/io.h>` の模擬レジスタに
+ * 反映します。`digitalWrite()` や `analogWrite()` は Arduino のコアと同じく、
+ * タイマーの出力（COMnx1ビット）の接続と切断も行います。
+ *
+ * 時刻は `sim::setMillis()` などで進めるまで変化しません。
+ */
+
+#pragma once
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define NOT_A_PIN 0
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+
+#define NOT_ON_TIMER 0
+#define TIMER0A 1
+#define TIMER0B 2
+#define TIMER1A 3
+#define TIMER1B 4
+#define TIMER2A 7
+#define TIMER2B 8
+
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define interrupts() sei()
+#define noInterrupts() cli()
+
+typedef uint8_t byte;
+
+// ピンとポートの対応（Arduino Uno: 0〜7はPORTD、8〜13はPORTB、14〜19はPORTC）
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+uint8_t digitalPinToTimer(uint8_t pin);
+volatile uint8_t *portOutputRegister(uint8_t port);
+volatile uint8_t *portInputRegister(uint8_t port);
+volatile uint8_t *portModeRegister(uint8_t port);
+uint8_t digitalPinToPCICRbit(uint8_t pin);
+volatile uint8_t *digitalPinToPCMSK(uint8_t pin);
+uint8_t digitalPinToPCMSKbit(uint8_t pin);
+#define NUM_DIGITAL_PINS 20
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/// フラッシュメモリ上の文字列を表す型（ホストでは通常の文字列）
+class __FlashStringHelper;
+#define F(string) (reinterpret_cast<const __FlashStringHelper *>(string))
+
+/**
+ * @brief Arduino の `Print` クラスの模擬
+ */
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      write(buffer[i]);
+    }
+    return size;
+  }
+  size_t write(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(const char *s) {
+    return write(reinterpret_cast<const uint8_t *>(s), strlen(s));
+  }
+  size_t print(const __FlashStringHelper *s) {
+    return print(reinterpret_cast<const char *>(s));
+  }
+  size_t print(long value);
+  size_t println() { return print("\r\n"); }
+  template <typename T> size_t println(T value) {
+    return print(value) + println();
+  }
+};
+
+/// Arduino の `HardwareSerial` の送信バッファのサイズ
+#define SERIAL_TX_BUFFER_SIZE 64
+
+/**
+ * @brief Arduino の `HardwareSerial` クラスの模擬
+ *
+ * 書き込んだデータは `output` に記録し、`input` に入れたデータを読み出します。
+ */
+class HardwareSerial : public Print {
+public:
+  static const uint16_t CAPACITY = 1024;
+  char output[CAPACITY];   ///< 書き込まれたデータ
+  uint16_t outputSize = 0; ///< 書き込まれたデータのバイト数
+  const char *input = "";  ///< 読み出すデータ（null終端）
+
+  using Print::write;
+  void begin(unsigned long) {}
+  int available() { return static_cast<int>(strlen(input)); }
+  int availableForWrite() { return SERIAL_TX_BUFFER_SIZE - 1; }
+  int read() { return *input ? static_cast<uint8_t>(*input++) : -1; }
+  size_t write(uint8_t c) override {
+    if (outputSize < CAPACITY) {
+      output[outputSize++] = static_cast<char>(c);
+    }
+    return 1;
+  }
+  void clear() { outputSize = 0; }
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * @brief テストから模擬したマイコンを操作するための関数
+ */
+namespace sim {
+/// 全てのレジスタを0にし、時刻を0に戻す
+void reset();
+/// `millis()` が返す時刻を設定する（`micros()` も合わせて設定される）
+void setMillis(unsigned long ms);
+/// `micros()` が返す時刻を設定する
+void setMicros(unsigned long us);
+/**
+ * @brief ピンの出力を調べる
+ *
+ * @return タイマーの出力が接続されている場合はOCRnxの値、
+ * 接続されていない場合はLOWなら `sim::LOW_LEVEL`、HIGHなら `sim::HIGH_LEVEL`
+ */
+int pinOutput(uint8_t pin);
+const int LOW_LEVEL = -1;
+const int HIGH_LEVEL = -2;
+/// 入力ピンの状態を設定する（PINxの該当ビットを書き換える）
+void setInput(uint8_t pin, bool high);
+} // namespace sim
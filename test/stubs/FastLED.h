@@ -0,0 +1,122 @@
+/**
+ * @file FastLED.h
+ * @brief ホストでテストするための FastLED ライブラリの模擬
+ *
+ * ライブラリが使用する型と関数だけを定義します。
+ * `CLEDController::show()` は出力したLED配列と明るさを記録します。
+ * `hsv2rgb_rainbow()` は FastLED と同じ値を返しません（決まった値を返すだけです）。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+typedef uint8_t fract8;
+
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+  return (static_cast<uint16_t>(i) * (1 + static_cast<uint16_t>(scale))) >> 8;
+}
+
+struct CHSV {
+  uint8_t h, s, v;
+  CHSV() : h(0), s(0), v(0) {}
+  CHSV(uint8_t h, uint8_t s, uint8_t v) : h(h), s(s), v(v) {}
+};
+
+struct CRGB {
+  union {
+    struct {
+      uint8_t r, g, b;
+    };
+    uint8_t raw[3];
+  };
+
+  enum HTMLColorCode : uint32_t {
+    Black = 0x000000,
+    Blue = 0x0000FF,
+    Green = 0x008000,
+    Red = 0xFF0000,
+    White = 0xFFFFFF
+  };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b) {}
+  CRGB(uint32_t color) : r(color >> 16), g(color >> 8), b(color) {}
+  CRGB(HTMLColorCode color) : CRGB(static_cast<uint32_t>(color)) {}
+  CRGB(const CHSV &hsv);
+
+  uint8_t &operator[](uint8_t i) { return raw[i]; }
+  const uint8_t &operator[](uint8_t i) const { return raw[i]; }
+
+  CRGB &nscale8(uint8_t scale) {
+    r = scale8(r, scale);
+    g = scale8(g, scale);
+    b = scale8(b, scale);
+    return *this;
+  }
+};
+
+inline bool operator==(const CRGB &lhs, const CRGB &rhs) {
+  return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b;
+}
+inline bool operator!=(const CRGB &lhs, const CRGB &rhs) {
+  return !(lhs == rhs);
+}
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+inline CRGB::CRGB(const CHSV &hsv) { hsv2rgb_rainbow(hsv, *this); }
+
+void fill_solid(CRGB *leds, int numLeds, const CRGB &color);
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+template <uint8_t DataPin, EOrder RgbOrder = GRB> class WS2812B {};
+
+/**
+ * @brief FastLED の LEDコントローラーの模擬
+ *
+ * `show()` で出力したLED配列を `shown` に、明るさを `shownBrightness` に記録します。
+ */
+class CLEDController {
+public:
+  static const uint16_t CAPACITY = 512;
+  CRGB shown[CAPACITY];        ///< 最後に出力したLED配列
+  int shownLeds = 0;           ///< 最後に出力したLEDの数
+  uint8_t shownBrightness = 0; ///< 最後に出力した明るさ
+  uint32_t showCount = 0;      ///< `show()` が呼び出された回数
+  /// `show()` のたびに呼び出す関数（出力したフレームを全て記録する場合に設定する）
+  void (*onShow)(const CLEDController &) = nullptr;
+
+  void show(const CRGB *data, int numLeds, uint8_t brightness) {
+    for (int i = 0; i < numLeds && i < CAPACITY; i++) {
+      shown[i] = data[i];
+    }
+    shownLeds = numLeds;
+    shownBrightness = brightness;
+    showCount++;
+    if (onShow) {
+      onShow(*this);
+    }
+  }
+};
+
+/**
+ * @brief FastLED の `FastLED` オブジェクトの模擬
+ */
+class CFastLED {
+public:
+  template <template <uint8_t, EOrder> class Chipset, uint8_t DataPin,
+            EOrder RgbOrder = RGB>
+  CLEDController &addLeds(CRGB *, int, int = 0) {
+    static CLEDController controller;
+    return controller;
+  }
+  void show() {}
+  void setBrightness(uint8_t brightness) { this->brightness = brightness; }
+  uint8_t getBrightness() const { return brightness; }
+
+private:
+  uint8_t brightness = 255;
+};
+
+extern CFastLED FastLED;
@@ -0,0 +1,17 @@
+/**
+ * @file MsTimer2.h
+ * @brief ホストでテストするための MsTimer2 ライブラリの模擬
+ *
+ * 本物のライブラリと同じく、`start()` で Timer2 のオーバーフロー割り込み（TOIE2）を
+ * 有効にし、`stop()` で無効にします。コールバックは `MsTimer2::fire()` で呼び出せます。
+ */
+
+#pragma once
+
+namespace MsTimer2 {
+void set(unsigned long ms, void (*callback)());
+void start();
+void stop();
+/// 設定されたコールバックを呼び出す（テスト用）
+void fire();
+} // namespace MsTimer2
@@ -0,0 +1,16 @@
+/**
+ * @file interrupt.h
+ * @brief ホストでテストするための `<avr/interrupt.h>` の模擬
+ *
+ * `cli()` と `sei()` は SREG の割り込み許可ビットだけを書き換えます。
+ * 割り込みハンドラは通常の関数として定義されるため、テストから直接呼び出せます。
+ */
+
+#pragma once
+
+#include <avr/io.h>
+
+#define ISR(vector) extern "C" void vector()
+
+inline void cli() { SREG &= static_cast<uint8_t>(~_BV(SREG_I)); }
+inline void sei() { SREG |= _BV(SREG_I); }
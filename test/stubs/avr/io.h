@@ -0,0 +1,124 @@
+/**
+ * @file io.h
+ * @brief ホストでテストするための ATmega328P のレジスタの模擬
+ *
+ * 本物の `<avr/io.h>` と同じ名前のレジスタを変数として定義します。
+ * ライブラリのコードはレジスタを書き換えるだけなので、テストでは
+ * 書き換えた後のレジスタの値を調べることで、出力を確認できます。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+// I/Oポート
+extern volatile uint8_t PINB, PINC, PIND;
+extern volatile uint8_t DDRB, DDRC, DDRD;
+extern volatile uint8_t PORTB, PORTC, PORTD;
+
+#define SREG_I 7
+
+/**
+ * @brief ステータスレジスタ（SREG）の模擬
+ *
+ * 割り込みが許可されている（Iビットが1の）時に読み出すと、
+ * `interruptHandler` を呼び出します。割り込みを待つループの中で
+ * SREGを読み出すコードは、待っている間に割り込みが発生したように動作します。
+ */
+struct FakeSreg {
+  uint8_t value = 0;
+  void (*interruptHandler)() = nullptr; ///< 割り込みの代わりに呼び出す関数
+  bool inInterrupt = false;             ///< 割り込みの処理中かどうか
+
+  operator uint8_t() {
+    if ((value & _BV(SREG_I)) && interruptHandler && !inInterrupt) {
+      inInterrupt = true;
+      interruptHandler();
+      inInterrupt = false;
+    }
+    return value;
+  }
+  FakeSreg &operator=(uint8_t newValue) {
+    value = newValue;
+    return *this;
+  }
+  FakeSreg &operator|=(uint8_t bits) {
+    value |= bits;
+    return *this;
+  }
+  FakeSreg &operator&=(uint8_t bits) {
+    value &= bits;
+    return *this;
+  }
+};
+
+// ステータスレジスタ
+extern FakeSreg SREG;
+
+// タイマー0〜2
+extern volatile uint8_t TCCR0A, TCCR0B, OCR0A, OCR0B;
+extern volatile uint8_t TCCR1A, TCCR1B;
+extern volatile uint16_t OCR1A, OCR1B;
+extern volatile uint8_t TCCR2A, TCCR2B, OCR2A, OCR2B, TIMSK2;
+// avr-libc と同じく、レジスタの有無を #if defined() で調べられるようにする
+#define TCCR0A TCCR0A
+#define TCCR1A TCCR1A
+#define TCCR1B TCCR1B
+#define TCCR2A TCCR2A
+#define TCCR2B TCCR2B
+#define TIMSK2 TIMSK2
+#define COM0A1 7
+#define COM0B1 5
+#define COM1A1 7
+#define COM1B1 5
+#define COM2A1 7
+#define COM2B1 5
+#define TOIE2 0
+#define OCIE2A 1
+#define OCIE2B 2
+
+// ピン変化割り込み
+extern volatile uint8_t PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2;
+#define PCICR PCICR
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+
+/**
+ * @brief USARTのデータレジスタ（UDR0）の模擬
+ *
+ * 書き込んだバイトを `written` に記録し、読み出すと `received` の値を返します。
+ */
+struct FakeUdr {
+  static const uint16_t CAPACITY = 1024;
+  uint8_t written[CAPACITY]; ///< 書き込まれたバイト
+  uint16_t numWritten = 0;   ///< 書き込まれたバイト数
+  uint8_t received = 0;      ///< 読み出した時に返す値
+
+  FakeUdr &operator=(uint8_t value) {
+    if (numWritten < CAPACITY) {
+      written[numWritten++] = value;
+    }
+    return *this;
+  }
+  operator uint8_t() const { return received; }
+};
+
+// USART0
+extern FakeUdr UDR0;
+extern volatile uint8_t UCSR0A, UCSR0B, UCSR0C;
+extern volatile uint16_t UBRR0;
+#define RXC0 7
+#define UDRE0 5
+#define RXCIE0 7
+#define UDRIE0 5
+#define RXEN0 4
+#define TXEN0 3
+#define UCSZ01 2
+#define UCSZ00 1
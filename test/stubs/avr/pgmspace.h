@@ -0,0 +1,18 @@
+/**
+ * @file pgmspace.h
+ * @brief ホストでテストするための `<avr/pgmspace.h>` の模擬
+ *
+ * ホストにはフラッシュメモリの区別がないため、通常のメモリとして読み出します。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t *>(address))
+#define strlen_P strlen
+#define memcpy_P memcpy
@@ -0,0 +1,28 @@
+/**
+ * @file digitalWriteFast.h
+ * @brief ホストでテストするための digitalWriteFast ライブラリの模擬
+ *
+ * 本物のライブラリと同じく、ポートのレジスタを直接書き換えます。
+ * `digitalWrite()` と異なり、タイマーの出力は切断しません。
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+inline void pinModeFast(uint8_t pin, uint8_t mode) { pinMode(pin, mode); }
+
+inline void digitalWriteFast(uint8_t pin, uint8_t value) {
+  volatile uint8_t *reg = portOutputRegister(digitalPinToPort(pin));
+  if (value) {
+    *reg |= digitalPinToBitMask(pin);
+  } else {
+    *reg &= ~digitalPinToBitMask(pin);
+  }
+}
+
+inline int digitalReadFast(uint8_t pin) {
+  return (*portInputRegister(digitalPinToPort(pin)) & digitalPinToBitMask(pin))
+             ? HIGH
+             : LOW;
+}